@@ -31,6 +31,7 @@
 
 #include <Awl/boost/bind.hpp>
 #include <Awl/boost/function.hpp>
+#include <Awl/Future.hpp>
 #include <Awl/Task.hpp>
 #include <Awl/ThreadPool.hpp>
 
@@ -58,6 +59,27 @@
  */
 #define AwlAsyncMethod(method, object) awl::AsyncCall(boost::bind(method, object, _1))
 
+/** @brief Call the given @a function in an asynchronous way on the given ThreadPool
+ *
+ * @param pool The ThreadPool that should execute the function
+ * @param function The function or static method to call
+ * with the following signature: void function(awl::Task *self)
+ * @return The Task object associated to that call
+ * @see AwlAsyncCall
+ */
+#define AwlAsyncCallOn(pool, function) awl::AsyncCall(pool, boost::bind(function, _1))
+
+/** @brief Call the given @a method in an asynchronous way on the given ThreadPool
+ *
+ * @param pool The ThreadPool that should execute the method
+ * @param method The (non-static) method to call
+ * with the following signature: void class::method(awl::Task *self)
+ * @param object The object targetted by the @a method
+ * @return The Task object associated to that call
+ * @see AwlAsyncMethod
+ */
+#define AwlAsyncMethodOn(pool, method, object) awl::AsyncCall(pool, boost::bind(method, object, _1))
+
 /** @brief Start a block that is to be executed in an asynchronous way.
  *
  * @details You're given access to the parent Task object through the @a self pointer
@@ -75,6 +97,15 @@
 { struct __awl_local_struct { static void __awl_async_block(awl::Task *self) { functionBlock \
 } }; AwlAsyncCall(__awl_local_struct::__awl_async_block); } 
 
+/** @brief Start a block that is to be executed in an asynchronous way
+ * on the given ThreadPool.
+ *
+ * @see AwlAsyncBlock
+ */
+#define AwlAsyncBlockOn(pool, functionBlock) \
+{ struct __awl_local_struct { static void __awl_async_block(awl::Task *self) { functionBlock \
+} }; AwlAsyncCallOn(pool, __awl_local_struct::__awl_async_block); } 
+
 /** @brief Start a block that is to be executed in an asynchronous way, and gives
  * back a Task object to externally control the Task.
  *
@@ -126,16 +157,13 @@
 { \
 struct __awl_local_struct \
 { \
-static void __awl_async_block(awl::Task *self) \
+static void __awl_async_block(awl::Task *self, type1 *__awl_p1) \
 { \
-type1 var1 = *(type1 *)self->input[#var1];\
+type1 var1 = *__awl_p1;\
 functionBlock \
 } \
 }; \
-awl::Callback __awl_f(boost::bind(__awl_local_struct::__awl_async_block, _1)); \
-awl::TaskRef __awl_t(new awl::Task(__awl_f)); \
-__awl_t->input[#var1] = (void *)&var1;\
-awl::ThreadPool::Default().ScheduleTaskForExecution(__awl_t); \
+awl::AsyncCall(__awl_local_struct::__awl_async_block, &var1); \
 }
 
 /** @brief Start a block that is to be executed in an asynchronous way
@@ -147,18 +175,14 @@ awl::ThreadPool::Default().ScheduleTaskForExecution(__awl_t); \
 { \
 struct __awl_local_struct \
 { \
-static void __awl_async_block(awl::Task *self) \
+static void __awl_async_block(awl::Task *self, type1 *__awl_p1, type2 *__awl_p2) \
 { \
-type1 & var1 = *(type1 *)self->input[#var1];\
-type2 & var2 = *(type2 *)self->input[#var2];\
+type1 & var1 = *__awl_p1;\
+type2 & var2 = *__awl_p2;\
 functionBlock \
 } \
 }; \
-awl::Callback __awl_f(boost::bind(__awl_local_struct::__awl_async_block, _1)); \
-awl::TaskRef __awl_t(new awl::Task(__awl_f)); \
-__awl_t->input[#var1] = (void *)&var1;\
-__awl_t->input[#var2] = (void *)&var2;\
-awl::ThreadPool::Default().ScheduleTaskForExecution(__awl_t); \
+awl::AsyncCall(__awl_local_struct::__awl_async_block, &var1, &var2); \
 }
 
 /** @brief Start a block that is to be executed in an asynchronous way
@@ -170,20 +194,15 @@ awl::ThreadPool::Default().ScheduleTaskForExecution(__awl_t); \
 { \
 struct __awl_local_struct \
 { \
-static void __awl_async_block(awl::Task *self) \
+static void __awl_async_block(awl::Task *self, type1 *__awl_p1, type2 *__awl_p2, type3 *__awl_p3) \
 { \
-type1 & var1 = *(type1 *)self->input[#var1];\
-type2 & var2 = *(type2 *)self->input[#var2];\
-type3 & var3 = *(type3 *)self->input[#var3];\
+type1 & var1 = *__awl_p1;\
+type2 & var2 = *__awl_p2;\
+type3 & var3 = *__awl_p3;\
 functionBlock \
 } \
 }; \
-awl::Callback __awl_f(boost::bind(__awl_local_struct::__awl_async_block, _1)); \
-awl::TaskRef __awl_t(new awl::Task(__awl_f)); \
-__awl_t->input[#var1] = (void *)&var1;\
-__awl_t->input[#var2] = (void *)&var2;\
-__awl_t->input[#var3] = (void *)&var3;\
-awl::ThreadPool::Default().ScheduleTaskForExecution(__awl_t); \
+awl::AsyncCall(__awl_local_struct::__awl_async_block, &var1, &var2, &var3); \
 }
 
 /** @brief Start a block that is to be executed in an asynchronous way
@@ -195,22 +214,16 @@ awl::ThreadPool::Default().ScheduleTaskForExecution(__awl_t); \
 { \
 struct __awl_local_struct \
 { \
-static void __awl_async_block(awl::Task *self) \
+static void __awl_async_block(awl::Task *self, type1 *__awl_p1, type2 *__awl_p2, type3 *__awl_p3, type4 *__awl_p4) \
 { \
-type1 & var1 = *(type1 *)self->input[#var1];\
-type2 & var2 = *(type2 *)self->input[#var2];\
-type3 & var3 = *(type3 *)self->input[#var3];\
-type4 & var4 = *(type4 *)self->input[#var4];\
+type1 & var1 = *__awl_p1;\
+type2 & var2 = *__awl_p2;\
+type3 & var3 = *__awl_p3;\
+type4 & var4 = *__awl_p4;\
 functionBlock \
 } \
 }; \
-awl::Callback __awl_f(boost::bind(__awl_local_struct::__awl_async_block, _1)); \
-awl::TaskRef __awl_t(new awl::Task(__awl_f)); \
-__awl_t->input[#var1] = (void *)&var1;\
-__awl_t->input[#var2] = (void *)&var2;\
-__awl_t->input[#var3] = (void *)&var3;\
-__awl_t->input[#var4] = (void *)&var4;\
-awl::ThreadPool::Default().ScheduleTaskForExecution(__awl_t); \
+awl::AsyncCall(__awl_local_struct::__awl_async_block, &var1, &var2, &var3, &var4); \
 }
 
 /** @brief Start a block that is to be executed in an asynchronous way
@@ -222,24 +235,17 @@ awl::ThreadPool::Default().ScheduleTaskForExecution(__awl_t); \
 { \
 struct __awl_local_struct \
 { \
-static void __awl_async_block(awl::Task *self) \
+static void __awl_async_block(awl::Task *self, type1 *__awl_p1, type2 *__awl_p2, type3 *__awl_p3, type4 *__awl_p4, type5 *__awl_p5) \
 { \
-type1 & var1 = *(type1 *)self->input[#var1];\
-type2 & var2 = *(type2 *)self->input[#var2];\
-type3 & var3 = *(type3 *)self->input[#var3];\
-type4 & var4 = *(type4 *)self->input[#var4];\
-type5 & var5 = *(type5 *)self->input[#var5];\
+type1 & var1 = *__awl_p1;\
+type2 & var2 = *__awl_p2;\
+type3 & var3 = *__awl_p3;\
+type4 & var4 = *__awl_p4;\
+type5 & var5 = *__awl_p5;\
 functionBlock \
 } \
 }; \
-awl::Callback __awl_f(boost::bind(__awl_local_struct::__awl_async_block, _1)); \
-awl::TaskRef __awl_t(new awl::Task(__awl_f)); \
-__awl_t->input[#var1] = (void *)&var1;\
-__awl_t->input[#var2] = (void *)&var2;\
-__awl_t->input[#var3] = (void *)&var3;\
-__awl_t->input[#var4] = (void *)&var4;\
-__awl_t->input[#var5] = (void *)&var5;\
-awl::ThreadPool::Default().ScheduleTaskForExecution(__awl_t); \
+awl::AsyncCall(__awl_local_struct::__awl_async_block, &var1, &var2, &var3, &var4, &var5); \
 }
 
 /** @brief Start a block that is to be executed in an asynchronous way
@@ -251,26 +257,18 @@ awl::ThreadPool::Default().ScheduleTaskForExecution(__awl_t); \
 { \
 struct __awl_local_struct \
 { \
-static void __awl_async_block(awl::Task *self) \
+static void __awl_async_block(awl::Task *self, type1 *__awl_p1, type2 *__awl_p2, type3 *__awl_p3, type4 *__awl_p4, type5 *__awl_p5, type6 *__awl_p6) \
 { \
-type1 & var1 = *(type1 *)self->input[#var1];\
-type2 & var2 = *(type2 *)self->input[#var2];\
-type3 & var3 = *(type3 *)self->input[#var3];\
-type4 & var4 = *(type4 *)self->input[#var4];\
-type5 & var5 = *(type5 *)self->input[#var5];\
-type6 & var6 = *(type6 *)self->input[#var6];\
+type1 & var1 = *__awl_p1;\
+type2 & var2 = *__awl_p2;\
+type3 & var3 = *__awl_p3;\
+type4 & var4 = *__awl_p4;\
+type5 & var5 = *__awl_p5;\
+type6 & var6 = *__awl_p6;\
 functionBlock \
 } \
 }; \
-awl::Callback __awl_f(boost::bind(__awl_local_struct::__awl_async_block, _1)); \
-awl::TaskRef __awl_t(new awl::Task(__awl_f)); \
-__awl_t->input[#var1] = (void *)&var1;\
-__awl_t->input[#var2] = (void *)&var2;\
-__awl_t->input[#var3] = (void *)&var3;\
-__awl_t->input[#var4] = (void *)&var4;\
-__awl_t->input[#var5] = (void *)&var5;\
-__awl_t->input[#var6] = (void *)&var6;\
-awl::ThreadPool::Default().ScheduleTaskForExecution(__awl_t); \
+awl::AsyncCall(__awl_local_struct::__awl_async_block, &var1, &var2, &var3, &var4, &var5, &var6); \
 }
 
 /** @brief Start a block that is to be executed in an asynchronous way
@@ -282,28 +280,19 @@ awl::ThreadPool::Default().ScheduleTaskForExecution(__awl_t); \
 { \
 struct __awl_local_struct \
 { \
-static void __awl_async_block(awl::Task *self) \
+static void __awl_async_block(awl::Task *self, type1 *__awl_p1, type2 *__awl_p2, type3 *__awl_p3, type4 *__awl_p4, type5 *__awl_p5, type6 *__awl_p6, type7 *__awl_p7) \
 { \
-type1 & var1 = *(type1 *)self->input[#var1];\
-type2 & var2 = *(type2 *)self->input[#var2];\
-type3 & var3 = *(type3 *)self->input[#var3];\
-type4 & var4 = *(type4 *)self->input[#var4];\
-type5 & var5 = *(type5 *)self->input[#var5];\
-type6 & var6 = *(type6 *)self->input[#var6];\
-type7 & var7 = *(type7 *)self->input[#var7];\
+type1 & var1 = *__awl_p1;\
+type2 & var2 = *__awl_p2;\
+type3 & var3 = *__awl_p3;\
+type4 & var4 = *__awl_p4;\
+type5 & var5 = *__awl_p5;\
+type6 & var6 = *__awl_p6;\
+type7 & var7 = *__awl_p7;\
 functionBlock \
 } \
 }; \
-awl::Callback __awl_f(boost::bind(__awl_local_struct::__awl_async_block, _1)); \
-awl::TaskRef __awl_t(new awl::Task(__awl_f)); \
-__awl_t->input[#var1] = (void *)&var1;\
-__awl_t->input[#var2] = (void *)&var2;\
-__awl_t->input[#var3] = (void *)&var3;\
-__awl_t->input[#var4] = (void *)&var4;\
-__awl_t->input[#var5] = (void *)&var5;\
-__awl_t->input[#var6] = (void *)&var6;\
-__awl_t->input[#var7] = (void *)&var7;\
-awl::ThreadPool::Default().ScheduleTaskForExecution(__awl_t); \
+awl::AsyncCall(__awl_local_struct::__awl_async_block, &var1, &var2, &var3, &var4, &var5, &var6, &var7); \
 }
 
 /** @brief Start a block that is to be executed in an asynchronous way
@@ -315,30 +304,20 @@ awl::ThreadPool::Default().ScheduleTaskForExecution(__awl_t); \
 { \
 struct __awl_local_struct \
 { \
-static void __awl_async_block(awl::Task *self) \
+static void __awl_async_block(awl::Task *self, type1 *__awl_p1, type2 *__awl_p2, type3 *__awl_p3, type4 *__awl_p4, type5 *__awl_p5, type6 *__awl_p6, type7 *__awl_p7, type8 *__awl_p8) \
 { \
-type1 & var1 = *(type1 *)self->input[#var1];\
-type2 & var2 = *(type2 *)self->input[#var2];\
-type3 & var3 = *(type3 *)self->input[#var3];\
-type4 & var4 = *(type4 *)self->input[#var4];\
-type5 & var5 = *(type5 *)self->input[#var5];\
-type6 & var6 = *(type6 *)self->input[#var6];\
-type7 & var7 = *(type7 *)self->input[#var7];\
-type8 & var8 = *(type8 *)self->input[#var8];\
+type1 & var1 = *__awl_p1;\
+type2 & var2 = *__awl_p2;\
+type3 & var3 = *__awl_p3;\
+type4 & var4 = *__awl_p4;\
+type5 & var5 = *__awl_p5;\
+type6 & var6 = *__awl_p6;\
+type7 & var7 = *__awl_p7;\
+type8 & var8 = *__awl_p8;\
 functionBlock \
 } \
 }; \
-awl::Callback __awl_f(boost::bind(__awl_local_struct::__awl_async_block, _1)); \
-awl::TaskRef __awl_t(new awl::Task(__awl_f)); \
-__awl_t->input[#var1] = (void *)&var1;\
-__awl_t->input[#var2] = (void *)&var2;\
-__awl_t->input[#var3] = (void *)&var3;\
-__awl_t->input[#var4] = (void *)&var4;\
-__awl_t->input[#var5] = (void *)&var5;\
-__awl_t->input[#var6] = (void *)&var6;\
-__awl_t->input[#var7] = (void *)&var7;\
-__awl_t->input[#var8] = (void *)&var8;\
-awl::ThreadPool::Default().ScheduleTaskForExecution(__awl_t); \
+awl::AsyncCall(__awl_local_struct::__awl_async_block, &var1, &var2, &var3, &var4, &var5, &var6, &var7, &var8); \
 }
 
 /** @brief Start a block that is to be executed in an asynchronous way
@@ -350,32 +329,21 @@ awl::ThreadPool::Default().ScheduleTaskForExecution(__awl_t); \
 { \
 struct __awl_local_struct \
 { \
-static void __awl_async_block(awl::Task *self) \
+static void __awl_async_block(awl::Task *self, type1 *__awl_p1, type2 *__awl_p2, type3 *__awl_p3, type4 *__awl_p4, type5 *__awl_p5, type6 *__awl_p6, type7 *__awl_p7, type8 *__awl_p8, type9 *__awl_p9) \
 { \
-type1 & var1 = *(type1 *)self->input[#var1];\
-type2 & var2 = *(type2 *)self->input[#var2];\
-type3 & var3 = *(type3 *)self->input[#var3];\
-type4 & var4 = *(type4 *)self->input[#var4];\
-type5 & var5 = *(type5 *)self->input[#var5];\
-type6 & var6 = *(type6 *)self->input[#var6];\
-type7 & var7 = *(type7 *)self->input[#var7];\
-type8 & var8 = *(type8 *)self->input[#var8];\
-type9 & var9 = *(type9 *)self->input[#var9];\
+type1 & var1 = *__awl_p1;\
+type2 & var2 = *__awl_p2;\
+type3 & var3 = *__awl_p3;\
+type4 & var4 = *__awl_p4;\
+type5 & var5 = *__awl_p5;\
+type6 & var6 = *__awl_p6;\
+type7 & var7 = *__awl_p7;\
+type8 & var8 = *__awl_p8;\
+type9 & var9 = *__awl_p9;\
 functionBlock \
 } \
 }; \
-awl::Callback __awl_f(boost::bind(__awl_local_struct::__awl_async_block, _1)); \
-awl::TaskRef __awl_t(new awl::Task(__awl_f)); \
-__awl_t->input[#var1] = (void *)&var1;\
-__awl_t->input[#var2] = (void *)&var2;\
-__awl_t->input[#var3] = (void *)&var3;\
-__awl_t->input[#var4] = (void *)&var4;\
-__awl_t->input[#var5] = (void *)&var5;\
-__awl_t->input[#var6] = (void *)&var6;\
-__awl_t->input[#var7] = (void *)&var7;\
-__awl_t->input[#var8] = (void *)&var8;\
-__awl_t->input[#var9] = (void *)&var9;\
-awl::ThreadPool::Default().ScheduleTaskForExecution(__awl_t); \
+awl::AsyncCall(__awl_local_struct::__awl_async_block, &var1, &var2, &var3, &var4, &var5, &var6, &var7, &var8, &var9); \
 }
 
 /** @brief Start a block that is to be executed in an asynchronous way
@@ -387,34 +355,22 @@ awl::ThreadPool::Default().ScheduleTaskForExecution(__awl_t); \
 { \
 struct __awl_local_struct \
 { \
-static void __awl_async_block(awl::Task *self) \
+static void __awl_async_block(awl::Task *self, type1 *__awl_p1, type2 *__awl_p2, type3 *__awl_p3, type4 *__awl_p4, type5 *__awl_p5, type6 *__awl_p6, type7 *__awl_p7, type8 *__awl_p8, type9 *__awl_p9, type10 *__awl_p10) \
 { \
-type1 & var1 = *(type1 *)self->input[#var1];\
-type2 & var2 = *(type2 *)self->input[#var2];\
-type3 & var3 = *(type3 *)self->input[#var3];\
-type4 & var4 = *(type4 *)self->input[#var4];\
-type5 & var5 = *(type5 *)self->input[#var5];\
-type6 & var6 = *(type6 *)self->input[#var6];\
-type7 & var7 = *(type7 *)self->input[#var7];\
-type8 & var8 = *(type8 *)self->input[#var8];\
-type9 & var9 = *(type9 *)self->input[#var9];\
-type10 & var10 = *(type10 *)self->input[#var10];\
+type1 & var1 = *__awl_p1;\
+type2 & var2 = *__awl_p2;\
+type3 & var3 = *__awl_p3;\
+type4 & var4 = *__awl_p4;\
+type5 & var5 = *__awl_p5;\
+type6 & var6 = *__awl_p6;\
+type7 & var7 = *__awl_p7;\
+type8 & var8 = *__awl_p8;\
+type9 & var9 = *__awl_p9;\
+type10 & var10 = *__awl_p10;\
 functionBlock \
 } \
 }; \
-awl::Callback __awl_f(boost::bind(__awl_local_struct::__awl_async_block, _1)); \
-awl::TaskRef __awl_t(new awl::Task(__awl_f)); \
-__awl_t->input[#var1] = (void *)&var1;\
-__awl_t->input[#var2] = (void *)&var2;\
-__awl_t->input[#var3] = (void *)&var3;\
-__awl_t->input[#var4] = (void *)&var4;\
-__awl_t->input[#var5] = (void *)&var5;\
-__awl_t->input[#var6] = (void *)&var6;\
-__awl_t->input[#var7] = (void *)&var7;\
-__awl_t->input[#var8] = (void *)&var8;\
-__awl_t->input[#var9] = (void *)&var9;\
-__awl_t->input[#var10] = (void *)&var10;\
-awl::ThreadPool::Default().ScheduleTaskForExecution(__awl_t); \
+awl::AsyncCall(__awl_local_struct::__awl_async_block, &var1, &var2, &var3, &var4, &var5, &var6, &var7, &var8, &var9, &var10); \
 }
 
 
@@ -429,6 +385,168 @@ namespace awl {
 	 */
 	TaskRef Awl_Api AsyncCall(Callback f);
 	
+	/** @brief Call the given callback in an asynchronous way on the given
+	 * ThreadPool and get a handle on this task
+	 *
+	 * @param pool the ThreadPool that should execute the task
+	 * @param f the function or method that represents the task
+	 * with the following signature: void function(awl::Task *self)
+	 * @return The associated Task object
+	 */
+	TaskRef Awl_Api AsyncCall(ThreadPool& pool, Callback f);
+	
+	/** @brief Call the given callback in an asynchronous way with the given
+	 * priority and get a handle on this task
+	 *
+	 * High priority tasks are executed before any normal priority task
+	 * that is still pending, and low priority tasks only run when no other
+	 * task is waiting. Tasks that wait for too long get promoted, see
+	 * PoolSettings::priorityAging.
+	 *
+	 * @param pool the ThreadPool that should execute the task
+	 * @param f the function or method that represents the task
+	 * with the following signature: void function(awl::Task *self)
+	 * @param priority the priority band of the task
+	 * @return The associated Task object
+	 */
+	TaskRef Awl_Api AsyncCall(ThreadPool& pool, Callback f, Priority priority);
+	
+	/** @brief Call the given callback in an asynchronous way with the given
+	 * deadline and get a handle on this task
+	 *
+	 * @details The deadline only changes the execution order on pools using
+	 * DeadlineScheduling, see Task::SetDeadline().
+	 *
+	 * @param pool the ThreadPool that should execute the task
+	 * @param f the function or method that represents the task
+	 * with the following signature: void function(awl::Task *self)
+	 * @param deadline the time before which the task should be completed,
+	 * in milliseconds as returned by GetMonotonicTime()
+	 * @return The associated Task object
+	 */
+	TaskRef Awl_Api AsyncCallBefore(ThreadPool& pool, Callback f, Uint64 deadline);
+	
+	/** @brief Call the given callback in an asynchronous way on the given
+	 * NUMA node and get a handle on this task
+	 *
+	 * @details The Task is allocated from the memory of @a node, and
+	 * NUMA-aware pools execute it on that node, see Task::SetNode().
+	 *
+	 * @param pool the ThreadPool that should execute the task
+	 * @param f the function or method that represents the task
+	 * with the following signature: void function(awl::Task *self)
+	 * @param node the NUMA node that owns the data of the task
+	 * @return The associated Task object
+	 */
+	TaskRef Awl_Api AsyncCallOnNode(ThreadPool& pool, Callback f, int node);
+	
+	/** @brief Call all the given callbacks in an asynchronous way and get
+	 * a handle on each task
+	 *
+	 * @details The tasks are scheduled at once, which is much cheaper than
+	 * calling AsyncCall() for each of them, see ThreadPool::ScheduleTasks().
+	 *
+	 * @param pool the ThreadPool that should execute the tasks
+	 * @param functions the functions or methods that represent the tasks
+	 * with the following signature: void function(awl::Task *self), they are
+	 * moved into the tasks
+	 * @return The associated Task objects, in the same order as @a functions
+	 */
+	std::vector<TaskRef> Awl_Api AsyncCall(ThreadPool& pool, std::vector<Callback> functions);
+	
+	/** @brief Call the given function in an asynchronous way on the given
+	 * ThreadPool and get a Future on its result
+	 *
+	 * @details This overload is only used for functions that take no
+	 * argument, such as lambdas or boost::bind() results without
+	 * placeholder. Task callbacks go to AsyncCall(ThreadPool&, Callback).
+	 *
+	 * @code
+	 * awl::Future<int> answer = awl::AsyncCall(pool, []{ return 42; });
+	 * answer.Then([](int value){ std::cout << value << std::endl; });
+	 * @endcode
+	 *
+	 * @param pool the ThreadPool that should execute the function
+	 * @param f the function that computes the result, with the following
+	 * signature: T function(void)
+	 * @return The Future of the value returned by @a f
+	 */
+	template <typename F>
+	typename std::enable_if<!priv::IsTaskCallback<F>::value,
+	Future<typename std::decay<decltype(std::declval<F&>()())>::type> >::type
+	AsyncCall(ThreadPool& pool, F f);
+	
+	/** @brief Same as AsyncCall(ThreadPool&, F) on the default ThreadPool
+	 */
+	template <typename F>
+	typename std::enable_if<!priv::IsTaskCallback<F>::value,
+	Future<typename std::decay<decltype(std::declval<F&>()())>::type> >::type
+	AsyncCall(F f);
+	
+	/** @brief Call the given Task callback in an asynchronous way on the
+	 * given ThreadPool, with copies of the given arguments
+	 *
+	 * @details The arguments are copied, or moved when given as rvalues,
+	 * into the callback stored by the Task. When it runs, @a f gets them
+	 * after the Task pointer. Nothing is looked up at run time, and a few
+	 * small arguments do not need any allocation, see Function.
+	 *
+	 * @code
+	 * void Resize(awl::Task *self, std::unique_ptr<Image>& image, int width);
+	 *
+	 * awl::AsyncCall(pool, Resize, std::move(image), 640);
+	 * @endcode
+	 *
+	 * @param pool the ThreadPool that should execute the task
+	 * @param f the function that represents the task, with the following
+	 * signature: void function(awl::Task *self, A1& argument1, A&... arguments)
+	 * @return The associated Task object
+	 */
+	template <typename F, typename A1, typename... A>
+	typename std::enable_if<priv::IsBoundTaskCallback<F, A1, A...>::value, TaskRef>::type
+	AsyncCall(ThreadPool& pool, F f, A1&& argument1, A&&... arguments);
+	
+	/** @brief Same as AsyncCall(ThreadPool&, F, A1&&, A&&...) on the
+	 * default ThreadPool
+	 */
+	template <typename F, typename A1, typename... A>
+	typename std::enable_if<priv::IsBoundTaskCallback<F, A1, A...>::value, TaskRef>::type
+	AsyncCall(F f, A1&& argument1, A&&... arguments);
+	
+	/** @brief Call the given function in an asynchronous way on the given
+	 * ThreadPool, with copies of the given arguments, and get a Future on
+	 * its result
+	 *
+	 * @details The arguments are stored as with
+	 * AsyncCall(ThreadPool&, F, A1&&, A&&...), but @a f does not get the
+	 * Task pointer.
+	 *
+	 * @code
+	 * awl::Future<size_t> count = awl::AsyncCall(pool, CountWords, std::move(text));
+	 * @endcode
+	 *
+	 * @param pool the ThreadPool that should execute the function
+	 * @param f the function that computes the result, with the following
+	 * signature: T function(A1& argument1, A&... arguments)
+	 * @return The Future of the value returned by @a f
+	 */
+	template <typename F, typename A1, typename... A>
+	typename std::enable_if<!priv::IsCallableAs<F, void, Task*, typename std::decay<A1>::type&, typename std::decay<A>::type&...>::value,
+	Future<typename std::decay<decltype(std::declval<F&>()(std::declval<typename std::decay<A1>::type&>(),
+														   std::declval<typename std::decay<A>::type&>()...))>::type> >::type
+	AsyncCall(ThreadPool& pool, F f, A1&& argument1, A&&... arguments);
+	
+	/** @brief Same as AsyncCall(ThreadPool&, F, A1&&, A&&...) on the
+	 * default ThreadPool, for functions returning a value
+	 */
+	template <typename F, typename A1, typename... A>
+	typename std::enable_if<!priv::IsCallableAs<F, void, Task*, typename std::decay<A1>::type&, typename std::decay<A>::type&...>::value,
+	Future<typename std::decay<decltype(std::declval<F&>()(std::declval<typename std::decay<A1>::type&>(),
+														   std::declval<typename std::decay<A>::type&>()...))>::type> >::type
+	AsyncCall(F f, A1&& argument1, A&&... arguments);
+	
+#include <Awl/Async.inl>
+	
 } // namespace awl
 
 #endif
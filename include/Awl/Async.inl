@@ -0,0 +1,87 @@
+
+/*
+ *  Async.inl
+ *  Awl - Asynchronous Work Library
+ *
+ *  Copyright (c) 2011 Lucas Soltic
+ *  ceylow@gmail.com
+ *
+ *  This software is provided 'as-is', without any express or implied warranty.
+ *  In no event will the authors be held liable for any damages arising from
+ *  the use of this software.
+ *
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute it freely,
+ *  subject to the following restrictions:
+ *
+ *  1. The origin of this software must not be misrepresented;
+ *     you must not claim that you wrote the original software.
+ *     If you use this software in a product, an acknowledgment
+ *     in the product documentation would be appreciated but is not required.
+ *
+ *  2. Altered source versions must be plainly marked as such,
+ *     and must not be misrepresented as being the original software.
+ *
+ *  3. This notice may not be removed or altered from any source distribution.
+ *
+ */
+template <typename F>
+typename std::enable_if<!priv::IsTaskCallback<F>::value,
+Future<typename std::decay<decltype(std::declval<F&>()())>::type> >::type
+AsyncCall(ThreadPool& pool, F f)
+{
+	typedef typename std::decay<decltype(std::declval<F&>()())>::type T;
+	
+	boost::intrusive_ptr<priv::ValueTask<T> > t(new priv::FunctionTask<T, F>(std::move(f)));
+	pool.ScheduleTaskForExecution(t);
+	return Future<T>(t);
+}
+
+template <typename F>
+typename std::enable_if<!priv::IsTaskCallback<F>::value,
+Future<typename std::decay<decltype(std::declval<F&>()())>::type> >::type
+AsyncCall(F f)
+{
+	return AsyncCall(ThreadPool::Default(), std::move(f));
+}
+
+template <typename F, typename A1, typename... A>
+typename std::enable_if<priv::IsBoundTaskCallback<F, A1, A...>::value, TaskRef>::type
+AsyncCall(ThreadPool& pool, F f, A1&& argument1, A&&... arguments)
+{
+	typedef priv::Binder<void (Task*), F, typename std::decay<A1>::type, typename std::decay<A>::type...> Bound;
+	
+	return AsyncCall(pool, Callback(Bound(std::move(f), std::forward<A1>(argument1), std::forward<A>(arguments)...)));
+}
+
+template <typename F, typename A1, typename... A>
+typename std::enable_if<priv::IsBoundTaskCallback<F, A1, A...>::value, TaskRef>::type
+AsyncCall(F f, A1&& argument1, A&&... arguments)
+{
+	return AsyncCall(ThreadPool::Default(), std::move(f), std::forward<A1>(argument1), std::forward<A>(arguments)...);
+}
+
+template <typename F, typename A1, typename... A>
+typename std::enable_if<!priv::IsCallableAs<F, void, Task*, typename std::decay<A1>::type&, typename std::decay<A>::type&...>::value,
+Future<typename std::decay<decltype(std::declval<F&>()(std::declval<typename std::decay<A1>::type&>(),
+													   std::declval<typename std::decay<A>::type&>()...))>::type> >::type
+AsyncCall(ThreadPool& pool, F f, A1&& argument1, A&&... arguments)
+{
+	typedef typename std::decay<decltype(std::declval<F&>()(std::declval<typename std::decay<A1>::type&>(),
+															std::declval<typename std::decay<A>::type&>()...))>::type T;
+	typedef priv::Binder<T (void), F, typename std::decay<A1>::type, typename std::decay<A>::type...> Bound;
+	
+	boost::intrusive_ptr<priv::ValueTask<T> > t(new priv::FunctionTask<T, Bound>(Bound(std::move(f), std::forward<A1>(argument1),
+																					  std::forward<A>(arguments)...)));
+	pool.ScheduleTaskForExecution(t);
+	return Future<T>(t);
+}
+
+template <typename F, typename A1, typename... A>
+typename std::enable_if<!priv::IsCallableAs<F, void, Task*, typename std::decay<A1>::type&, typename std::decay<A>::type&...>::value,
+Future<typename std::decay<decltype(std::declval<F&>()(std::declval<typename std::decay<A1>::type&>(),
+													   std::declval<typename std::decay<A>::type&>()...))>::type> >::type
+AsyncCall(F f, A1&& argument1, A&&... arguments)
+{
+	return AsyncCall(ThreadPool::Default(), std::move(f), std::forward<A1>(argument1), std::forward<A>(arguments)...);
+}
@@ -36,8 +36,10 @@
 
 // General usecase files
 #include <Awl/Config.hpp>
+#include <Awl/Function.hpp>
 #include <Awl/Types.hpp>
 #include <Awl/Debug.hpp>
+#include <Awl/Time.hpp>
 
 // Thread-related classes
 #include <Awl/Lock.hpp>
@@ -47,8 +49,17 @@
 
 // Real Awl interesting stuff
 #include <Awl/Async.hpp>
+#include <Awl/Coroutine.hpp>
+#include <Awl/ForkJoin.hpp>
+#include <Awl/Future.hpp>
+#include <Awl/Latch.hpp>
 #include <Awl/MainThread.hpp>
+#include <Awl/Parallel.hpp>
 #include <Awl/Task.hpp>
+#include <Awl/TaskGraph.hpp>
+#include <Awl/TaskGroup.hpp>
+#include <Awl/Timer.hpp>
+#include <Awl/When.hpp>
 #include <Awl/WorkLoop.hpp>
 
 #endif
@@ -83,6 +83,18 @@ namespace awl {
 		 */
 		bool WaitAndLock(int awaitedValue, bool autoUnlock = false);
 		
+		/** Same as WaitAndLock() but gives up after @a timeout milliseconds.
+		 *
+		 * @param awaitedValue the value that should unlock the Condition
+		 * @param timeout the maximum time to wait, in milliseconds
+		 * @param autoUnlock see WaitAndLock()
+		 *
+		 * @return true if the @a awaitedValue has been reached, false if the
+		 * Condition has been invalidated or if the timeout expired. The
+		 * Condition is never locked when false is returned.
+		 */
+		bool TimedWaitAndLock(int awaitedValue, Uint32 timeout, bool autoUnlock = false);
+		
 		/** Locks the Condition without waiting for any state
 		 */
 		void Lock(void);
@@ -0,0 +1,71 @@
+
+/*
+ *  Continuation.hpp
+ *  Awl - Asynchronous Work Library
+ *
+ *  Copyright (c) 2011 Lucas Soltic
+ *  ceylow@gmail.com
+ *
+ *  This software is provided 'as-is', without any express or implied warranty.
+ *  In no event will the authors be held liable for any damages arising from
+ *  the use of this software.
+ *
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute it freely,
+ *  subject to the following restrictions:
+ *
+ *  1. The origin of this software must not be misrepresented;
+ *     you must not claim that you wrote the original software.
+ *     If you use this software in a product, an acknowledgment
+ *     in the product documentation would be appreciated but is not required.
+ *
+ *  2. Altered source versions must be plainly marked as such,
+ *     and must not be misrepresented as being the original software.
+ *
+ *  3. This notice may not be removed or altered from any source distribution.
+ *
+ */
+#ifndef Awl_Continuation_hpp
+#define Awl_Continuation_hpp
+
+#include <Awl/Config.hpp>
+
+namespace awl {
+	
+	class ThreadPool;
+	
+	namespace priv {
+		
+		/** @brief Action triggered by the end of a Task, see Task::Then()
+		 *
+		 * @details Continuations are linked in a lock-free list owned by the
+		 * Task until it is over. Exactly one of Run() or Discard() is called
+		 * on each of them, after which the Task does not touch it anymore.
+		 */
+		struct Continuation {
+			Continuation(void) :
+			next(NULL)
+			{
+			}
+			
+			virtual ~Continuation(void) {}
+			
+			/** @brief Called once the Task is over
+			 *
+			 * @param pool The ThreadPool of the worker that completed the
+			 * Task, or the default ThreadPool
+			 */
+			virtual void Run(ThreadPool& pool) = 0;
+			
+			/** @brief Called instead of Run() when the Task is destroyed
+			 * without having been executed
+			 */
+			virtual void Discard(void) = 0;
+			
+			Continuation *next;
+		};
+		
+	} // namespace priv
+} // namespace awl
+
+#endif // Awl_Continuation_hpp
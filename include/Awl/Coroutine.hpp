@@ -0,0 +1,327 @@
+
+/*
+ *  Coroutine.hpp
+ *  Awl - Asynchronous Work Library
+ *
+ *  Copyright (c) 2011 Lucas Soltic
+ *  ceylow@gmail.com
+ *
+ *  This software is provided 'as-is', without any express or implied warranty.
+ *  In no event will the authors be held liable for any damages arising from
+ *  the use of this software.
+ *
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute it freely,
+ *  subject to the following restrictions:
+ *
+ *  1. The origin of this software must not be misrepresented;
+ *     you must not claim that you wrote the original software.
+ *     If you use this software in a product, an acknowledgment
+ *     in the product documentation would be appreciated but is not required.
+ *
+ *  2. Altered source versions must be plainly marked as such,
+ *     and must not be misrepresented as being the original software.
+ *
+ *  3. This notice may not be removed or altered from any source distribution.
+ *
+ */
+#ifndef Awl_Coroutine_hpp
+#define Awl_Coroutine_hpp
+
+#include <Awl/Config.hpp>
+
+// Coroutines are only available when compiling with C++20 coroutine support,
+// the library itself does not need them
+#if defined(__cpp_impl_coroutine) && __cpp_impl_coroutine >= 201902L && defined(__has_include)
+#if __has_include(<coroutine>)
+	#define Awl_Coroutines
+#endif
+#endif
+
+#ifdef Awl_Coroutines
+
+#include <atomic>
+#include <coroutine>
+#include <exception>
+#include <optional>
+#include <utility>
+#include <Awl/Future.hpp>
+#include <Awl/Latch.hpp>
+#include <Awl/MainThread.hpp>
+#include <Awl/Task.hpp>
+#include <Awl/ThreadPool.hpp>
+
+namespace awl {
+	
+	/** @file Coroutine.hpp Awl/Coroutine.hpp
+	 * @brief Defines the CoTask coroutine type and the awaitables that move
+	 * a coroutine between the ThreadPool and the main thread.
+	 * @details Only available when compiling with C++20 coroutines, in which
+	 * case Awl_Coroutines is defined.
+	 */
+	
+	template <typename T> class CoTask;
+	
+	namespace priv {
+		
+		/** @brief Resumes the coroutine at @a address, used as Task callback
+		 */
+		inline void ResumeCoroutine(void *address, Task *)
+		{
+			std::coroutine_handle<>::from_address(address).resume();
+		}
+		
+		template <typename T>
+		class CoPromiseBase;
+		
+		template <typename T>
+		class CoPromise;
+	}
+	
+	/** @brief Awaitable that resumes the awaiting coroutine on a ThreadPool,
+	 * see Async()
+	 */
+	class PoolAwaiter {
+	public:
+		explicit PoolAwaiter(ThreadPool& pool);
+		
+		bool await_ready(void) const;
+		void await_suspend(std::coroutine_handle<> handle);
+		void await_resume(void) const;
+		
+	private:
+		ThreadPool& m_pool;
+	};
+	
+	/** @brief Awaitable that resumes the awaiting coroutine on the main
+	 * thread, see MainThread()
+	 */
+	class MainThreadAwaiter {
+	public:
+		bool await_ready(void) const;
+		void await_suspend(std::coroutine_handle<> handle);
+		void await_resume(void) const;
+	};
+	
+	/** @brief Awaitable that resumes the awaiting coroutine once a Task is
+	 * over, see operator co_await(const TaskRef&)
+	 */
+	class TaskAwaiter {
+	public:
+		explicit TaskAwaiter(const TaskRef& task);
+		
+		bool await_ready(void) const;
+		void await_suspend(std::coroutine_handle<> handle);
+		void await_resume(void) const;
+		
+	private:
+		TaskRef m_task;
+	};
+	
+	/** @brief Awaitable that resumes the awaiting coroutine once the result
+	 * of a Future is available, see operator co_await(const Future<T>&)
+	 */
+	template <typename T>
+	class FutureAwaiter {
+	public:
+		explicit FutureAwaiter(const Future<T>& future);
+		
+		bool await_ready(void) const;
+		void await_suspend(std::coroutine_handle<> handle);
+		typename priv::ValueTask<T>::Reference await_resume(void) const;
+		
+	private:
+		Future<T> m_future;
+	};
+	
+	/** @brief Moves the calling coroutine to the given ThreadPool
+	 *
+	 * @details The rest of the coroutine runs as a Task of @a pool.
+	 * @code
+	 * awl::CoTask<void> Load(Image& image, std::string path)
+	 * {
+	 *		co_await awl::Async();
+	 *		image.LoadFromFile(path);	// on a worker
+	 *
+	 *		co_await awl::MainThread();
+	 *		image.Show();				// on the main thread
+	 * }
+	 * @endcode
+	 */
+	PoolAwaiter Async(ThreadPool& pool);
+	
+	/** @brief Moves the calling coroutine to the default ThreadPool
+	 */
+	PoolAwaiter Async(void);
+	
+	/** @brief Moves the calling coroutine to the main thread
+	 *
+	 * @details The rest of the coroutine runs the next time the default
+	 * WorkLoop is run, like the functions given to MainThreadCall().
+	 */
+	MainThreadAwaiter MainThread(void);
+	
+	/** @brief Suspends the calling coroutine until the Task @a t is over,
+	 * without blocking any thread
+	 *
+	 * @details The coroutine is resumed on the ThreadPool of the worker that
+	 * completes @a t, see Task::Then().
+	 */
+	TaskAwaiter operator co_await(const TaskRef& t);
+	
+	/** @brief Suspends the calling coroutine until the result of @a f is
+	 * available, without blocking any thread
+	 *
+	 * @details The result of co_await is that of Future::Get(), which may
+	 * throw. The coroutine is resumed on the ThreadPool of the worker that
+	 * completes the Task of @a f.
+	 */
+	template <typename T>
+	FutureAwaiter<T> operator co_await(const Future<T>& f);
+	
+	/** @brief Defines a coroutine that produces a value of type T
+	 *
+	 * @details The coroutine starts running as soon as it is called, on the
+	 * calling thread, until it suspends. It can then be awaited by another
+	 * coroutine, which is resumed where the CoTask completes, or waited for
+	 * by a regular function with Wait() and Get().
+	 *
+	 * A CoTask can be awaited once. Destroying a CoTask that is not over
+	 * detaches the coroutine, which then releases itself once over.
+	 */
+	template <typename T>
+	class CoTask {
+	public:
+		typedef priv::CoPromise<T> promise_type;
+		typedef std::coroutine_handle<promise_type> Handle;
+		
+		/** @brief Creates an invalid CoTask, not bound to any coroutine
+		 */
+		CoTask(void);
+		
+		explicit CoTask(Handle handle);
+		CoTask(CoTask&& other);
+		CoTask& operator=(CoTask&& other);
+		CoTask(const CoTask&) = delete;
+		CoTask& operator=(const CoTask&) = delete;
+		
+		/** @brief Destroys the coroutine if it is over, detaches it otherwise
+		 */
+		~CoTask(void);
+		
+		/** @brief Returns whether the CoTask is bound to a coroutine
+		 */
+		bool IsValid(void) const;
+		
+		/** @brief Returns whether the coroutine is over
+		 */
+		bool IsReady(void) const;
+		
+		/** @brief Waits until the coroutine is over
+		 *
+		 * @details If called from a WorkerThread, pending tasks are executed
+		 * in the meantime, see Latch::Wait().
+		 */
+		void Wait(void) const;
+		
+		/** @brief Waits until the coroutine is over and returns its result
+		 *
+		 * @details If the coroutine threw an exception, that exception is
+		 * thrown again.
+		 */
+		typename std::add_lvalue_reference<T>::type Get(void) const;
+		
+		bool await_ready(void) const;
+		bool await_suspend(std::coroutine_handle<> awaiter);
+		T await_resume(void);
+		
+	private:
+		void Release(void);
+		
+		Handle m_handle;
+	};
+	
+	namespace priv {
+		
+		/** @brief Part of the CoTask promise that does not depend on
+		 * the result type
+		 *
+		 * @details The state is NULL while the coroutine runs, then holds the
+		 * address of the awaiting coroutine, or one of the Done and Detached
+		 * markers. The coroutine and its CoTask race to set it, so that
+		 * whichever comes last resumes the awaiter or destroys the frame.
+		 */
+		class CoPromiseState {
+		public:
+			CoPromiseState(void);
+			
+			std::suspend_never initial_suspend(void) const;
+			void unhandled_exception(void);
+			
+			bool IsDone(void) const;
+			void Wait(void);
+			void RethrowError(void) const;
+			
+			// Called by the awaiting coroutine, returns false if the
+			// coroutine is already over
+			bool SetAwaiter(std::coroutine_handle<> awaiter);
+			
+			// Called by the CoTask, returns false if the coroutine is
+			// already over and must be destroyed by the caller
+			bool Detach(void);
+			
+			// Called once the coroutine is over, returns what to resume
+			std::coroutine_handle<> Complete(std::coroutine_handle<> self);
+			
+		private:
+			static void *Done(void);
+			static void *Detached(void);
+			
+			std::atomic<void *> m_state;
+			std::exception_ptr m_error;
+			Latch m_over;
+		};
+		
+		template <typename T>
+		class CoPromiseBase : public CoPromiseState {
+		public:
+			struct FinalAwaiter {
+				bool await_ready(void) const noexcept;
+				std::coroutine_handle<> await_suspend(std::coroutine_handle<CoPromise<T> > handle) noexcept;
+				void await_resume(void) const noexcept;
+			};
+			
+			CoTask<T> get_return_object(void);
+			FinalAwaiter final_suspend(void) noexcept;
+		};
+		
+		template <typename T>
+		class CoPromise : public CoPromiseBase<T> {
+		public:
+			template <typename U>
+			void return_value(U&& value);
+			
+			T& GetValue(void);
+			T TakeValue(void);
+			
+		private:
+			std::optional<T> m_value;
+		};
+		
+		template <>
+		class CoPromise<void> : public CoPromiseBase<void> {
+		public:
+			void return_void(void);
+			void GetValue(void);
+			void TakeValue(void);
+		};
+		
+	} // namespace priv
+	
+#include <Awl/Coroutine.inl>
+	
+} // namespace awl
+
+#endif // Awl_Coroutines
+
+#endif // Awl_Coroutine_hpp
@@ -0,0 +1,373 @@
+
+/*
+ *  Coroutine.inl
+ *  Awl - Asynchronous Work Library
+ *
+ *  Copyright (c) 2011 Lucas Soltic
+ *  ceylow@gmail.com
+ *
+ *  This software is provided 'as-is', without any express or implied warranty.
+ *  In no event will the authors be held liable for any damages arising from
+ *  the use of this software.
+ *
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute it freely,
+ *  subject to the following restrictions:
+ *
+ *  1. The origin of this software must not be misrepresented;
+ *     you must not claim that you wrote the original software.
+ *     If you use this software in a product, an acknowledgment
+ *     in the product documentation would be appreciated but is not required.
+ *
+ *  2. Altered source versions must be plainly marked as such,
+ *     and must not be misrepresented as being the original software.
+ *
+ *  3. This notice may not be removed or altered from any source distribution.
+ *
+ */
+inline PoolAwaiter::PoolAwaiter(ThreadPool& pool) :
+m_pool(pool)
+{
+}
+
+inline bool PoolAwaiter::await_ready(void) const
+{
+	return false;
+}
+
+inline void PoolAwaiter::await_suspend(std::coroutine_handle<> handle)
+{
+	// The coroutine may be resumed before this returns, do not touch
+	// the awaiter afterwards
+	m_pool.ScheduleTaskForExecution(Task::Create(boost::bind(&priv::ResumeCoroutine, handle.address(), _1)));
+}
+
+inline void PoolAwaiter::await_resume(void) const
+{
+}
+
+inline bool MainThreadAwaiter::await_ready(void) const
+{
+	return false;
+}
+
+inline void MainThreadAwaiter::await_suspend(std::coroutine_handle<> handle)
+{
+	MainThreadCall(boost::bind(&priv::ResumeCoroutine, handle.address(), _1));
+}
+
+inline void MainThreadAwaiter::await_resume(void) const
+{
+}
+
+inline TaskAwaiter::TaskAwaiter(const TaskRef& task) :
+m_task(task)
+{
+}
+
+inline bool TaskAwaiter::await_ready(void) const
+{
+	return m_task->IsOver();
+}
+
+inline void TaskAwaiter::await_suspend(std::coroutine_handle<> handle)
+{
+	// Keep the Task alive: the awaiter is destroyed as soon as the
+	// coroutine is resumed
+	TaskRef task = m_task;
+	task->Then(Task::Create(boost::bind(&priv::ResumeCoroutine, handle.address(), _1)));
+}
+
+inline void TaskAwaiter::await_resume(void) const
+{
+}
+
+template <typename T>
+FutureAwaiter<T>::FutureAwaiter(const Future<T>& future) :
+m_future(future)
+{
+}
+
+template <typename T>
+bool FutureAwaiter<T>::await_ready(void) const
+{
+	return m_future.IsReady();
+}
+
+template <typename T>
+void FutureAwaiter<T>::await_suspend(std::coroutine_handle<> handle)
+{
+	TaskRef task = m_future.GetTask();
+	task->Then(Task::Create(boost::bind(&priv::ResumeCoroutine, handle.address(), _1)));
+}
+
+template <typename T>
+typename priv::ValueTask<T>::Reference FutureAwaiter<T>::await_resume(void) const
+{
+	return m_future.Get();
+}
+
+inline PoolAwaiter Async(ThreadPool& pool)
+{
+	return PoolAwaiter(pool);
+}
+
+inline PoolAwaiter Async(void)
+{
+	return PoolAwaiter(ThreadPool::Default());
+}
+
+inline MainThreadAwaiter MainThread(void)
+{
+	return MainThreadAwaiter();
+}
+
+inline TaskAwaiter operator co_await(const TaskRef& t)
+{
+	return TaskAwaiter(t);
+}
+
+template <typename T>
+FutureAwaiter<T> operator co_await(const Future<T>& f)
+{
+	return FutureAwaiter<T>(f);
+}
+
+template <typename T>
+CoTask<T>::CoTask(void) :
+m_handle(nullptr)
+{
+}
+
+template <typename T>
+CoTask<T>::CoTask(Handle handle) :
+m_handle(handle)
+{
+}
+
+template <typename T>
+CoTask<T>::CoTask(CoTask&& other) :
+m_handle(other.m_handle)
+{
+	other.m_handle = nullptr;
+}
+
+template <typename T>
+CoTask<T>& CoTask<T>::operator=(CoTask&& other)
+{
+	if (this != &other)
+	{
+		Release();
+		m_handle = other.m_handle;
+		other.m_handle = nullptr;
+	}
+	
+	return *this;
+}
+
+template <typename T>
+CoTask<T>::~CoTask(void)
+{
+	Release();
+}
+
+template <typename T>
+bool CoTask<T>::IsValid(void) const
+{
+	return m_handle != nullptr;
+}
+
+template <typename T>
+bool CoTask<T>::IsReady(void) const
+{
+	return m_handle && m_handle.promise().IsDone();
+}
+
+template <typename T>
+void CoTask<T>::Wait(void) const
+{
+	m_handle.promise().Wait();
+}
+
+template <typename T>
+typename std::add_lvalue_reference<T>::type CoTask<T>::Get(void) const
+{
+	Wait();
+	m_handle.promise().RethrowError();
+	return m_handle.promise().GetValue();
+}
+
+template <typename T>
+bool CoTask<T>::await_ready(void) const
+{
+	return IsReady();
+}
+
+template <typename T>
+bool CoTask<T>::await_suspend(std::coroutine_handle<> awaiter)
+{
+	return m_handle.promise().SetAwaiter(awaiter);
+}
+
+template <typename T>
+T CoTask<T>::await_resume(void)
+{
+	m_handle.promise().RethrowError();
+	return m_handle.promise().TakeValue();
+}
+
+template <typename T>
+void CoTask<T>::Release(void)
+{
+	if (m_handle && !m_handle.promise().Detach())
+		m_handle.destroy();
+	
+	m_handle = nullptr;
+}
+
+namespace priv {
+	
+	inline CoPromiseState::CoPromiseState(void) :
+	m_state(nullptr),
+	m_error(),
+	m_over(1)
+	{
+	}
+	
+	inline std::suspend_never CoPromiseState::initial_suspend(void) const
+	{
+		return std::suspend_never();
+	}
+	
+	inline void CoPromiseState::unhandled_exception(void)
+	{
+		m_error = std::current_exception();
+	}
+	
+	inline bool CoPromiseState::IsDone(void) const
+	{
+		return m_over.IsReleased();
+	}
+	
+	inline void CoPromiseState::Wait(void)
+	{
+		m_over.Wait();
+	}
+	
+	inline void CoPromiseState::RethrowError(void) const
+	{
+		if (m_error)
+			std::rethrow_exception(m_error);
+	}
+	
+	inline bool CoPromiseState::SetAwaiter(std::coroutine_handle<> awaiter)
+	{
+		void *expected = nullptr;
+		return m_state.compare_exchange_strong(expected, awaiter.address(), std::memory_order_acq_rel);
+	}
+	
+	inline bool CoPromiseState::Detach(void)
+	{
+		void *state = m_state.load(std::memory_order_acquire);
+		
+		while (state != Done())
+		{
+			if (m_state.compare_exchange_weak(state, Detached(), std::memory_order_acq_rel))
+				return true;
+		}
+		
+		return false;
+	}
+	
+	inline std::coroutine_handle<> CoPromiseState::Complete(std::coroutine_handle<> self)
+	{
+		// Release the waiters first: the CoTask may be detached right after,
+		// in which case the exchange below sees it
+		m_over.CountDown();
+		void *state = m_state.exchange(Done(), std::memory_order_acq_rel);
+		
+		if (state == Detached())
+		{
+			self.destroy();
+			return std::noop_coroutine();
+		}
+		
+		if (state == nullptr)
+			return std::noop_coroutine();
+		
+		return std::coroutine_handle<>::from_address(state);
+	}
+	
+	inline void *CoPromiseState::Done(void)
+	{
+		static char marker;
+		return &marker;
+	}
+	
+	inline void *CoPromiseState::Detached(void)
+	{
+		static char marker;
+		return &marker;
+	}
+	
+	template <typename T>
+	bool CoPromiseBase<T>::FinalAwaiter::await_ready(void) const noexcept
+	{
+		return false;
+	}
+	
+	template <typename T>
+	std::coroutine_handle<> CoPromiseBase<T>::FinalAwaiter::await_suspend(std::coroutine_handle<CoPromise<T> > handle) noexcept
+	{
+		return handle.promise().Complete(handle);
+	}
+	
+	template <typename T>
+	void CoPromiseBase<T>::FinalAwaiter::await_resume(void) const noexcept
+	{
+	}
+	
+	template <typename T>
+	CoTask<T> CoPromiseBase<T>::get_return_object(void)
+	{
+		return CoTask<T>(std::coroutine_handle<CoPromise<T> >::from_promise(static_cast<CoPromise<T>&>(*this)));
+	}
+	
+	template <typename T>
+	typename CoPromiseBase<T>::FinalAwaiter CoPromiseBase<T>::final_suspend(void) noexcept
+	{
+		return FinalAwaiter();
+	}
+	
+	template <typename T>
+	template <typename U>
+	void CoPromise<T>::return_value(U&& value)
+	{
+		m_value.emplace(std::forward<U>(value));
+	}
+	
+	template <typename T>
+	T& CoPromise<T>::GetValue(void)
+	{
+		return *m_value;
+	}
+	
+	template <typename T>
+	T CoPromise<T>::TakeValue(void)
+	{
+		return std::move(*m_value);
+	}
+	
+	inline void CoPromise<void>::return_void(void)
+	{
+	}
+	
+	inline void CoPromise<void>::GetValue(void)
+	{
+	}
+	
+	inline void CoPromise<void>::TakeValue(void)
+	{
+	}
+	
+} // namespace priv
@@ -30,6 +30,7 @@
 #define Awl_Debug_hpp
 
 #include <Awl/Mutex.hpp>
+#include <iostream>
 #include <Awl/Lock.hpp>
 
 #define DISPLAY_THREAD_ID awl::priv::do_display_thread_id(__func__, __FILE__, __LINE__)
@@ -0,0 +1,178 @@
+
+/*
+ *  ForkJoin.hpp
+ *  Awl - Asynchronous Work Library
+ *
+ *  Copyright (c) 2011 Lucas Soltic
+ *  ceylow@gmail.com
+ *
+ *  This software is provided 'as-is', without any express or implied warranty.
+ *  In no event will the authors be held liable for any damages arising from
+ *  the use of this software.
+ *
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute it freely,
+ *  subject to the following restrictions:
+ *
+ *  1. The origin of this software must not be misrepresented;
+ *     you must not claim that you wrote the original software.
+ *     If you use this software in a product, an acknowledgment
+ *     in the product documentation would be appreciated but is not required.
+ *
+ *  2. Altered source versions must be plainly marked as such,
+ *     and must not be misrepresented as being the original software.
+ *
+ *  3. This notice may not be removed or altered from any source distribution.
+ *
+ */
+#ifndef Awl_ForkJoin_hpp
+#define Awl_ForkJoin_hpp
+
+#include <atomic>
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <Awl/Config.hpp>
+#include <Awl/Latch.hpp>
+#include <Awl/Task.hpp>
+#include <Awl/boost/noncopyable.hpp>
+
+namespace awl {
+	
+	/** @file ForkJoin.hpp Awl/ForkJoin.hpp
+	 */
+	
+	class ThreadPool;
+	class WorkerThread;
+	
+	namespace priv {
+		
+		class SpawnArena;
+		class SpawnDeque;
+		
+		/** @brief Spawned function, allocated in the arena of its ForkJoin
+		 * scope and queued in the spawn deque of its worker
+		 */
+		struct SpawnFrame {
+			void (*run)(SpawnFrame *frame);
+			void (*destroy)(SpawnFrame *frame);
+			
+			// Incremented once the frame has been executed by a thief
+			std::atomic<Uint32> *stolenDone;
+			
+			// Next frame of the same scope
+			SpawnFrame *next;
+		};
+		
+		template <typename F>
+		struct FunctionFrame : SpawnFrame {
+			template <typename G>
+			explicit FunctionFrame(G&& f);
+			
+			static void Run(SpawnFrame *frame);
+			static void Destroy(SpawnFrame *frame);
+			
+			F function;
+		};
+		
+		// Position in the spawn arena of a WorkerThread
+		struct ArenaMark {
+			size_t chunk;
+			size_t offset;
+		};
+		
+	} // namespace priv
+	
+	/** @brief Defines a fork-join scope for recursive parallelism
+	 *
+	 * @details Spawn() pushes the function to the spawn deque of the calling
+	 * worker, from which idle workers steal. Sync() executes the spawned
+	 * functions that have not been stolen on the calling thread, most recent
+	 * first, and waits for the stolen ones. Spawned functions are neither
+	 * Tasks nor heap allocated: they are stored in a stack-like arena of the
+	 * worker, which makes spawning almost as cheap as a function call.
+	 *
+	 * Scopes must be nested like function calls, and Spawn() and Sync()
+	 * must be called by the thread that created the scope. When this thread
+	 * is not a worker of the pool, or when the scope is opened on a task
+	 * fiber (see PoolSettings::useFibers), spawned functions are scheduled
+	 * as regular tasks.
+	 *
+	 * @code
+	 * void Fib(int n, long *result)
+	 * {
+	 *		if (n < 2) { *result = n; return; }
+	 *
+	 *		long a, b;
+	 *		awl::ForkJoin scope;
+	 *		scope.Spawn(boost::bind(Fib, n - 1, &a));
+	 *		Fib(n - 2, &b);
+	 *		scope.Sync();
+	 *		*result = a + b;
+	 * }
+	 * @endcode
+	 */
+	class Awl_Api ForkJoin : boost::noncopyable {
+	public:
+		/** @brief Opens a scope on the pool of the calling worker, or on the
+		 * default ThreadPool if the calling thread is not a worker
+		 */
+		ForkJoin(void);
+		
+		/** @brief Opens a scope whose functions run on the given @a pool
+		 */
+		explicit ForkJoin(ThreadPool& pool);
+		
+		/** @brief Waits for the spawned functions, see Sync()
+		 */
+		~ForkJoin(void);
+		
+		/** @brief Spawns @a f, which may run in parallel with the caller
+		 * until the next Sync()
+		 *
+		 * @param f The function to spawn. It must have the following
+		 * signature: void function(void). It's moved into the frame when
+		 * passed as an rvalue, thus can be move-only. If no frame can be
+		 * allocated, @a f is called right away
+		 */
+		template <typename F>
+		void Spawn(F&& f);
+		
+		/** @brief Waits until all the functions spawned in this scope
+		 * are over
+		 *
+		 * @details The functions that have not been stolen are executed by
+		 * the calling thread. While the other ones are running, a worker
+		 * executes pending tasks rather than block, and only parks when
+		 * there are none.
+		 */
+		void Sync(void);
+		
+	private:
+		void Open(void);
+		void *AllocateFrame(size_t size);
+		void Publish(priv::SpawnFrame *frame);
+		void RunDetached(priv::SpawnFrame *frame, Task *self);
+		static bool IsSynced(const void *scope);
+		
+		WorkerThread *m_worker;
+		ThreadPool& m_pool;
+		priv::SpawnDeque *m_deque;
+		Int64 m_dequeMark;
+		priv::SpawnArena *m_arena;
+		priv::ArenaMark m_arenaMark;
+		priv::SpawnFrame *m_frames;
+		Uint32 m_spawnCount;
+		Uint32 m_inlineCount;
+		std::atomic<Uint32> m_stolenCount;
+		
+		// Only created when the functions are scheduled as regular tasks
+		Latch *m_detached;
+	};
+	
+#include <Awl/ForkJoin.inl>
+	
+} // namespace awl
+
+#endif // Awl_ForkJoin_hpp
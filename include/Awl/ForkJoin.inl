@@ -0,0 +1,74 @@
+
+/*
+ *  ForkJoin.inl
+ *  Awl - Asynchronous Work Library
+ *
+ *  Copyright (c) 2011 Lucas Soltic
+ *  ceylow@gmail.com
+ *
+ *  This software is provided 'as-is', without any express or implied warranty.
+ *  In no event will the authors be held liable for any damages arising from
+ *  the use of this software.
+ *
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute it freely,
+ *  subject to the following restrictions:
+ *
+ *  1. The origin of this software must not be misrepresented;
+ *     you must not claim that you wrote the original software.
+ *     If you use this software in a product, an acknowledgment
+ *     in the product documentation would be appreciated but is not required.
+ *
+ *  2. Altered source versions must be plainly marked as such,
+ *     and must not be misrepresented as being the original software.
+ *
+ *  3. This notice may not be removed or altered from any source distribution.
+ *
+ */
+namespace priv {
+	
+	template <typename F>
+	template <typename G>
+	FunctionFrame<F>::FunctionFrame(G&& f) :
+	function(std::forward<G>(f))
+	{
+		run = &FunctionFrame::Run;
+		destroy = &FunctionFrame::Destroy;
+	}
+	
+	template <typename F>
+	void FunctionFrame<F>::Run(SpawnFrame *frame)
+	{
+		static_cast<FunctionFrame *>(frame)->function();
+	}
+	
+	template <typename F>
+	void FunctionFrame<F>::Destroy(SpawnFrame *frame)
+	{
+		static_cast<FunctionFrame *>(frame)->~FunctionFrame();
+	}
+	
+} // namespace priv
+
+template <typename F>
+void ForkJoin::Spawn(F&& f)
+{
+	typedef priv::FunctionFrame<typename std::decay<F>::type> Frame;
+	void *memory = AllocateFrame(sizeof(Frame));
+	
+	// Out of memory: run it inline, as done when the deque is full
+	if (!memory)
+	{
+		f();
+		return;
+	}
+	
+	Frame *frame = new (memory) Frame(std::forward<F>(f));
+	
+	frame->stolenDone = &m_stolenCount;
+	frame->next = m_frames;
+	m_frames = frame;
+	m_spawnCount++;
+	
+	Publish(frame);
+}
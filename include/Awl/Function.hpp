@@ -0,0 +1,150 @@
+
+/*
+ *  Function.hpp
+ *  Awl - Asynchronous Work Library
+ *
+ *  Copyright (c) 2011 Lucas Soltic
+ *  ceylow@gmail.com
+ *
+ *  This software is provided 'as-is', without any express or implied warranty.
+ *  In no event will the authors be held liable for any damages arising from
+ *  the use of this software.
+ *
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute it freely,
+ *  subject to the following restrictions:
+ *
+ *  1. The origin of this software must not be misrepresented;
+ *     you must not claim that you wrote the original software.
+ *     If you use this software in a product, an acknowledgment
+ *     in the product documentation would be appreciated but is not required.
+ *
+ *  2. Altered source versions must be plainly marked as such,
+ *     and must not be misrepresented as being the original software.
+ *
+ *  3. This notice may not be removed or altered from any source distribution.
+ *
+ */
+#ifndef Awl_Function_hpp
+#define Awl_Function_hpp
+
+#include <Awl/Config.hpp>
+#include <cstddef>
+#include <new>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace awl {
+	
+	/** @file Function.hpp Awl/Function.hpp
+	 */
+	
+	namespace priv {
+		
+		/** @brief Tells whether F can be called with Args and its result
+		 * converted to R
+		 */
+		template <typename F, typename R, typename... Args>
+		struct IsCallableAs {
+			template <typename G>
+			static typename std::enable_if<std::is_void<R>::value ||
+			std::is_convertible<decltype(std::declval<G&>()(std::declval<Args>()...)), R>::value, char>::type
+			Test(int);
+			
+			template <typename G>
+			static long Test(...);
+			
+			static const bool value = (sizeof(Test<F>(0)) == sizeof(char));
+		};
+		
+		template <typename Signature, typename F, typename... A>
+		class Binder;
+	}
+	
+	template <typename Signature>
+	class Function;
+	
+	/** @brief Move-only function object with inline storage
+	 *
+	 * @details Function objects of up to InlineSize bytes that can be moved
+	 * without throwing are stored in the Function itself, without any
+	 * allocation. Bigger ones are moved to the heap. Unlike boost::function,
+	 * the target does not need to be copyable, thus neither is a Function:
+	 * it can only be moved.
+	 *
+	 * @code
+	 * std::unique_ptr<Image> image(LoadImage());
+	 * awl::Callback f(std::bind(Process, std::move(image), std::placeholders::_1));
+	 * awl::AsyncCall(std::move(f));
+	 * @endcode
+	 */
+	template <typename R, typename... Args>
+	class Function<R (Args...)> {
+	public:
+		/** Size of the biggest function object stored inline
+		 */
+		static const size_t InlineSize = 48;
+		
+		/** @brief Creates an empty Function
+		 */
+		Function(void);
+		Function(std::nullptr_t);
+		
+		/** @brief Creates a Function calling @a f, a null function pointer
+		 * giving an empty Function
+		 */
+		template <typename F>
+		Function(F f, typename std::enable_if<priv::IsCallableAs<F, R, Args...>::value &&
+				 !std::is_same<F, Function>::value>::type * = 0);
+		
+		Function(Function&& other);
+		Function& operator=(Function&& other);
+		Function& operator=(std::nullptr_t);
+		~Function(void);
+		
+		/** @brief Calls the target, the Function must not be empty
+		 */
+		R operator()(Args... args) const;
+		
+		/** @brief Returns whether the Function has no target
+		 */
+		bool IsEmpty(void) const;
+		
+		explicit operator bool(void) const;
+		
+		void Swap(Function& other);
+		
+	private:
+		Function(const Function& other);
+		Function& operator=(const Function& other);
+		
+		// How to use the target, one instance per target type
+		struct Manager {
+			R (*call)(void *storage, Args&&... args);
+			void (*move)(void *to, void *from);
+			void (*destroy)(void *storage);
+		};
+		
+		template <typename F, bool IsInline>
+		struct ManagerFor;
+		
+		template <typename F>
+		static bool IsNull(const F& f);
+		
+		template <typename F>
+		static bool IsNull(F *f);
+		
+		void Reset(void);
+		
+		const Manager *m_manager;
+		
+		// The target itself or, when it does not fit, a pointer to it
+		mutable typename std::aligned_storage<InlineSize, alignof(std::max_align_t)>::type m_storage;
+	};
+	
+#include <Awl/Function.inl>
+	
+} // namespace awl
+
+#endif // Awl_Function_hpp
@@ -0,0 +1,260 @@
+
+/*
+ *  Function.inl
+ *  Awl - Asynchronous Work Library
+ *
+ *  Copyright (c) 2011 Lucas Soltic
+ *  ceylow@gmail.com
+ *
+ *  This software is provided 'as-is', without any express or implied warranty.
+ *  In no event will the authors be held liable for any damages arising from
+ *  the use of this software.
+ *
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute it freely,
+ *  subject to the following restrictions:
+ *
+ *  1. The origin of this software must not be misrepresented;
+ *     you must not claim that you wrote the original software.
+ *     If you use this software in a product, an acknowledgment
+ *     in the product documentation would be appreciated but is not required.
+ *
+ *  2. Altered source versions must be plainly marked as such,
+ *     and must not be misrepresented as being the original software.
+ *
+ *  3. This notice may not be removed or altered from any source distribution.
+ *
+ */
+namespace priv {
+	
+	template <size_t... I>
+	struct IndexSequence {
+	};
+	
+	template <size_t N, size_t... I>
+	struct MakeIndexSequence : MakeIndexSequence<N - 1, N - 1, I...> {
+	};
+	
+	template <size_t... I>
+	struct MakeIndexSequence<0, I...> {
+		typedef IndexSequence<I...> type;
+	};
+	
+	/** @brief Function object calling F with its call arguments followed
+	 * by copies of the bound arguments A, stored inline
+	 *
+	 * @details The bound arguments are given to F as lvalues, which lets
+	 * F take them by reference, or even move them out.
+	 */
+	template <typename R, typename... Leading, typename F, typename... A>
+	class Binder<R (Leading...), F, A...> {
+	public:
+		template <typename... B>
+		explicit Binder(F f, B&&... arguments) :
+		m_function(std::move(f)),
+		m_arguments(std::forward<B>(arguments)...)
+		{
+		}
+		
+		R operator()(Leading... leading)
+		{
+			return Call(typename MakeIndexSequence<sizeof...(A)>::type(), std::forward<Leading>(leading)...);
+		}
+		
+	private:
+		template <size_t... I>
+		R Call(IndexSequence<I...>, Leading&&... leading)
+		{
+			return m_function(std::forward<Leading>(leading)..., std::get<I>(m_arguments)...);
+		}
+		
+		F m_function;
+		std::tuple<A...> m_arguments;
+	};
+	
+} // namespace priv
+
+template <typename R, typename... Args>
+template <typename F>
+struct Function<R (Args...)>::ManagerFor<F, true> {
+	static void Store(void *storage, F& f)
+	{
+		new (storage) F(std::move(f));
+	}
+	
+	static R Call(void *storage, Args&&... args)
+	{
+		return (*static_cast<F *>(storage))(std::forward<Args>(args)...);
+	}
+	
+	static void Move(void *to, void *from)
+	{
+		F *source = static_cast<F *>(from);
+		new (to) F(std::move(*source));
+		source->~F();
+	}
+	
+	static void Destroy(void *storage)
+	{
+		static_cast<F *>(storage)->~F();
+	}
+	
+	static const Manager instance;
+};
+
+template <typename R, typename... Args>
+template <typename F>
+const typename Function<R (Args...)>::Manager Function<R (Args...)>::ManagerFor<F, true>::instance =
+{ &ManagerFor::Call, &ManagerFor::Move, &ManagerFor::Destroy };
+
+template <typename R, typename... Args>
+template <typename F>
+struct Function<R (Args...)>::ManagerFor<F, false> {
+	static void Store(void *storage, F& f)
+	{
+		*static_cast<F **>(storage) = new F(std::move(f));
+	}
+	
+	static R Call(void *storage, Args&&... args)
+	{
+		return (**static_cast<F **>(storage))(std::forward<Args>(args)...);
+	}
+	
+	static void Move(void *to, void *from)
+	{
+		*static_cast<F **>(to) = *static_cast<F **>(from);
+	}
+	
+	static void Destroy(void *storage)
+	{
+		delete *static_cast<F **>(storage);
+	}
+	
+	static const Manager instance;
+};
+
+template <typename R, typename... Args>
+template <typename F>
+const typename Function<R (Args...)>::Manager Function<R (Args...)>::ManagerFor<F, false>::instance =
+{ &ManagerFor::Call, &ManagerFor::Move, &ManagerFor::Destroy };
+
+template <typename R, typename... Args>
+Function<R (Args...)>::Function(void) :
+m_manager(NULL)
+{
+}
+
+template <typename R, typename... Args>
+Function<R (Args...)>::Function(std::nullptr_t) :
+m_manager(NULL)
+{
+}
+
+template <typename R, typename... Args>
+template <typename F>
+Function<R (Args...)>::Function(F f, typename std::enable_if<priv::IsCallableAs<F, R, Args...>::value &&
+								!std::is_same<F, Function>::value>::type *) :
+m_manager(NULL)
+{
+	if (IsNull(f))
+		return;
+	
+	const bool isInline = (sizeof(F) <= InlineSize &&
+						   alignof(F) <= alignof(std::max_align_t) &&
+						   std::is_nothrow_move_constructible<F>::value);
+	
+	ManagerFor<F, isInline>::Store(&m_storage, f);
+	m_manager = &ManagerFor<F, isInline>::instance;
+}
+
+template <typename R, typename... Args>
+Function<R (Args...)>::Function(Function&& other) :
+m_manager(other.m_manager)
+{
+	if (m_manager)
+	{
+		m_manager->move(&m_storage, &other.m_storage);
+		other.m_manager = NULL;
+	}
+}
+
+template <typename R, typename... Args>
+Function<R (Args...)>& Function<R (Args...)>::operator=(Function&& other)
+{
+	if (this != &other)
+	{
+		Reset();
+		
+		if (other.m_manager)
+		{
+			other.m_manager->move(&m_storage, &other.m_storage);
+			m_manager = other.m_manager;
+			other.m_manager = NULL;
+		}
+	}
+	
+	return *this;
+}
+
+template <typename R, typename... Args>
+Function<R (Args...)>& Function<R (Args...)>::operator=(std::nullptr_t)
+{
+	Reset();
+	return *this;
+}
+
+template <typename R, typename... Args>
+Function<R (Args...)>::~Function(void)
+{
+	Reset();
+}
+
+template <typename R, typename... Args>
+R Function<R (Args...)>::operator()(Args... args) const
+{
+	return m_manager->call(&m_storage, std::forward<Args>(args)...);
+}
+
+template <typename R, typename... Args>
+bool Function<R (Args...)>::IsEmpty(void) const
+{
+	return m_manager == NULL;
+}
+
+template <typename R, typename... Args>
+Function<R (Args...)>::operator bool(void) const
+{
+	return m_manager != NULL;
+}
+
+template <typename R, typename... Args>
+void Function<R (Args...)>::Swap(Function& other)
+{
+	Function temporary(std::move(other));
+	other = std::move(*this);
+	*this = std::move(temporary);
+}
+
+template <typename R, typename... Args>
+template <typename F>
+bool Function<R (Args...)>::IsNull(const F&)
+{
+	return false;
+}
+
+template <typename R, typename... Args>
+template <typename F>
+bool Function<R (Args...)>::IsNull(F *f)
+{
+	return f == NULL;
+}
+
+template <typename R, typename... Args>
+void Function<R (Args...)>::Reset(void)
+{
+	if (m_manager)
+	{
+		m_manager->destroy(&m_storage);
+		m_manager = NULL;
+	}
+}
@@ -0,0 +1,169 @@
+
+/*
+ *  Future.hpp
+ *  Awl - Asynchronous Work Library
+ *
+ *  Copyright (c) 2011 Lucas Soltic
+ *  ceylow@gmail.com
+ *
+ *  This software is provided 'as-is', without any express or implied warranty.
+ *  In no event will the authors be held liable for any damages arising from
+ *  the use of this software.
+ *
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute it freely,
+ *  subject to the following restrictions:
+ *
+ *  1. The origin of this software must not be misrepresented;
+ *     you must not claim that you wrote the original software.
+ *     If you use this software in a product, an acknowledgment
+ *     in the product documentation would be appreciated but is not required.
+ *
+ *  2. Altered source versions must be plainly marked as such,
+ *     and must not be misrepresented as being the original software.
+ *
+ *  3. This notice may not be removed or altered from any source distribution.
+ *
+ */
+#ifndef Awl_Future_hpp
+#define Awl_Future_hpp
+
+#include <exception>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <Awl/Config.hpp>
+#include <Awl/Task.hpp>
+#include <Awl/ThreadPool.hpp>
+#include <Awl/boost/smart_ptr/intrusive_ptr.hpp>
+
+namespace awl {
+	
+	/** @file Future.hpp Awl/Future.hpp
+	 *
+	 * @brief Defines the Future class that gives access to the result of a
+	 * Task, see AsyncCall().
+	 */
+	
+	/** @brief Error held by a Future whose Task has been cancelled before
+	 * producing its result
+	 */
+	class TaskCancelled : public std::exception {
+	public:
+		virtual const char *what(void) const throw()
+		{
+			return "awl::TaskCancelled";
+		}
+	};
+	
+	namespace priv {
+		template <typename T> class ValueTask;
+		template <typename T, typename F> struct ContinuationResult;
+		
+		/** @brief Tells whether F is a Task callback, callable with a
+		 * Task pointer, rather than a function returning a value
+		 */
+		template <typename F>
+		struct IsTaskCallback {
+			template <typename G>
+			static char Test(decltype(std::declval<G&>()(std::declval<Task*&>()), 0));
+			
+			template <typename G>
+			static long Test(...);
+			
+			static const bool value = (sizeof(Test<F>(0)) == sizeof(char));
+		};
+	}
+	
+	/** @brief Gives access to the result of a Task, once it is over
+	 *
+	 * @details The result is stored in the Task object itself, thus getting
+	 * a Future does not allocate anything more than the Task. If the function
+	 * of the Task throws, the exception is held by the Future and thrown
+	 * again by Get().
+	 *
+	 * Futures are cheap to copy: all the copies share the same Task.
+	 */
+	template <typename T>
+	class Future {
+	public:
+		/** @brief Creates an invalid Future, not bound to any Task
+		 */
+		Future(void);
+		
+		/** @brief Creates a Future bound to the given @a task
+		 *
+		 * @details You should not need this, see AsyncCall().
+		 */
+		explicit Future(const boost::intrusive_ptr<priv::ValueTask<T> >& task);
+		
+		/** @brief Returns whether the Future is bound to a Task
+		 */
+		bool IsValid(void) const;
+		
+		/** @brief Returns whether the result is available, ie. Get()
+		 * does not block
+		 */
+		bool IsReady(void) const;
+		
+		/** @brief Waits until the result is available
+		 */
+		void Wait(void) const;
+		
+		/** @brief Waits until the result is available and returns it
+		 *
+		 * @details If the function of the Task threw an exception, that
+		 * exception is thrown again. If the Task has been cancelled before
+		 * its start, TaskCancelled is thrown.
+		 *
+		 * @return The value returned by the function of the Task
+		 */
+		typename priv::ValueTask<T>::Reference Get(void) const;
+		
+		/** @brief Waits until the result is available and returns whether
+		 * Get() would throw
+		 */
+		bool HasError(void) const;
+		
+		/** @brief Waits until the result is available and returns the
+		 * exception that Get() would throw, or a null exception_ptr
+		 */
+		std::exception_ptr GetError(void) const;
+		
+		/** @brief Returns the Task that computes the result
+		 */
+		TaskRef GetTask(void) const;
+		
+		/** @brief Calls @a f with the result once it is available, without
+		 * blocking any thread
+		 *
+		 * @details The continuation is scheduled directly by the worker
+		 * that completes this Task, on its ThreadPool, see Task::Then().
+		 * If this Future holds an error, @a f is not called and the error
+		 * is forwarded to the returned Future.
+		 *
+		 * @param f The function to call, with the following signature:
+		 * R function(const T& value), or R function(void) for Future<void>
+		 * @return The Future of the value returned by @a f
+		 */
+		template <typename F>
+		Future<typename priv::ContinuationResult<T, F>::type> Then(F f) const;
+		
+		/** @brief Same as Then(F) but schedules the continuation on the
+		 * given @a pool
+		 */
+		template <typename F>
+		Future<typename priv::ContinuationResult<T, F>::type> Then(ThreadPool& pool, F f) const;
+		
+	private:
+		template <typename F>
+		Future<typename priv::ContinuationResult<T, F>::type> Chain(ThreadPool *pool, F f) const;
+		
+		boost::intrusive_ptr<priv::ValueTask<T> > m_task;
+	};
+	
+#include <Awl/Future.inl>
+	
+} // namespace awl
+
+#endif // Awl_Future_hpp
@@ -0,0 +1,289 @@
+
+/*
+ *  Future.inl
+ *  Awl - Asynchronous Work Library
+ *
+ *  Copyright (c) 2011 Lucas Soltic
+ *  ceylow@gmail.com
+ *
+ *  This software is provided 'as-is', without any express or implied warranty.
+ *  In no event will the authors be held liable for any damages arising from
+ *  the use of this software.
+ *
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute it freely,
+ *  subject to the following restrictions:
+ *
+ *  1. The origin of this software must not be misrepresented;
+ *     you must not claim that you wrote the original software.
+ *     If you use this software in a product, an acknowledgment
+ *     in the product documentation would be appreciated but is not required.
+ *
+ *  2. Altered source versions must be plainly marked as such,
+ *     and must not be misrepresented as being the original software.
+ *
+ *  3. This notice may not be removed or altered from any source distribution.
+ *
+ */
+namespace priv {
+	
+	/** @brief Task that holds the storage for a result of type T
+	 */
+	template <typename T>
+	class ValueTask : public Task {
+	public:
+		typedef const T& Reference;
+		
+		ValueTask(Callback f) :
+		Task(std::move(f)),
+		m_hasValue(false)
+		{
+		}
+		
+		~ValueTask(void)
+		{
+			if (m_hasValue)
+				reinterpret_cast<T *>(&m_storage)->~T();
+		}
+		
+		template <typename F>
+		void Run(F& f)
+		{
+			try
+			{
+				new (&m_storage) T(f());
+				m_hasValue = true;
+			}
+			catch (...)
+			{
+				m_error = std::current_exception();
+			}
+		}
+		
+		Reference GetValue(void) const
+		{
+			if (!m_hasValue)
+				std::rethrow_exception(GetError());
+			
+			return *reinterpret_cast<const T *>(&m_storage);
+		}
+		
+		std::exception_ptr GetError(void) const
+		{
+			if (m_error || m_hasValue)
+				return m_error;
+			
+			return std::make_exception_ptr(TaskCancelled());
+		}
+		
+	private:
+		typename std::aligned_storage<sizeof(T), std::alignment_of<T>::value>::type m_storage;
+		bool m_hasValue;
+		std::exception_ptr m_error;
+	};
+	
+	template <>
+	class ValueTask<void> : public Task {
+	public:
+		typedef void Reference;
+		
+		ValueTask(Callback f) :
+		Task(std::move(f)),
+		m_hasRun(false)
+		{
+		}
+		
+		template <typename F>
+		void Run(F& f)
+		{
+			try
+			{
+				f();
+				m_hasRun = true;
+			}
+			catch (...)
+			{
+				m_error = std::current_exception();
+			}
+		}
+		
+		Reference GetValue(void) const
+		{
+			if (!m_hasRun)
+				std::rethrow_exception(GetError());
+		}
+		
+		std::exception_ptr GetError(void) const
+		{
+			if (m_error || m_hasRun)
+				return m_error;
+			
+			return std::make_exception_ptr(TaskCancelled());
+		}
+		
+	private:
+		bool m_hasRun;
+		std::exception_ptr m_error;
+	};
+	
+	/** @brief ValueTask computed by the function object F, stored inline
+	 */
+	template <typename T, typename F>
+	class FunctionTask : public ValueTask<T> {
+	public:
+		FunctionTask(F f) :
+		ValueTask<T>(&FunctionTask::Call),
+		m_function(std::move(f))
+		{
+		}
+		
+	private:
+		static void Call(Task *self)
+		{
+			FunctionTask *task = static_cast<FunctionTask *>(self);
+			task->Run(task->m_function);
+		}
+		
+		F m_function;
+	};
+	
+	template <typename T, typename F>
+	struct ContinuationResult {
+		typedef typename std::decay<decltype(std::declval<F&>()(std::declval<const T&>()))>::type type;
+	};
+	
+	template <typename F>
+	struct ContinuationResult<void, F> {
+		typedef typename std::decay<decltype(std::declval<F&>()())>::type type;
+	};
+	
+	/** @brief Calls F with the value of the antecedent Task, or forwards
+	 * its error
+	 */
+	template <typename T, typename F>
+	class ContinuationFunction {
+	public:
+		ContinuationFunction(const boost::intrusive_ptr<ValueTask<T> >& antecedent, F f) :
+		m_antecedent(antecedent),
+		m_function(std::move(f))
+		{
+		}
+		
+		typename ContinuationResult<T, F>::type operator()(void)
+		{
+			return m_function(m_antecedent->GetValue());
+		}
+		
+	private:
+		boost::intrusive_ptr<ValueTask<T> > m_antecedent;
+		F m_function;
+	};
+	
+	template <typename F>
+	class ContinuationFunction<void, F> {
+	public:
+		ContinuationFunction(const boost::intrusive_ptr<ValueTask<void> >& antecedent, F f) :
+		m_antecedent(antecedent),
+		m_function(std::move(f))
+		{
+		}
+		
+		typename ContinuationResult<void, F>::type operator()(void)
+		{
+			m_antecedent->GetValue();
+			return m_function();
+		}
+		
+	private:
+		boost::intrusive_ptr<ValueTask<void> > m_antecedent;
+		F m_function;
+	};
+	
+} // namespace priv
+
+template <typename T>
+Future<T>::Future(void) :
+m_task()
+{
+}
+
+template <typename T>
+Future<T>::Future(const boost::intrusive_ptr<priv::ValueTask<T> >& task) :
+m_task(task)
+{
+}
+
+template <typename T>
+bool Future<T>::IsValid(void) const
+{
+	return m_task.get() != NULL;
+}
+
+template <typename T>
+bool Future<T>::IsReady(void) const
+{
+	return m_task->IsDone();
+}
+
+template <typename T>
+void Future<T>::Wait(void) const
+{
+	m_task->Wait();
+}
+
+template <typename T>
+typename priv::ValueTask<T>::Reference Future<T>::Get(void) const
+{
+	Wait();
+	return m_task->GetValue();
+}
+
+template <typename T>
+bool Future<T>::HasError(void) const
+{
+	return GetError() != NULL;
+}
+
+template <typename T>
+std::exception_ptr Future<T>::GetError(void) const
+{
+	Wait();
+	return m_task->GetError();
+}
+
+template <typename T>
+TaskRef Future<T>::GetTask(void) const
+{
+	return m_task;
+}
+
+template <typename T>
+template <typename F>
+Future<typename priv::ContinuationResult<T, F>::type> Future<T>::Then(F f) const
+{
+	return Chain(NULL, std::move(f));
+}
+
+template <typename T>
+template <typename F>
+Future<typename priv::ContinuationResult<T, F>::type> Future<T>::Then(ThreadPool& pool, F f) const
+{
+	return Chain(&pool, std::move(f));
+}
+
+template <typename T>
+template <typename F>
+Future<typename priv::ContinuationResult<T, F>::type> Future<T>::Chain(ThreadPool *pool, F f) const
+{
+	typedef typename priv::ContinuationResult<T, F>::type R;
+	typedef priv::ContinuationFunction<T, F> Function;
+	
+	boost::intrusive_ptr<priv::ValueTask<R> > next(new priv::FunctionTask<R, Function>(Function(m_task, std::move(f))));
+	
+	if (pool)
+		m_task->Then(*pool, next);
+	else
+		m_task->Then(next);
+	
+	return Future<R>(next);
+}
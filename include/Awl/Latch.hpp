@@ -0,0 +1,92 @@
+
+/*
+ *  Latch.hpp
+ *  Awl - Asynchronous Work Library
+ *
+ *  Copyright (c) 2011 Lucas Soltic
+ *  ceylow@gmail.com
+ *
+ *  This software is provided 'as-is', without any express or implied warranty.
+ *  In no event will the authors be held liable for any damages arising from
+ *  the use of this software.
+ *
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute it freely,
+ *  subject to the following restrictions:
+ *
+ *  1. The origin of this software must not be misrepresented;
+ *     you must not claim that you wrote the original software.
+ *     If you use this software in a product, an acknowledgment
+ *     in the product documentation would be appreciated but is not required.
+ *
+ *  2. Altered source versions must be plainly marked as such,
+ *     and must not be misrepresented as being the original software.
+ *
+ *  3. This notice may not be removed or altered from any source distribution.
+ *
+ */
+#ifndef Awl_Latch_hpp
+#define Awl_Latch_hpp
+
+#include <atomic>
+#include <Awl/Config.hpp>
+#include <Awl/Condition.hpp>
+#include <Awl/boost/noncopyable.hpp>
+
+namespace awl {
+	
+	/** @file Latch.hpp Awl/Latch.hpp
+	 */
+	
+	/** @brief Defines a countdown the caller can wait on until it reaches zero
+	 *
+	 * @details Unlike Condition::WaitAndLock(), Wait() does not block a
+	 * WorkerThread: the worker executes the pending tasks of its ThreadPool
+	 * while waiting. This allows a Task to wait for the tasks it scheduled
+	 * without starving the pool.
+	 */
+	class ThreadPool;
+	
+	class Awl_Api Latch : boost::noncopyable {
+	public:
+		/** @brief Creates a Latch that is released after @a count calls
+		 * to CountDown()
+		 */
+		explicit Latch(int count = 0);
+		
+		/** @brief Adds @a count to the number of CountDown() calls that
+		 * are awaited
+		 *
+		 * @details Adding to a released Latch rearms it, which must not
+		 * happen while another thread waits on it.
+		 */
+		void Add(int count = 1);
+		
+		/** @brief Decrements the counter by @a count, and releases the
+		 * waiting threads if it reaches zero
+		 */
+		void CountDown(int count = 1);
+		
+		/** @brief Returns whether the counter reached zero
+		 */
+		bool IsReleased(void) const;
+		
+		/** @brief Waits until the counter reaches zero
+		 *
+		 * @details If called from a WorkerThread, pending tasks are executed
+		 * in the meantime.
+		 */
+		void Wait(void);
+		
+	private:
+		static bool IsCountedDown(const void *latch);
+		
+		std::atomic<int> m_count;
+		Condition m_released;
+		std::atomic<bool> m_done;
+		std::atomic<ThreadPool *> m_helperPool; // Pool of the waiting workers
+	};
+	
+} // namespace awl
+
+#endif // Awl_Latch_hpp
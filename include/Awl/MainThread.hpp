@@ -104,16 +104,13 @@
 { \
 struct __awl_local_struct \
 { \
-static void __awl_async_block(awl::Task *self) \
+static void __awl_async_block(awl::Task *self, type1 *__awl_p1) \
 { \
-type1 var1 = *(type1 *)self->input[#var1];\
+type1 var1 = *__awl_p1;\
 functionBlock \
 } \
 }; \
-awl::Callback __awl_f(boost::bind(__awl_local_struct::__awl_async_block, _1)); \
-awl::TaskRef __awl_t(new awl::Task(__awl_f)); \
-__awl_t->input[#var1] = (void *)&var1;\
-awl::WorkLoop::Default().ScheduleTaskForExecution(__awl_t); \
+awl::MainThreadCall(__awl_local_struct::__awl_async_block, &var1); \
 }
 
 /** @brief Creates a block that is to be executed asynchronously on the main thread
@@ -125,18 +122,14 @@ awl::WorkLoop::Default().ScheduleTaskForExecution(__awl_t); \
 { \
 struct __awl_local_struct \
 { \
-static void __awl_async_block(awl::Task *self) \
+static void __awl_async_block(awl::Task *self, type1 *__awl_p1, type2 *__awl_p2) \
 { \
-type1 & var1 = *(type1 *)self->input[#var1];\
-type2 & var2 = *(type2 *)self->input[#var2];\
+type1 & var1 = *__awl_p1;\
+type2 & var2 = *__awl_p2;\
 functionBlock \
 } \
 }; \
-awl::Callback __awl_f(boost::bind(__awl_local_struct::__awl_async_block, _1)); \
-awl::TaskRef __awl_t(new awl::Task(__awl_f)); \
-__awl_t->input[#var1] = (void *)&var1;\
-__awl_t->input[#var2] = (void *)&var2;\
-awl::WorkLoop::Default().ScheduleTaskForExecution(__awl_t); \
+awl::MainThreadCall(__awl_local_struct::__awl_async_block, &var1, &var2); \
 }
 
 /** @brief Creates a block that is to be executed asynchronously on the main thread
@@ -148,20 +141,15 @@ awl::WorkLoop::Default().ScheduleTaskForExecution(__awl_t); \
 { \
 struct __awl_local_struct \
 { \
-static void __awl_async_block(awl::Task *self) \
+static void __awl_async_block(awl::Task *self, type1 *__awl_p1, type2 *__awl_p2, type3 *__awl_p3) \
 { \
-type1 & var1 = *(type1 *)self->input[#var1];\
-type2 & var2 = *(type2 *)self->input[#var2];\
-type3 & var3 = *(type3 *)self->input[#var3];\
+type1 & var1 = *__awl_p1;\
+type2 & var2 = *__awl_p2;\
+type3 & var3 = *__awl_p3;\
 functionBlock \
 } \
 }; \
-awl::Callback __awl_f(boost::bind(__awl_local_struct::__awl_async_block, _1)); \
-awl::TaskRef __awl_t(new awl::Task(__awl_f)); \
-__awl_t->input[#var1] = (void *)&var1;\
-__awl_t->input[#var2] = (void *)&var2;\
-__awl_t->input[#var3] = (void *)&var3;\
-awl::WorkLoop::Default().ScheduleTaskForExecution(__awl_t); \
+awl::MainThreadCall(__awl_local_struct::__awl_async_block, &var1, &var2, &var3); \
 }
 
 /** @brief Creates a block that is to be executed asynchronously on the main thread
@@ -173,22 +161,16 @@ awl::WorkLoop::Default().ScheduleTaskForExecution(__awl_t); \
 { \
 struct __awl_local_struct \
 { \
-static void __awl_async_block(awl::Task *self) \
+static void __awl_async_block(awl::Task *self, type1 *__awl_p1, type2 *__awl_p2, type3 *__awl_p3, type4 *__awl_p4) \
 { \
-type1 & var1 = *(type1 *)self->input[#var1];\
-type2 & var2 = *(type2 *)self->input[#var2];\
-type3 & var3 = *(type3 *)self->input[#var3];\
-type4 & var4 = *(type4 *)self->input[#var4];\
+type1 & var1 = *__awl_p1;\
+type2 & var2 = *__awl_p2;\
+type3 & var3 = *__awl_p3;\
+type4 & var4 = *__awl_p4;\
 functionBlock \
 } \
 }; \
-awl::Callback __awl_f(boost::bind(__awl_local_struct::__awl_async_block, _1)); \
-awl::TaskRef __awl_t(new awl::Task(__awl_f)); \
-__awl_t->input[#var1] = (void *)&var1;\
-__awl_t->input[#var2] = (void *)&var2;\
-__awl_t->input[#var3] = (void *)&var3;\
-__awl_t->input[#var4] = (void *)&var4;\
-awl::WorkLoop::Default().ScheduleTaskForExecution(__awl_t); \
+awl::MainThreadCall(__awl_local_struct::__awl_async_block, &var1, &var2, &var3, &var4); \
 }
 
 /** @brief Creates a block that is to be executed asynchronously on the main thread
@@ -200,24 +182,17 @@ awl::WorkLoop::Default().ScheduleTaskForExecution(__awl_t); \
 { \
 struct __awl_local_struct \
 { \
-static void __awl_async_block(awl::Task *self) \
+static void __awl_async_block(awl::Task *self, type1 *__awl_p1, type2 *__awl_p2, type3 *__awl_p3, type4 *__awl_p4, type5 *__awl_p5) \
 { \
-type1 & var1 = *(type1 *)self->input[#var1];\
-type2 & var2 = *(type2 *)self->input[#var2];\
-type3 & var3 = *(type3 *)self->input[#var3];\
-type4 & var4 = *(type4 *)self->input[#var4];\
-type5 & var5 = *(type5 *)self->input[#var5];\
+type1 & var1 = *__awl_p1;\
+type2 & var2 = *__awl_p2;\
+type3 & var3 = *__awl_p3;\
+type4 & var4 = *__awl_p4;\
+type5 & var5 = *__awl_p5;\
 functionBlock \
 } \
 }; \
-awl::Callback __awl_f(boost::bind(__awl_local_struct::__awl_async_block, _1)); \
-awl::TaskRef __awl_t(new awl::Task(__awl_f)); \
-__awl_t->input[#var1] = (void *)&var1;\
-__awl_t->input[#var2] = (void *)&var2;\
-__awl_t->input[#var3] = (void *)&var3;\
-__awl_t->input[#var4] = (void *)&var4;\
-__awl_t->input[#var5] = (void *)&var5;\
-awl::WorkLoop::Default().ScheduleTaskForExecution(__awl_t); \
+awl::MainThreadCall(__awl_local_struct::__awl_async_block, &var1, &var2, &var3, &var4, &var5); \
 }
 
 /** @brief Creates a block that is to be executed asynchronously on the main thread
@@ -229,26 +204,18 @@ awl::WorkLoop::Default().ScheduleTaskForExecution(__awl_t); \
 { \
 struct __awl_local_struct \
 { \
-static void __awl_async_block(awl::Task *self) \
+static void __awl_async_block(awl::Task *self, type1 *__awl_p1, type2 *__awl_p2, type3 *__awl_p3, type4 *__awl_p4, type5 *__awl_p5, type6 *__awl_p6) \
 { \
-type1 & var1 = *(type1 *)self->input[#var1];\
-type2 & var2 = *(type2 *)self->input[#var2];\
-type3 & var3 = *(type3 *)self->input[#var3];\
-type4 & var4 = *(type4 *)self->input[#var4];\
-type5 & var5 = *(type5 *)self->input[#var5];\
-type6 & var6 = *(type6 *)self->input[#var6];\
+type1 & var1 = *__awl_p1;\
+type2 & var2 = *__awl_p2;\
+type3 & var3 = *__awl_p3;\
+type4 & var4 = *__awl_p4;\
+type5 & var5 = *__awl_p5;\
+type6 & var6 = *__awl_p6;\
 functionBlock \
 } \
 }; \
-awl::Callback __awl_f(boost::bind(__awl_local_struct::__awl_async_block, _1)); \
-awl::TaskRef __awl_t(new awl::Task(__awl_f)); \
-__awl_t->input[#var1] = (void *)&var1;\
-__awl_t->input[#var2] = (void *)&var2;\
-__awl_t->input[#var3] = (void *)&var3;\
-__awl_t->input[#var4] = (void *)&var4;\
-__awl_t->input[#var5] = (void *)&var5;\
-__awl_t->input[#var6] = (void *)&var6;\
-awl::WorkLoop::Default().ScheduleTaskForExecution(__awl_t); \
+awl::MainThreadCall(__awl_local_struct::__awl_async_block, &var1, &var2, &var3, &var4, &var5, &var6); \
 }
 
 /** @brief Creates a block that is to be executed asynchronously on the main thread
@@ -260,28 +227,19 @@ awl::WorkLoop::Default().ScheduleTaskForExecution(__awl_t); \
 { \
 struct __awl_local_struct \
 { \
-static void __awl_async_block(awl::Task *self) \
+static void __awl_async_block(awl::Task *self, type1 *__awl_p1, type2 *__awl_p2, type3 *__awl_p3, type4 *__awl_p4, type5 *__awl_p5, type6 *__awl_p6, type7 *__awl_p7) \
 { \
-type1 & var1 = *(type1 *)self->input[#var1];\
-type2 & var2 = *(type2 *)self->input[#var2];\
-type3 & var3 = *(type3 *)self->input[#var3];\
-type4 & var4 = *(type4 *)self->input[#var4];\
-type5 & var5 = *(type5 *)self->input[#var5];\
-type6 & var6 = *(type6 *)self->input[#var6];\
-type7 & var7 = *(type7 *)self->input[#var7];\
+type1 & var1 = *__awl_p1;\
+type2 & var2 = *__awl_p2;\
+type3 & var3 = *__awl_p3;\
+type4 & var4 = *__awl_p4;\
+type5 & var5 = *__awl_p5;\
+type6 & var6 = *__awl_p6;\
+type7 & var7 = *__awl_p7;\
 functionBlock \
 } \
 }; \
-awl::Callback __awl_f(boost::bind(__awl_local_struct::__awl_async_block, _1)); \
-awl::TaskRef __awl_t(new awl::Task(__awl_f)); \
-__awl_t->input[#var1] = (void *)&var1;\
-__awl_t->input[#var2] = (void *)&var2;\
-__awl_t->input[#var3] = (void *)&var3;\
-__awl_t->input[#var4] = (void *)&var4;\
-__awl_t->input[#var5] = (void *)&var5;\
-__awl_t->input[#var6] = (void *)&var6;\
-__awl_t->input[#var7] = (void *)&var7;\
-awl::WorkLoop::Default().ScheduleTaskForExecution(__awl_t); \
+awl::MainThreadCall(__awl_local_struct::__awl_async_block, &var1, &var2, &var3, &var4, &var5, &var6, &var7); \
 }
 
 /** @brief Creates a block that is to be executed asynchronously on the main thread
@@ -293,30 +251,20 @@ awl::WorkLoop::Default().ScheduleTaskForExecution(__awl_t); \
 { \
 struct __awl_local_struct \
 { \
-static void __awl_async_block(awl::Task *self) \
+static void __awl_async_block(awl::Task *self, type1 *__awl_p1, type2 *__awl_p2, type3 *__awl_p3, type4 *__awl_p4, type5 *__awl_p5, type6 *__awl_p6, type7 *__awl_p7, type8 *__awl_p8) \
 { \
-type1 & var1 = *(type1 *)self->input[#var1];\
-type2 & var2 = *(type2 *)self->input[#var2];\
-type3 & var3 = *(type3 *)self->input[#var3];\
-type4 & var4 = *(type4 *)self->input[#var4];\
-type5 & var5 = *(type5 *)self->input[#var5];\
-type6 & var6 = *(type6 *)self->input[#var6];\
-type7 & var7 = *(type7 *)self->input[#var7];\
-type8 & var8 = *(type8 *)self->input[#var8];\
+type1 & var1 = *__awl_p1;\
+type2 & var2 = *__awl_p2;\
+type3 & var3 = *__awl_p3;\
+type4 & var4 = *__awl_p4;\
+type5 & var5 = *__awl_p5;\
+type6 & var6 = *__awl_p6;\
+type7 & var7 = *__awl_p7;\
+type8 & var8 = *__awl_p8;\
 functionBlock \
 } \
 }; \
-awl::Callback __awl_f(boost::bind(__awl_local_struct::__awl_async_block, _1)); \
-awl::TaskRef __awl_t(new awl::Task(__awl_f)); \
-__awl_t->input[#var1] = (void *)&var1;\
-__awl_t->input[#var2] = (void *)&var2;\
-__awl_t->input[#var3] = (void *)&var3;\
-__awl_t->input[#var4] = (void *)&var4;\
-__awl_t->input[#var5] = (void *)&var5;\
-__awl_t->input[#var6] = (void *)&var6;\
-__awl_t->input[#var7] = (void *)&var7;\
-__awl_t->input[#var8] = (void *)&var8;\
-awl::WorkLoop::Default().ScheduleTaskForExecution(__awl_t); \
+awl::MainThreadCall(__awl_local_struct::__awl_async_block, &var1, &var2, &var3, &var4, &var5, &var6, &var7, &var8); \
 }
 
 /** @brief Creates a block that is to be executed asynchronously on the main thread
@@ -328,32 +276,21 @@ awl::WorkLoop::Default().ScheduleTaskForExecution(__awl_t); \
 { \
 struct __awl_local_struct \
 { \
-static void __awl_async_block(awl::Task *self) \
-{ \
-type1 & var1 = *(type1 *)self->input[#var1];\
-type2 & var2 = *(type2 *)self->input[#var2];\
-type3 & var3 = *(type3 *)self->input[#var3];\
-type4 & var4 = *(type4 *)self->input[#var4];\
-type5 & var5 = *(type5 *)self->input[#var5];\
-type6 & var6 = *(type6 *)self->input[#var6];\
-type7 & var7 = *(type7 *)self->input[#var7];\
-type8 & var8 = *(type8 *)self->input[#var8];\
-type9 & var9 = *(type9 *)self->input[#var9];\
+static void __awl_async_block(awl::Task *self, type1 *__awl_p1, type2 *__awl_p2, type3 *__awl_p3, type4 *__awl_p4, type5 *__awl_p5, type6 *__awl_p6, type7 *__awl_p7, type8 *__awl_p8, type9 *__awl_p9) \
+{ \
+type1 & var1 = *__awl_p1;\
+type2 & var2 = *__awl_p2;\
+type3 & var3 = *__awl_p3;\
+type4 & var4 = *__awl_p4;\
+type5 & var5 = *__awl_p5;\
+type6 & var6 = *__awl_p6;\
+type7 & var7 = *__awl_p7;\
+type8 & var8 = *__awl_p8;\
+type9 & var9 = *__awl_p9;\
 functionBlock \
 } \
 }; \
-awl::Callback __awl_f(boost::bind(__awl_local_struct::__awl_async_block, _1)); \
-awl::TaskRef __awl_t(new awl::Task(__awl_f)); \
-__awl_t->input[#var1] = (void *)&var1;\
-__awl_t->input[#var2] = (void *)&var2;\
-__awl_t->input[#var3] = (void *)&var3;\
-__awl_t->input[#var4] = (void *)&var4;\
-__awl_t->input[#var5] = (void *)&var5;\
-__awl_t->input[#var6] = (void *)&var6;\
-__awl_t->input[#var7] = (void *)&var7;\
-__awl_t->input[#var8] = (void *)&var8;\
-__awl_t->input[#var9] = (void *)&var9;\
-awl::WorkLoop::Default().ScheduleTaskForExecution(__awl_t); \
+awl::MainThreadCall(__awl_local_struct::__awl_async_block, &var1, &var2, &var3, &var4, &var5, &var6, &var7, &var8, &var9); \
 }
 
 /** @brief Creates a block that is to be executed asynchronously on the main thread
@@ -365,34 +302,22 @@ awl::WorkLoop::Default().ScheduleTaskForExecution(__awl_t); \
 { \
 struct __awl_local_struct \
 { \
-static void __awl_async_block(awl::Task *self) \
-{ \
-type1 & var1 = *(type1 *)self->input[#var1];\
-type2 & var2 = *(type2 *)self->input[#var2];\
-type3 & var3 = *(type3 *)self->input[#var3];\
-type4 & var4 = *(type4 *)self->input[#var4];\
-type5 & var5 = *(type5 *)self->input[#var5];\
-type6 & var6 = *(type6 *)self->input[#var6];\
-type7 & var7 = *(type7 *)self->input[#var7];\
-type8 & var8 = *(type8 *)self->input[#var8];\
-type9 & var9 = *(type9 *)self->input[#var9];\
-type10 & var10 = *(type10 *)self->input[#var10];\
+static void __awl_async_block(awl::Task *self, type1 *__awl_p1, type2 *__awl_p2, type3 *__awl_p3, type4 *__awl_p4, type5 *__awl_p5, type6 *__awl_p6, type7 *__awl_p7, type8 *__awl_p8, type9 *__awl_p9, type10 *__awl_p10) \
+{ \
+type1 & var1 = *__awl_p1;\
+type2 & var2 = *__awl_p2;\
+type3 & var3 = *__awl_p3;\
+type4 & var4 = *__awl_p4;\
+type5 & var5 = *__awl_p5;\
+type6 & var6 = *__awl_p6;\
+type7 & var7 = *__awl_p7;\
+type8 & var8 = *__awl_p8;\
+type9 & var9 = *__awl_p9;\
+type10 & var10 = *__awl_p10;\
 functionBlock \
 } \
 }; \
-awl::Callback __awl_f(boost::bind(__awl_local_struct::__awl_async_block, _1)); \
-awl::TaskRef __awl_t(new awl::Task(__awl_f)); \
-__awl_t->input[#var1] = (void *)&var1;\
-__awl_t->input[#var2] = (void *)&var2;\
-__awl_t->input[#var3] = (void *)&var3;\
-__awl_t->input[#var4] = (void *)&var4;\
-__awl_t->input[#var5] = (void *)&var5;\
-__awl_t->input[#var6] = (void *)&var6;\
-__awl_t->input[#var7] = (void *)&var7;\
-__awl_t->input[#var8] = (void *)&var8;\
-__awl_t->input[#var9] = (void *)&var9;\
-__awl_t->input[#var10] = (void *)&var10;\
-awl::WorkLoop::Default().ScheduleTaskForExecution(__awl_t); \
+awl::MainThreadCall(__awl_local_struct::__awl_async_block, &var1, &var2, &var3, &var4, &var5, &var6, &var7, &var8, &var9, &var10); \
 }
 
 /** @brief Creates a block that is to be executed on the main thread.
@@ -440,17 +365,13 @@ awl::WorkLoop::Default().ScheduleTaskForExecution(__awl_t); \
 { \
 struct __awl_local_struct \
 { \
-static void __awl_async_block(awl::Task *self) \
+static void __awl_async_block(awl::Task *self, type1 *__awl_p1) \
 { \
-type1 var1 = *(type1 *)self->input[#var1];\
+type1 var1 = *__awl_p1;\
 functionBlock \
 } \
 }; \
-awl::Callback __awl_f(boost::bind(__awl_local_struct::__awl_async_block, _1)); \
-awl::TaskRef __awl_t(new awl::Task(__awl_f)); \
-__awl_t->input[#var1] = (void *)&var1;\
-awl::WorkLoop::Default().ScheduleTaskForExecution(__awl_t); \
-__awl_t->Wait();\
+awl::MainThreadCall(__awl_local_struct::__awl_async_block, &var1)->Wait(); \
 }
 
 /** @brief Creates a block that is to be executed on the main thread
@@ -462,19 +383,14 @@ __awl_t->Wait();\
 { \
 struct __awl_local_struct \
 { \
-static void __awl_async_block(awl::Task *self) \
+static void __awl_async_block(awl::Task *self, type1 *__awl_p1, type2 *__awl_p2) \
 { \
-type1 & var1 = *(type1 *)self->input[#var1];\
-type2 & var2 = *(type2 *)self->input[#var2];\
+type1 & var1 = *__awl_p1;\
+type2 & var2 = *__awl_p2;\
 functionBlock \
 } \
 }; \
-awl::Callback __awl_f(boost::bind(__awl_local_struct::__awl_async_block, _1)); \
-awl::TaskRef __awl_t(new awl::Task(__awl_f)); \
-__awl_t->input[#var1] = (void *)&var1;\
-__awl_t->input[#var2] = (void *)&var2;\
-awl::WorkLoop::Default().ScheduleTaskForExecution(__awl_t); \
-__awl_t->Wait();\
+awl::MainThreadCall(__awl_local_struct::__awl_async_block, &var1, &var2)->Wait(); \
 }
 
 /** @brief Creates a block that is to be executed on the main thread
@@ -486,21 +402,15 @@ __awl_t->Wait();\
 { \
 struct __awl_local_struct \
 { \
-static void __awl_async_block(awl::Task *self) \
+static void __awl_async_block(awl::Task *self, type1 *__awl_p1, type2 *__awl_p2, type3 *__awl_p3) \
 { \
-type1 & var1 = *(type1 *)self->input[#var1];\
-type2 & var2 = *(type2 *)self->input[#var2];\
-type3 & var3 = *(type3 *)self->input[#var3];\
+type1 & var1 = *__awl_p1;\
+type2 & var2 = *__awl_p2;\
+type3 & var3 = *__awl_p3;\
 functionBlock \
 } \
 }; \
-awl::Callback __awl_f(boost::bind(__awl_local_struct::__awl_async_block, _1)); \
-awl::TaskRef __awl_t(new awl::Task(__awl_f)); \
-__awl_t->input[#var1] = (void *)&var1;\
-__awl_t->input[#var2] = (void *)&var2;\
-__awl_t->input[#var3] = (void *)&var3;\
-awl::WorkLoop::Default().ScheduleTaskForExecution(__awl_t); \
-__awl_t->Wait();\
+awl::MainThreadCall(__awl_local_struct::__awl_async_block, &var1, &var2, &var3)->Wait(); \
 }
 
 /** @brief Creates a block that is to be executed on the main thread
@@ -512,23 +422,16 @@ __awl_t->Wait();\
 { \
 struct __awl_local_struct \
 { \
-static void __awl_async_block(awl::Task *self) \
+static void __awl_async_block(awl::Task *self, type1 *__awl_p1, type2 *__awl_p2, type3 *__awl_p3, type4 *__awl_p4) \
 { \
-type1 & var1 = *(type1 *)self->input[#var1];\
-type2 & var2 = *(type2 *)self->input[#var2];\
-type3 & var3 = *(type3 *)self->input[#var3];\
-type4 & var4 = *(type4 *)self->input[#var4];\
+type1 & var1 = *__awl_p1;\
+type2 & var2 = *__awl_p2;\
+type3 & var3 = *__awl_p3;\
+type4 & var4 = *__awl_p4;\
 functionBlock \
 } \
 }; \
-awl::Callback __awl_f(boost::bind(__awl_local_struct::__awl_async_block, _1)); \
-awl::TaskRef __awl_t(new awl::Task(__awl_f)); \
-__awl_t->input[#var1] = (void *)&var1;\
-__awl_t->input[#var2] = (void *)&var2;\
-__awl_t->input[#var3] = (void *)&var3;\
-__awl_t->input[#var4] = (void *)&var4;\
-awl::WorkLoop::Default().ScheduleTaskForExecution(__awl_t); \
-__awl_t->Wait();\
+awl::MainThreadCall(__awl_local_struct::__awl_async_block, &var1, &var2, &var3, &var4)->Wait(); \
 }
 
 /** @brief Creates a block that is to be executed on the main thread
@@ -540,25 +443,17 @@ __awl_t->Wait();\
 { \
 struct __awl_local_struct \
 { \
-static void __awl_async_block(awl::Task *self) \
+static void __awl_async_block(awl::Task *self, type1 *__awl_p1, type2 *__awl_p2, type3 *__awl_p3, type4 *__awl_p4, type5 *__awl_p5) \
 { \
-type1 & var1 = *(type1 *)self->input[#var1];\
-type2 & var2 = *(type2 *)self->input[#var2];\
-type3 & var3 = *(type3 *)self->input[#var3];\
-type4 & var4 = *(type4 *)self->input[#var4];\
-type5 & var5 = *(type5 *)self->input[#var5];\
+type1 & var1 = *__awl_p1;\
+type2 & var2 = *__awl_p2;\
+type3 & var3 = *__awl_p3;\
+type4 & var4 = *__awl_p4;\
+type5 & var5 = *__awl_p5;\
 functionBlock \
 } \
 }; \
-awl::Callback __awl_f(boost::bind(__awl_local_struct::__awl_async_block, _1)); \
-awl::TaskRef __awl_t(new awl::Task(__awl_f)); \
-__awl_t->input[#var1] = (void *)&var1;\
-__awl_t->input[#var2] = (void *)&var2;\
-__awl_t->input[#var3] = (void *)&var3;\
-__awl_t->input[#var4] = (void *)&var4;\
-__awl_t->input[#var5] = (void *)&var5;\
-awl::WorkLoop::Default().ScheduleTaskForExecution(__awl_t); \
-__awl_t->Wait();\
+awl::MainThreadCall(__awl_local_struct::__awl_async_block, &var1, &var2, &var3, &var4, &var5)->Wait(); \
 }
 
 /** @brief Creates a block that is to be executed on the main thread
@@ -570,27 +465,18 @@ __awl_t->Wait();\
 { \
 struct __awl_local_struct \
 { \
-static void __awl_async_block(awl::Task *self) \
+static void __awl_async_block(awl::Task *self, type1 *__awl_p1, type2 *__awl_p2, type3 *__awl_p3, type4 *__awl_p4, type5 *__awl_p5, type6 *__awl_p6) \
 { \
-type1 & var1 = *(type1 *)self->input[#var1];\
-type2 & var2 = *(type2 *)self->input[#var2];\
-type3 & var3 = *(type3 *)self->input[#var3];\
-type4 & var4 = *(type4 *)self->input[#var4];\
-type5 & var5 = *(type5 *)self->input[#var5];\
-type6 & var6 = *(type6 *)self->input[#var6];\
+type1 & var1 = *__awl_p1;\
+type2 & var2 = *__awl_p2;\
+type3 & var3 = *__awl_p3;\
+type4 & var4 = *__awl_p4;\
+type5 & var5 = *__awl_p5;\
+type6 & var6 = *__awl_p6;\
 functionBlock \
 } \
 }; \
-awl::Callback __awl_f(boost::bind(__awl_local_struct::__awl_async_block, _1)); \
-awl::TaskRef __awl_t(new awl::Task(__awl_f)); \
-__awl_t->input[#var1] = (void *)&var1;\
-__awl_t->input[#var2] = (void *)&var2;\
-__awl_t->input[#var3] = (void *)&var3;\
-__awl_t->input[#var4] = (void *)&var4;\
-__awl_t->input[#var5] = (void *)&var5;\
-__awl_t->input[#var6] = (void *)&var6;\
-awl::WorkLoop::Default().ScheduleTaskForExecution(__awl_t); \
-__awl_t->Wait();\
+awl::MainThreadCall(__awl_local_struct::__awl_async_block, &var1, &var2, &var3, &var4, &var5, &var6)->Wait(); \
 }
 
 /** @brief Creates a block that is to be executed on the main thread
@@ -602,29 +488,19 @@ __awl_t->Wait();\
 { \
 struct __awl_local_struct \
 { \
-static void __awl_async_block(awl::Task *self) \
+static void __awl_async_block(awl::Task *self, type1 *__awl_p1, type2 *__awl_p2, type3 *__awl_p3, type4 *__awl_p4, type5 *__awl_p5, type6 *__awl_p6, type7 *__awl_p7) \
 { \
-type1 & var1 = *(type1 *)self->input[#var1];\
-type2 & var2 = *(type2 *)self->input[#var2];\
-type3 & var3 = *(type3 *)self->input[#var3];\
-type4 & var4 = *(type4 *)self->input[#var4];\
-type5 & var5 = *(type5 *)self->input[#var5];\
-type6 & var6 = *(type6 *)self->input[#var6];\
-type7 & var7 = *(type7 *)self->input[#var7];\
+type1 & var1 = *__awl_p1;\
+type2 & var2 = *__awl_p2;\
+type3 & var3 = *__awl_p3;\
+type4 & var4 = *__awl_p4;\
+type5 & var5 = *__awl_p5;\
+type6 & var6 = *__awl_p6;\
+type7 & var7 = *__awl_p7;\
 functionBlock \
 } \
 }; \
-awl::Callback __awl_f(boost::bind(__awl_local_struct::__awl_async_block, _1)); \
-awl::TaskRef __awl_t(new awl::Task(__awl_f)); \
-__awl_t->input[#var1] = (void *)&var1;\
-__awl_t->input[#var2] = (void *)&var2;\
-__awl_t->input[#var3] = (void *)&var3;\
-__awl_t->input[#var4] = (void *)&var4;\
-__awl_t->input[#var5] = (void *)&var5;\
-__awl_t->input[#var6] = (void *)&var6;\
-__awl_t->input[#var7] = (void *)&var7;\
-awl::WorkLoop::Default().ScheduleTaskForExecution(__awl_t); \
-__awl_t->Wait();\
+awl::MainThreadCall(__awl_local_struct::__awl_async_block, &var1, &var2, &var3, &var4, &var5, &var6, &var7)->Wait(); \
 }
 
 /** @brief Creates a block that is to be executed on the main thread
@@ -636,31 +512,20 @@ __awl_t->Wait();\
 { \
 struct __awl_local_struct \
 { \
-static void __awl_async_block(awl::Task *self) \
+static void __awl_async_block(awl::Task *self, type1 *__awl_p1, type2 *__awl_p2, type3 *__awl_p3, type4 *__awl_p4, type5 *__awl_p5, type6 *__awl_p6, type7 *__awl_p7, type8 *__awl_p8) \
 { \
-type1 & var1 = *(type1 *)self->input[#var1];\
-type2 & var2 = *(type2 *)self->input[#var2];\
-type3 & var3 = *(type3 *)self->input[#var3];\
-type4 & var4 = *(type4 *)self->input[#var4];\
-type5 & var5 = *(type5 *)self->input[#var5];\
-type6 & var6 = *(type6 *)self->input[#var6];\
-type7 & var7 = *(type7 *)self->input[#var7];\
-type8 & var8 = *(type8 *)self->input[#var8];\
+type1 & var1 = *__awl_p1;\
+type2 & var2 = *__awl_p2;\
+type3 & var3 = *__awl_p3;\
+type4 & var4 = *__awl_p4;\
+type5 & var5 = *__awl_p5;\
+type6 & var6 = *__awl_p6;\
+type7 & var7 = *__awl_p7;\
+type8 & var8 = *__awl_p8;\
 functionBlock \
 } \
 }; \
-awl::Callback __awl_f(boost::bind(__awl_local_struct::__awl_async_block, _1)); \
-awl::TaskRef __awl_t(new awl::Task(__awl_f)); \
-__awl_t->input[#var1] = (void *)&var1;\
-__awl_t->input[#var2] = (void *)&var2;\
-__awl_t->input[#var3] = (void *)&var3;\
-__awl_t->input[#var4] = (void *)&var4;\
-__awl_t->input[#var5] = (void *)&var5;\
-__awl_t->input[#var6] = (void *)&var6;\
-__awl_t->input[#var7] = (void *)&var7;\
-__awl_t->input[#var8] = (void *)&var8;\
-awl::WorkLoop::Default().ScheduleTaskForExecution(__awl_t); \
-__awl_t->Wait();\
+awl::MainThreadCall(__awl_local_struct::__awl_async_block, &var1, &var2, &var3, &var4, &var5, &var6, &var7, &var8)->Wait(); \
 }
 
 /** @brief Creates a block that is to be executed on the main thread
@@ -672,33 +537,21 @@ __awl_t->Wait();\
 { \
 struct __awl_local_struct \
 { \
-static void __awl_async_block(awl::Task *self) \
-{ \
-type1 & var1 = *(type1 *)self->input[#var1];\
-type2 & var2 = *(type2 *)self->input[#var2];\
-type3 & var3 = *(type3 *)self->input[#var3];\
-type4 & var4 = *(type4 *)self->input[#var4];\
-type5 & var5 = *(type5 *)self->input[#var5];\
-type6 & var6 = *(type6 *)self->input[#var6];\
-type7 & var7 = *(type7 *)self->input[#var7];\
-type8 & var8 = *(type8 *)self->input[#var8];\
-type9 & var9 = *(type9 *)self->input[#var9];\
+static void __awl_async_block(awl::Task *self, type1 *__awl_p1, type2 *__awl_p2, type3 *__awl_p3, type4 *__awl_p4, type5 *__awl_p5, type6 *__awl_p6, type7 *__awl_p7, type8 *__awl_p8, type9 *__awl_p9) \
+{ \
+type1 & var1 = *__awl_p1;\
+type2 & var2 = *__awl_p2;\
+type3 & var3 = *__awl_p3;\
+type4 & var4 = *__awl_p4;\
+type5 & var5 = *__awl_p5;\
+type6 & var6 = *__awl_p6;\
+type7 & var7 = *__awl_p7;\
+type8 & var8 = *__awl_p8;\
+type9 & var9 = *__awl_p9;\
 functionBlock \
 } \
 }; \
-awl::Callback __awl_f(boost::bind(__awl_local_struct::__awl_async_block, _1)); \
-awl::TaskRef __awl_t(new awl::Task(__awl_f)); \
-__awl_t->input[#var1] = (void *)&var1;\
-__awl_t->input[#var2] = (void *)&var2;\
-__awl_t->input[#var3] = (void *)&var3;\
-__awl_t->input[#var4] = (void *)&var4;\
-__awl_t->input[#var5] = (void *)&var5;\
-__awl_t->input[#var6] = (void *)&var6;\
-__awl_t->input[#var7] = (void *)&var7;\
-__awl_t->input[#var8] = (void *)&var8;\
-__awl_t->input[#var9] = (void *)&var9;\
-awl::WorkLoop::Default().ScheduleTaskForExecution(__awl_t); \
-__awl_t->Wait();\
+awl::MainThreadCall(__awl_local_struct::__awl_async_block, &var1, &var2, &var3, &var4, &var5, &var6, &var7, &var8, &var9)->Wait(); \
 }
 
 /** @brief Creates a block that is to be executed on the main thread
@@ -710,35 +563,22 @@ __awl_t->Wait();\
 { \
 struct __awl_local_struct \
 { \
-static void __awl_async_block(awl::Task *self) \
-{ \
-type1 & var1 = *(type1 *)self->input[#var1];\
-type2 & var2 = *(type2 *)self->input[#var2];\
-type3 & var3 = *(type3 *)self->input[#var3];\
-type4 & var4 = *(type4 *)self->input[#var4];\
-type5 & var5 = *(type5 *)self->input[#var5];\
-type6 & var6 = *(type6 *)self->input[#var6];\
-type7 & var7 = *(type7 *)self->input[#var7];\
-type8 & var8 = *(type8 *)self->input[#var8];\
-type9 & var9 = *(type9 *)self->input[#var9];\
-type10 & var10 = *(type10 *)self->input[#var10];\
+static void __awl_async_block(awl::Task *self, type1 *__awl_p1, type2 *__awl_p2, type3 *__awl_p3, type4 *__awl_p4, type5 *__awl_p5, type6 *__awl_p6, type7 *__awl_p7, type8 *__awl_p8, type9 *__awl_p9, type10 *__awl_p10) \
+{ \
+type1 & var1 = *__awl_p1;\
+type2 & var2 = *__awl_p2;\
+type3 & var3 = *__awl_p3;\
+type4 & var4 = *__awl_p4;\
+type5 & var5 = *__awl_p5;\
+type6 & var6 = *__awl_p6;\
+type7 & var7 = *__awl_p7;\
+type8 & var8 = *__awl_p8;\
+type9 & var9 = *__awl_p9;\
+type10 & var10 = *__awl_p10;\
 functionBlock \
 } \
 }; \
-awl::Callback __awl_f(boost::bind(__awl_local_struct::__awl_async_block, _1)); \
-awl::TaskRef __awl_t(new awl::Task(__awl_f)); \
-__awl_t->input[#var1] = (void *)&var1;\
-__awl_t->input[#var2] = (void *)&var2;\
-__awl_t->input[#var3] = (void *)&var3;\
-__awl_t->input[#var4] = (void *)&var4;\
-__awl_t->input[#var5] = (void *)&var5;\
-__awl_t->input[#var6] = (void *)&var6;\
-__awl_t->input[#var7] = (void *)&var7;\
-__awl_t->input[#var8] = (void *)&var8;\
-__awl_t->input[#var9] = (void *)&var9;\
-__awl_t->input[#var10] = (void *)&var10;\
-awl::WorkLoop::Default().ScheduleTaskForExecution(__awl_t); \
-__awl_t->Wait();\
+awl::MainThreadCall(__awl_local_struct::__awl_async_block, &var1, &var2, &var3, &var4, &var5, &var6, &var7, &var8, &var9, &var10)->Wait(); \
 }
 
 namespace awl {
@@ -751,6 +591,20 @@ namespace awl {
 	 */
 	TaskRef Awl_Api MainThreadCall(Callback f);
 	
+	/** @brief Call the given Task callback on the main thread, with copies
+	 * of the given arguments, and get a handle on this task
+	 *
+	 * @param f the function that represents the task, with the following
+	 * signature: void function(awl::Task *self, A1& argument1, A&... arguments)
+	 * @return The associated Task object
+	 * @see AsyncCall(ThreadPool&, F, A1&&, A&&...)
+	 */
+	template <typename F, typename A1, typename... A>
+	typename std::enable_if<priv::IsBoundTaskCallback<F, A1, A...>::value, TaskRef>::type
+	MainThreadCall(F f, A1&& argument1, A&&... arguments);
+	
+#include <Awl/MainThread.inl>
+	
 } // namespace awl
 
 #endif
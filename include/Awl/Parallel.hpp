@@ -0,0 +1,144 @@
+
+/*
+ *  Parallel.hpp
+ *  Awl - Asynchronous Work Library
+ *
+ *  Copyright (c) 2011 Lucas Soltic
+ *  ceylow@gmail.com
+ *
+ *  This software is provided 'as-is', without any express or implied warranty.
+ *  In no event will the authors be held liable for any damages arising from
+ *  the use of this software.
+ *
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute it freely,
+ *  subject to the following restrictions:
+ *
+ *  1. The origin of this software must not be misrepresented;
+ *     you must not claim that you wrote the original software.
+ *     If you use this software in a product, an acknowledgment
+ *     in the product documentation would be appreciated but is not required.
+ *
+ *  2. Altered source versions must be plainly marked as such,
+ *     and must not be misrepresented as being the original software.
+ *
+ *  3. This notice may not be removed or altered from any source distribution.
+ *
+ */
+#ifndef Awl_Parallel_hpp
+#define Awl_Parallel_hpp
+
+#include <atomic>
+#include <exception>
+#include <list>
+#include <Awl/Config.hpp>
+#include <Awl/Latch.hpp>
+#include <Awl/Task.hpp>
+#include <Awl/ThreadPool.hpp>
+#include <Awl/WorkerThread.hpp>
+#include <Awl/boost/bind.hpp>
+
+/** @file Parallel.hpp Awl/Parallel.hpp
+ * @brief Contains the loop-level parallelism algorithms: ParallelFor() and
+ * ParallelReduce().
+ *
+ * @details Ranges are split lazily: a piece of the range is only handed
+ * to another Task when ThreadPool::NeedsMoreTasks() says some worker could
+ * take it. Thus the number of tasks follows the number of hungry workers
+ * rather than the size of the range.
+ */
+
+namespace awl {
+	
+	/** @brief Defines the half-open range of indices [begin, end) processed
+	 * by ParallelFor() and ParallelReduce()
+	 */
+	template <typename Index>
+	struct Range {
+		/** @brief Creates the range [@a begin, @a end)
+		 *
+		 * @param grain The number of indices below which the range is
+		 * never split
+		 */
+		Range(Index begin, Index end, Index grain = 1);
+		
+		/** @brief Returns the number of indices in the range
+		 */
+		Index Size(void) const;
+		
+		/** @brief Returns whether the range contains no index
+		 */
+		bool IsEmpty(void) const;
+		
+		/** @brief Returns whether the range is larger than its grain
+		 */
+		bool IsDivisible(void) const;
+		
+		/** @brief Removes the second half of the range and returns it
+		 */
+		Range Split(void);
+		
+		/** @brief Removes the first grain of the range and returns it
+		 */
+		Range TakeFront(void);
+		
+		Index begin;
+		Index end;
+		Index grain;
+	};
+	
+	/** @brief Calls @a body on pieces of @a range in parallel on the
+	 * given ThreadPool, and waits until the whole range has been processed
+	 *
+	 * @details When called from one of the workers of @a pool, the calling
+	 * worker takes part in the computation and executes pending tasks
+	 * instead of blocking. If @a body throws, the pieces that have not
+	 * started are skipped and the first exception is rethrown once the
+	 * running ones are over.
+	 *
+	 * @param pool The ThreadPool that should execute the loop
+	 * @param range The indices to process
+	 * @param body The function to call on each piece, with the following
+	 * signature: void body(const awl::Range<Index>& piece)
+	 */
+	template <typename Index, typename Body>
+	void ParallelFor(ThreadPool& pool, const Range<Index>& range, const Body& body);
+	
+	/** @brief Same as ParallelFor(ThreadPool&, const Range<Index>&, const Body&)
+	 * on the default ThreadPool
+	 */
+	template <typename Index, typename Body>
+	void ParallelFor(const Range<Index>& range, const Body& body);
+	
+	/** @brief Reduces @a range in parallel on the given ThreadPool
+	 *
+	 * @details Each piece of the range is folded with @a body starting from
+	 * @a identity, then the partial results are merged with @a combine in
+	 * the order of the range, thus @a combine does not need to be
+	 * commutative. Exceptions are handled as by ParallelFor().
+	 *
+	 * @param pool The ThreadPool that should execute the reduction
+	 * @param range The indices to reduce
+	 * @param identity The neutral element of @a combine
+	 * @param body The function that folds a piece of the range, with the
+	 * following signature: T body(const awl::Range<Index>& piece, T value)
+	 * @param combine The function that merges two partial results, with the
+	 * following signature: T combine(T left, T right)
+	 * @return The reduction of the whole range
+	 */
+	template <typename Index, typename T, typename Body, typename Combine>
+	T ParallelReduce(ThreadPool& pool, const Range<Index>& range, const T& identity,
+					 const Body& body, const Combine& combine);
+	
+	/** @brief Same as ParallelReduce(ThreadPool&, const Range<Index>&, const T&,
+	 * const Body&, const Combine&) on the default ThreadPool
+	 */
+	template <typename Index, typename T, typename Body, typename Combine>
+	T ParallelReduce(const Range<Index>& range, const T& identity,
+					 const Body& body, const Combine& combine);
+	
+#include <Awl/Parallel.inl>
+	
+} // namespace awl
+
+#endif // Awl_Parallel_hpp
@@ -0,0 +1,319 @@
+
+/*
+ *  Parallel.inl
+ *  Awl - Asynchronous Work Library
+ *
+ *  Copyright (c) 2011 Lucas Soltic
+ *  ceylow@gmail.com
+ *
+ *  This software is provided 'as-is', without any express or implied warranty.
+ *  In no event will the authors be held liable for any damages arising from
+ *  the use of this software.
+ *
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute it freely,
+ *  subject to the following restrictions:
+ *
+ *  1. The origin of this software must not be misrepresented;
+ *     you must not claim that you wrote the original software.
+ *     If you use this software in a product, an acknowledgment
+ *     in the product documentation would be appreciated but is not required.
+ *
+ *  2. Altered source versions must be plainly marked as such,
+ *     and must not be misrepresented as being the original software.
+ *
+ *  3. This notice may not be removed or altered from any source distribution.
+ *
+ */
+template <typename Index>
+Range<Index>::Range(Index begin_, Index end_, Index grain_) :
+begin(begin_),
+end(end_),
+grain(grain_ > 0 ? grain_ : 1)
+{
+}
+
+template <typename Index>
+Index Range<Index>::Size(void) const
+{
+	return (end > begin) ? end - begin : 0;
+}
+
+template <typename Index>
+bool Range<Index>::IsEmpty(void) const
+{
+	return !(begin < end);
+}
+
+template <typename Index>
+bool Range<Index>::IsDivisible(void) const
+{
+	return Size() > grain;
+}
+
+template <typename Index>
+Range<Index> Range<Index>::Split(void)
+{
+	Index middle = begin + Size() / 2;
+	Range right(middle, end, grain);
+	end = middle;
+	return right;
+}
+
+template <typename Index>
+Range<Index> Range<Index>::TakeFront(void)
+{
+	Index last = (Size() > grain) ? begin + grain : end;
+	Range front(begin, last, grain);
+	begin = last;
+	return front;
+}
+
+namespace priv {
+	
+	inline bool IsWorkerOf(ThreadPool& pool)
+	{
+		WorkerThread *worker = WorkerThread::Current();
+		return worker && &worker->GetPool() == &pool;
+	}
+	
+	/** @brief Keeps the first exception thrown by the pieces of a loop,
+	 * rethrown by the caller once all the pieces are over
+	 */
+	class LoopError {
+	public:
+		LoopError(void) :
+		m_failed(false),
+		m_error()
+		{
+		}
+		
+		void Set(std::exception_ptr error)
+		{
+			if (!m_failed.exchange(true))
+				m_error = error;
+		}
+		
+		bool HasFailed(void) const
+		{
+			return m_failed.load(std::memory_order_relaxed);
+		}
+		
+		void Rethrow(void) const
+		{
+			if (m_error)
+				std::rethrow_exception(m_error);
+		}
+		
+	private:
+		std::atomic<bool> m_failed;
+		std::exception_ptr m_error;
+	};
+	
+	/** @brief Removes the next piece of @a range to process inline
+	 *
+	 * @details Pieces grow from one grain by doubling @a chunk, up to half
+	 * of what is left, thus NeedsMoreTasks() is only polled a logarithmic
+	 * number of times on large ranges
+	 */
+	template <typename Index>
+	Range<Index> TakeChunk(Range<Index>& range, Index& chunk)
+	{
+		Index size = range.Size();
+		Index half = size / 2;
+		
+		if (chunk < half)
+			size = chunk;
+		else if (half > range.grain)
+			size = half;
+		else if (size > range.grain)
+			size = range.grain;
+		
+		Range<Index> front(range.begin, range.begin + size, range.grain);
+		range.begin = front.end;
+		chunk = size * 2;
+		return front;
+	}
+	
+	template <typename Index, typename Body>
+	struct ForContext {
+		ForContext(ThreadPool& pool_, const Body& body_) :
+		pool(pool_),
+		body(body_)
+		{
+		}
+		
+		ThreadPool& pool;
+		const Body& body;
+		Latch latch;
+		LoopError error;
+	};
+	
+	template <typename Index, typename Body>
+	void ForPiece(Task *, ForContext<Index, Body> *context, Range<Index> range)
+	{
+		Index chunk = range.grain;
+		
+		try
+		{
+			while (!range.IsEmpty() && !context->error.HasFailed())
+			{
+				if (range.IsDivisible() && context->pool.NeedsMoreTasks())
+				{
+					TaskRef piece = Task::Create(boost::bind(&ForPiece<Index, Body>, _1, context, range.Split()));
+					context->latch.Add();
+					context->pool.ScheduleTaskForExecution(piece);
+					chunk = range.grain;
+				}
+				else
+				{
+					context->body(TakeChunk(range, chunk));
+				}
+			}
+		}
+		catch (...)
+		{
+			// The other pieces still use the context: the error is only
+			// rethrown by ParallelFor() once they are over
+			context->error.Set(std::current_exception());
+		}
+		
+		context->latch.CountDown();
+	}
+	
+	template <typename Index, typename T, typename Body, typename Combine>
+	struct ReduceContext {
+		ReduceContext(ThreadPool& pool_, const T& identity_, const Body& body_, const Combine& combine_) :
+		pool(pool_),
+		identity(identity_),
+		body(body_),
+		combine(combine_)
+		{
+		}
+		
+		ThreadPool& pool;
+		const T& identity;
+		const Body& body;
+		const Combine& combine;
+		LoopError error;
+	};
+	
+	template <typename Index, typename T, typename Body, typename Combine>
+	T ReducePiece(ReduceContext<Index, T, Body, Combine> *context, Range<Index> range);
+	
+	template <typename Index, typename T, typename Body, typename Combine>
+	void ReduceTask(Task *, ReduceContext<Index, T, Body, Combine> *context,
+					Range<Index> range, T *result, Latch *latch)
+	{
+		try
+		{
+			*result = ReducePiece(context, range);
+		}
+		catch (...)
+		{
+			context->error.Set(std::current_exception());
+		}
+		
+		latch->CountDown();
+	}
+	
+	template <typename Index, typename T, typename Body, typename Combine>
+	T ReducePiece(ReduceContext<Index, T, Body, Combine> *context, Range<Index> range)
+	{
+		// std::list keeps the addresses of the results stable while
+		// children are being added
+		std::list<T> results;
+		Latch latch;
+		T value = context->identity;
+		Index chunk = range.grain;
+		
+		try
+		{
+			while (!range.IsEmpty() && !context->error.HasFailed())
+			{
+				if (range.IsDivisible() && context->pool.NeedsMoreTasks())
+				{
+					results.push_back(context->identity);
+					TaskRef piece = Task::Create(boost::bind(&ReduceTask<Index, T, Body, Combine>,
+															 _1, context, range.Split(), &results.back(), &latch));
+					latch.Add();
+					context->pool.ScheduleTaskForExecution(piece);
+					chunk = range.grain;
+				}
+				else
+				{
+					value = context->body(TakeChunk(range, chunk), value);
+				}
+			}
+		}
+		catch (...)
+		{
+			// The children write to the results and the latch
+			latch.Wait();
+			throw;
+		}
+		
+		latch.Wait();
+		
+		// Each child took the upper half of what was left, thus the last
+		// child is the leftmost one
+		for (typename std::list<T>::reverse_iterator it = results.rbegin(); it != results.rend(); ++it)
+			value = context->combine(value, *it);
+		
+		return value;
+	}
+	
+} // namespace priv
+
+template <typename Index, typename Body>
+void ParallelFor(ThreadPool& pool, const Range<Index>& range, const Body& body)
+{
+	priv::ForContext<Index, Body> context(pool, body);
+	context.latch.Add();
+	
+	if (priv::IsWorkerOf(pool))
+		priv::ForPiece<Index, Body>(NULL, &context, range);
+	else
+		pool.ScheduleTaskForExecution
+		(Task::Create(boost::bind(&priv::ForPiece<Index, Body>, _1, &context, range)));
+	
+	context.latch.Wait();
+	context.error.Rethrow();
+}
+
+template <typename Index, typename Body>
+void ParallelFor(const Range<Index>& range, const Body& body)
+{
+	ParallelFor(ThreadPool::Default(), range, body);
+}
+
+template <typename Index, typename T, typename Body, typename Combine>
+T ParallelReduce(ThreadPool& pool, const Range<Index>& range, const T& identity,
+				 const Body& body, const Combine& combine)
+{
+	priv::ReduceContext<Index, T, Body, Combine> context(pool, identity, body, combine);
+	T result = identity;
+	
+	if (priv::IsWorkerOf(pool))
+	{
+		result = priv::ReducePiece(&context, range);
+	}
+	else
+	{
+		Latch latch(1);
+		pool.ScheduleTaskForExecution
+		(Task::Create(boost::bind(&priv::ReduceTask<Index, T, Body, Combine>,
+								  _1, &context, range, &result, &latch)));
+		latch.Wait();
+	}
+	
+	context.error.Rethrow();
+	return result;
+}
+
+template <typename Index, typename T, typename Body, typename Combine>
+T ParallelReduce(const Range<Index>& range, const T& identity,
+				 const Body& body, const Combine& combine)
+{
+	return ParallelReduce(ThreadPool::Default(), range, identity, body, combine);
+}
@@ -0,0 +1,189 @@
+
+/*
+ *  PoolSettings.hpp
+ *  Awl - Asynchronous Work Library
+ *
+ *  Copyright (c) 2011 Lucas Soltic
+ *  ceylow@gmail.com
+ *
+ *  This software is provided 'as-is', without any express or implied warranty.
+ *  In no event will the authors be held liable for any damages arising from
+ *  the use of this software.
+ *
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute it freely,
+ *  subject to the following restrictions:
+ *
+ *  1. The origin of this software must not be misrepresented;
+ *     you must not claim that you wrote the original software.
+ *     If you use this software in a product, an acknowledgment
+ *     in the product documentation would be appreciated but is not required.
+ *
+ *  2. Altered source versions must be plainly marked as such,
+ *     and must not be misrepresented as being the original software.
+ *
+ *  3. This notice may not be removed or altered from any source distribution.
+ *
+ */
+
+#ifndef Awl_PoolSettings_hpp
+#define Awl_PoolSettings_hpp
+
+#include <Awl/Config.hpp>
+#include <cstddef>
+#include <vector>
+
+namespace awl {
+	
+	/** @file PoolSettings.hpp Awl/PoolSettings.hpp
+	 */
+	
+	/** @brief Defines the order in which a ThreadPool starts the tasks
+	 * of a same priority band
+	 */
+	enum SchedulingPolicy {
+		FifoScheduling,		///< Oldest task first, tasks spawned by a worker are kept local to it
+		DeadlineScheduling	///< Earliest deadline first, see Task::SetDeadline()
+	};
+	
+	/** @brief Defines how the worker threads of a ThreadPool are
+	 * bound to the processors
+	 */
+	enum AffinityPolicy {
+		NoAffinity,			///< Workers may run on any processor
+		PinWorkersToCores,	///< Each worker is pinned to one processor, in turn
+		BindWorkersToCpuSet	///< All workers may run on any processor of the set
+	};
+	
+	/** @brief Defines the parameters used to create a ThreadPool
+	 *
+	 * @details When @a minWorkers is lower than @a maxWorkers, the pool is
+	 * elastic: it starts with @a minWorkers threads, spawns new ones while
+	 * tasks pile up and retires the extra ones once they've been idle for
+	 * @a keepAlive milliseconds.
+	 *
+	 * @code
+	 * awl::PoolSettings settings;
+	 * settings.minWorkers = 2;
+	 * settings.maxWorkers = 32;
+	 * awl::ThreadPool pool(settings);
+	 * @endcode
+	 */
+	struct Awl_Api PoolSettings {
+		/** @brief Creates settings for a fixed-size pool
+		 *
+		 * @param workerCount The number of worker threads, or 0 to use
+		 * one worker per processor the process may run on
+		 */
+		explicit PoolSettings(unsigned workerCount = 0);
+		
+		/** @brief Returns whether the worker count may change over time
+		 */
+		bool IsElastic(void) const;
+		
+		/** Minimum number of worker threads, also the initial one
+		 */
+		unsigned minWorkers;
+		
+		/** Maximum number of worker threads
+		 */
+		unsigned maxWorkers;
+		
+		/** Time in milliseconds after which an idle worker is retired,
+		 * as long as more than @a minWorkers are running
+		 */
+		Uint32 keepAlive;
+		
+		/** A new worker is spawned when there are more than
+		 * @a spawnQueueDepth queued tasks per running worker
+		 */
+		unsigned spawnQueueDepth;
+		
+		/** A new worker is spawned when a task has been waiting
+		 * for more than @a spawnWaitTime milliseconds in the shared queue,
+		 * which is checked whenever tasks are scheduled or dequeued
+		 */
+		Uint32 spawnWaitTime;
+		
+		/** Time in milliseconds after which a task waiting in the shared
+		 * queue is moved to the next higher priority band, so that low
+		 * priority tasks can't starve forever. 0 disables aging. Aging is
+		 * disabled with DeadlineScheduling, whose queues are ordered by
+		 * deadline rather than by submission: set earlier deadlines instead.
+		 */
+		Uint32 priorityAging;
+		
+		/** Order in which the tasks of a same priority band are started.
+		 * With DeadlineScheduling, all the tasks go through the shared queue
+		 * so that the earliest deadline is always served first, at the cost
+		 * of more contention than the default FifoScheduling.
+		 */
+		SchedulingPolicy scheduling;
+		
+		/** Number of tasks each priority band can hold in its lock-free
+		 * queue. Tasks scheduled from outside the pool only go through the
+		 * locked queue when this one is full. 0 disables the lock-free
+		 * queues, which are never used with DeadlineScheduling.
+		 */
+		unsigned injectionQueueSize;
+		
+		/** Maximum number of normal priority tasks a worker takes from the
+		 * shared queue at once. The extra tasks are moved to its local queue,
+		 * where the other workers can still steal them. 1 disables batching.
+		 */
+		unsigned dequeueBatchSize;
+		
+		/** Maximum number of times an idle worker polls the queues, with a
+		 * processor pause hint between two polls, before yielding. The actual
+		 * number adapts to how often spinning finds work. 0 disables spinning.
+		 */
+		unsigned idleSpinCount;
+		
+		/** Number of times an idle worker yields its time slice, polling the
+		 * queues in between, before parking until new tasks are scheduled.
+		 * Spinning and yielding burn processor time for lower wake up latency,
+		 * setting both counts to 0 parks idle workers right away.
+		 */
+		unsigned idleYieldCount;
+		
+		/** How the workers are bound to the processors. The binding of
+		 * a worker never changes, even when an elastic pool respawns it.
+		 */
+		AffinityPolicy affinity;
+		
+		/** Processors used by the workers when @a affinity is not
+		 * NoAffinity. Empty means all the processors the process may
+		 * run on.
+		 */
+		std::vector<unsigned> cpuSet;
+		
+		/** Leaves the first processor of @a cpuSet to the main thread,
+		 * which can be pinned there with Thread::SetCurrentThreadAffinity().
+		 * Ignored when it would leave no processor to the workers.
+		 */
+		bool reserveMainThreadCpu;
+		
+		/** Spreads the workers over the NUMA nodes of the machine, each
+		 * worker being bound to the processors of its node (or pinned to
+		 * one of them with PinWorkersToCores, @a cpuSet is then ignored).
+		 * Tasks can then be kept on a node with Task::SetNode().
+		 */
+		bool numaAware;
+		
+		/** Runs each task on a fiber of its worker. A task that blocks in
+		 * Task::Wait(), Sleep(), Condition::WaitAndLock() or Latch::Wait()
+		 * then suspends its fiber and the worker goes on with other tasks,
+		 * instead of the whole thread being blocked. Code that blocks by
+		 * other means still blocks the worker.
+		 */
+		bool useFibers;
+		
+		/** Size in bytes of the stack of each fiber when @a useFibers is
+		 * set. An overflow hits a guard page and crashes the program.
+		 */
+		size_t fiberStackSize;
+	};
+	
+} // namespace awl
+
+#endif // Awl_PoolSettings_hpp
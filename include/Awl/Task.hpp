@@ -31,9 +31,10 @@
 
 #include <Awl/Config.hpp>
 #include <Awl/Types.hpp>
-#include <Awl/Condition.hpp>
-#include <Awl/boost/shared_ptr.hpp>
+#include <Awl/Continuation.hpp>
+#include <Awl/boost/smart_ptr/intrusive_ptr.hpp>
 #include <Awl/boost/noncopyable.hpp>
+#include <atomic>
 #include <map>
 #include <string>
 
@@ -50,14 +51,70 @@ namespace awl {
 	 * the WorkLoop singleton.
 	 */
 	
+	class Task;
+	class ThreadPool;
 	class WorkerThread;
+	
+	namespace priv {
+		class TaskJoin;
+		
+		/** @brief Tells whether F is a Task callback that takes copies of A
+		 * after the Task pointer, and cannot be called with the Task
+		 * pointer only
+		 */
+		template <typename F, typename... A>
+		struct IsBoundTaskCallback {
+			static const bool value = (IsCallableAs<F, void, Task*, typename std::decay<A>::type&...>::value &&
+									   !IsCallableAs<F, void, Task*>::value);
+		};
+	}
+	
+	void intrusive_ptr_add_ref(const Task *task);
+	void intrusive_ptr_release(const Task *task);
+	
+	/** Defines an automatically released and shared
+	 * Task object.
+	 *
+	 * @details The reference count is stored in the Task itself, thus
+	 * a TaskRef can be built from a plain Task pointer at any time.
+	 */
+	typedef boost::intrusive_ptr<Task> TaskRef;
+	
 	/** @brief Task is mainly defined by a callback function and allows
 	 * asynchronous or synchronous execution, cancellation and abort.
 	 */
 	class Awl_Api Task : boost::noncopyable {
 		friend class WorkerThread;
 		friend class WorkLoop;
+		friend class ThreadPool;
+		friend class priv::TaskJoin;
+		friend class TaskGroup;
+		friend class TaskGraph;
+		template <typename T> friend class Future;
+		friend void intrusive_ptr_add_ref(const Task *task);
+		friend void intrusive_ptr_release(const Task *task);
 	public:
+		/** Value of a Task deadline when none has been set
+		 */
+		static const Uint64 NoDeadline = 0;
+		
+		/** Value of a Task node hint when none has been set
+		 */
+		static const int AnyNode = -1;
+		
+		/** @brief Allocates a Task from the memory of the NUMA node of the
+		 * calling WorkerThread, when it belongs to a NUMA-aware ThreadPool,
+		 * see also Create()
+		 */
+		static void *operator new(size_t size);
+		
+		/** @brief Allocates a Task from the memory of the given NUMA @a node
+		 */
+		static void *operator new(size_t size, int node);
+		
+		static void operator delete(void *block);
+		static void operator delete(void *block, int node);
+		
 		/** @brief Empty constructor to allow temporary (but unusable) Task objects
 		 */
 		Task(void);
@@ -73,12 +130,23 @@ namespace awl {
 		 */
 		Task(Callback f);
 		
+		/** @brief Creates a Task bound to the given @a f callback
+		 *
+		 * @details The Task, which holds its own reference count, is
+		 * allocated from per-thread pools, so that creating and releasing
+		 * Tasks usually doesn't go through the global heap.
+		 *
+		 * @param f The function that represents the task
+		 * @return The new Task
+		 */
+		static TaskRef Create(Callback f);
+		
 		//Task(const Task& other);
 		//Task& operator=(const Task& other);
 		
 		/** @brief Default destructor
 		 */
-		~Task(void);
+		virtual ~Task(void);
 		
 		/** @brief Cancel the Task
 		 *
@@ -87,7 +155,8 @@ namespace awl {
 		 * that flag through IsCancelled() and stopping its work as quickly
 		 * as possible.
 		 * If the Task hasn't been started yet, it's also marked as cancelled
-		 * but the bound callback will not be called.
+		 * but the bound callback will not be called. A Task waiting for its
+		 * timer (see AsyncCallAfter()) is completed right away.
 		 */
 		void Cancel(void);
 		
@@ -97,6 +166,8 @@ namespace awl {
 		 * it won't be executed.
 		 * If it's already started from a WorkerThread, the corresponding thread
 		 * is aborted and does not let the callback function clean its work.
+		 * The Task is then done: its waiters are released and its
+		 * continuations run. Aborting a Task that is over has no effect.
 		 * If it's already started from a WorkLoop, it only remains in a cancelled
 		 * state and has no effect if the callback function doesn't check
 		 * the cancellation flag.
@@ -124,40 +195,192 @@ namespace awl {
 		 */
 		bool IsOver(void) const;
 		
+		/** @brief Makes an over Task ready to be scheduled again
+		 *
+		 * @details The callback, priority, deadline and node hint are kept,
+		 * while the cancellation and completion states are cleared. Nothing
+		 * is allocated, which allows running the same Task object repeatedly.
+		 * The Task must be over, or must never have been scheduled.
+		 */
+		void Reset(void);
+		
 		/** @brief Wait until the task is over
 		 *
 		 * @details If the Task is to be executed on another thread, this
 		 * will block the current thread and its execution flow until
-		 * the Task has been completed.
-		 * If the Task is to be executed on the same thread, this call has
+		 * the Task has been completed. When called from a WorkerThread,
+		 * pending tasks of its ThreadPool are executed in the meantime
+		 * rather than blocking the worker, thus tasks can wait for the
+		 * tasks they scheduled whatever the nesting depth.
+		 * If the Task is being executed on the same thread, this call has
 		 * no synchronization effect and will return false.
 		 *
-		 * @return true is the Task has been performed on another thread, false
-		 * otherwise (also meaning the Task may not have been performed)
+		 * @return true if the Task is over, false otherwise (also meaning
+		 * the Task may not have been performed)
 		 */
 		bool Wait(void);
 		
+		/** @brief Schedule @a next for execution once this Task is over
+		 *
+		 * @details @a next is scheduled on the ThreadPool of the worker that
+		 * completes this Task, or on the default ThreadPool if this Task is
+		 * executed by a WorkLoop. If this Task is already over, @a next is
+		 * scheduled right away on the ThreadPool of the calling worker, or
+		 * on the default ThreadPool. Continuations are also scheduled when
+		 * this Task has been cancelled before its start. If this Task is
+		 * destroyed without having been executed, @a next is completed as
+		 * cancelled instead.
+		 *
+		 * A Task can only wait for one antecedent at a time: @a next must
+		 * not be passed to Then() again before it has been scheduled.
+		 *
+		 * @param next The Task to schedule
+		 */
+		void Then(const TaskRef& next);
+		
+		/** @brief Same as Then(const TaskRef&) but schedules @a next on the
+		 * given @a pool
+		 */
+		void Then(ThreadPool& pool, const TaskRef& next);
+		
+		/** @brief Returns the priority the Task has been scheduled with
+		 *
+		 * @return The priority band of the Task, NormalPriority if the Task
+		 * has not been scheduled with an explicit priority
+		 */
+		Priority GetPriority(void) const;
+		
+		/** @brief Set the time before which the Task should be completed
+		 *
+		 * @details The deadline is only taken into account by pools using
+		 * DeadlineScheduling, which start the Task with the earliest deadline
+		 * first, and it must be set before scheduling the Task. Completing a
+		 * Task after its deadline is counted as a miss by its ThreadPool.
+		 *
+		 * @param deadline Absolute time in milliseconds, as returned by
+		 * GetMonotonicTime(), or NoDeadline
+		 */
+		void SetDeadline(Uint64 deadline);
+		
+		/** @brief Returns the deadline of the Task, NoDeadline if none has been set
+		 */
+		Uint64 GetDeadline(void) const;
+		
+		/** @brief Set the NUMA node that owns the data of the Task
+		 *
+		 * @details NUMA-aware pools (see PoolSettings::numaAware) execute
+		 * the Task on a worker of that node, unless all the workers of the
+		 * node are busy while other nodes are idle. The hint must be set
+		 * before scheduling the Task, and is ignored by other pools.
+		 *
+		 * @param node The NUMA node number, or AnyNode
+		 */
+		void SetNode(int node);
+		
+		/** @brief Returns the NUMA node hint of the Task, AnyNode if none has been set
+		 */
+		int GetNode(void) const;
+		
 		/** @brief Define the input values to be used by the executed block
+		 *
+		 * @deprecated The Awl*Block_N macros no longer use the input map,
+		 * pass arguments to AsyncCall(F, A1&&, A&&...) instead
 		 */
 		void SetInput(std::map<std::string, void *>& inputValues);
 		
 		std::map<std::string, void *> input;
+	protected:
+		/** @brief Calls Discard() on the continuations that have not run
+		 *
+		 * @details Subclasses that embed continuations must call it from
+		 * their destructor, as they are destroyed before ~Task() runs.
+		 */
+		void DiscardContinuations(void);
+		
+		/** @brief Called by Cancel() once the Task is marked as cancelled
+		 */
+		virtual void OnCancel(void);
+		
 	private:
-		void Execute(WorkerThread& owner);
-		void Execute(void); // from work loop
+		// Bits of m_state
+		enum {
+			CancelledFlag = 1,	// Cancel() has been called
+			RunningFlag = 2,	// Execute() has started
+			OverFlag = 4,		// The callback has returned
+			DoneFlag = 8,		// Execute() is over, the Task can be waited on
+			WaiterFlag = 16,	// Some thread may be parked until DoneFlag is set
+			HelperFlag = 32		// Some workers of m_helperPool may be parked
+		};
+		
+		/** @brief Returns whether Execute() is over
+		 */
+		bool IsDone(void) const;
+		static bool IsDone(const void *task);
+		
+		/** @brief Parks the calling thread until the Task is done, or until
+		 * @a timeout milliseconds have elapsed (0 = no timeout)
+		 */
+		void WaitUntilDone(Uint32 timeout);
+		
+		/** @brief Executes the Task, returns false if Abort() completed it
+		 * in place of the executing thread
+		 */
+		bool Execute(WorkerThread& owner);
+		bool Execute(void); // from work loop
+		
+		/** @brief Calls the callback unless the Task has been cancelled,
+		 * returns OverFlag if it has been called
+		 */
+		Uint32 RunCallback(ThreadPool& pool);
 		
+		/** @brief Sets DoneFlag and @a flags, then wakes the waiters and runs
+		 * the continuations on @a pool, unless the Task was already done
+		 */
+		bool Complete(Uint32 flags, ThreadPool& pool);
+		void Finish(Uint32 previousState, ThreadPool& current);
+		void AddContinuation(priv::Continuation *c);
+		void RunContinuations(ThreadPool& current);
+		void Chain(ThreadPool *pool, const TaskRef& next);
+		
+		/** @brief Schedules the Task once its antecedent is over, embedded
+		 * so that Then() does not allocate
+		 */
+		class Successor : public priv::Continuation {
+		public:
+			Successor(Task& task);
+			
+			void Run(ThreadPool& pool);
+			void Discard(void);
+			
+			ThreadPool *pool; // Pool given to Then(), if any
+		private:
+			Task& m_task;
+		};
+		
+		mutable std::atomic<Uint32> m_referenceCount;
+		std::atomic<Uint32> m_state;
 		Callback m_callback;
-		bool m_isCancelled;
-		bool m_isOver;
-		WorkerThread *m_owner;
-		Uint64 m_threadId;
-		Condition m_taskDone;
+		std::atomic<WorkerThread *> m_owner; // Set while executed by a worker
+		std::atomic<ThreadPool *> m_helperPool; // Pool of the waiting workers
+		std::atomic<Uint64> m_threadId; // Only compared with the current thread
+		Uint64 m_scheduleTime;
+		Priority m_priority;
+		Uint64 m_deadline;
+		int m_node;
+		std::atomic<priv::Continuation *> m_continuations;
+		Successor m_successor;
 	};
 	
-	/** Defines an automatically released and shared
-	 * Task object.
-	 */
-	typedef boost::shared_ptr<Task> TaskRef;
+	inline void intrusive_ptr_add_ref(const Task *task)
+	{
+		task->m_referenceCount.fetch_add(1, std::memory_order_relaxed);
+	}
+	
+	inline void intrusive_ptr_release(const Task *task)
+	{
+		if (task->m_referenceCount.fetch_sub(1, std::memory_order_acq_rel) == 1)
+			delete task;
+	}
 	
 } // namespace awl
 
@@ -0,0 +1,162 @@
+
+/*
+ *  TaskGraph.hpp
+ *  Awl - Asynchronous Work Library
+ *
+ *  Copyright (c) 2011 Lucas Soltic
+ *  ceylow@gmail.com
+ *
+ *  This software is provided 'as-is', without any express or implied warranty.
+ *  In no event will the authors be held liable for any damages arising from
+ *  the use of this software.
+ *
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute it freely,
+ *  subject to the following restrictions:
+ *
+ *  1. The origin of this software must not be misrepresented;
+ *     you must not claim that you wrote the original software.
+ *     If you use this software in a product, an acknowledgment
+ *     in the product documentation would be appreciated but is not required.
+ *
+ *  2. Altered source versions must be plainly marked as such,
+ *     and must not be misrepresented as being the original software.
+ *
+ *  3. This notice may not be removed or altered from any source distribution.
+ *
+ */
+#ifndef Awl_TaskGraph_hpp
+#define Awl_TaskGraph_hpp
+
+#include <atomic>
+#include <vector>
+#include <Awl/Config.hpp>
+#include <Awl/Latch.hpp>
+#include <Awl/Task.hpp>
+#include <Awl/boost/noncopyable.hpp>
+
+namespace awl {
+	
+	/** @file TaskGraph.hpp Awl/TaskGraph.hpp
+	 */
+	
+	class ThreadPool;
+	
+	namespace priv {
+		class GraphTask;
+	}
+	
+	/** @brief Defines a set of callbacks with dependencies between them
+	 *
+	 * @details Each node of the graph is a Task callback, and each edge tells
+	 * that a node must wait for another one to complete. When the graph runs,
+	 * a node is scheduled on the ThreadPool by the worker that completes its
+	 * last predecessor, thus no worker ever blocks waiting for a dependency.
+	 *
+	 * The Task objects are built by the first run and reused by the next
+	 * ones, which only reset counters: running a graph again allocates
+	 * nothing, which suits work scheduled every frame.
+	 *
+	 * A node completes once its Task is done, whether its callback returned,
+	 * threw, or was skipped because the Task was cancelled, or whether the
+	 * Task was aborted (see Task::Abort()). Its successors are scheduled in
+	 * all cases: a node that must stop the rest of the graph has to tell
+	 * its successors through their own data, which they check when called.
+	 *
+	 * @code
+	 * awl::TaskGraph graph;
+	 * awl::TaskGraph::Node load = graph.AddNode(boost::bind(Load, _1));
+	 * awl::TaskGraph::Node parse = graph.AddNode(boost::bind(Parse, _1));
+	 * awl::TaskGraph::Node index = graph.AddNode(boost::bind(Index, _1));
+	 * graph.AddEdge(load, parse);
+	 * graph.AddEdge(load, index);
+	 * graph.Run(pool);
+	 * graph.Wait();
+	 * @endcode
+	 */
+	class Awl_Api TaskGraph : boost::noncopyable {
+		friend class priv::GraphTask;
+	public:
+		/** Identifies a node of the graph
+		 */
+		typedef size_t Node;
+		
+		/** @brief Creates an empty graph
+		 */
+		TaskGraph(void);
+		
+		/** @brief Waits for the graph to complete if it is running
+		 */
+		~TaskGraph(void);
+		
+		/** @brief Adds a node to the graph
+		 *
+		 * @param f The function that represents the node. It must have the
+		 * following signature: void function(awl::Task *self)
+		 * @return The new node
+		 */
+		Node AddNode(Callback f);
+		
+		/** @brief Makes @a successor wait for @a predecessor to complete
+		 *
+		 * @details The graph must not contain any cycle.
+		 */
+		void AddEdge(Node predecessor, Node successor);
+		
+		/** @brief Returns the number of nodes of the graph
+		 */
+		size_t GetNodeCount(void) const;
+		
+		/** @brief Schedules the nodes without predecessor on the given
+		 * @a pool, the other ones follow as their dependencies complete
+		 *
+		 * @details The graph can be run again once it has completed. It must
+		 * not be modified while running. Modifying a graph makes its next run
+		 * build new Task objects.
+		 *
+		 * @return false if the graph is already running or contains a cycle,
+		 * true otherwise
+		 */
+		bool Run(ThreadPool& pool);
+		
+		/** @brief Same as Run(ThreadPool&) on the default ThreadPool
+		 */
+		bool Run(void);
+		
+		/** @brief Returns whether some nodes of the last run have not
+		 * completed yet
+		 */
+		bool IsRunning(void) const;
+		
+		/** @brief Waits until all the nodes of the last run have completed
+		 *
+		 * @details If called from a WorkerThread, pending tasks are executed
+		 * in the meantime, see Latch::Wait().
+		 */
+		void Wait(void);
+		
+	private:
+		struct NodeData {
+			Callback callback;
+			std::vector<Node> successors;
+			size_t predecessorCount;
+			TaskRef task;
+			std::vector<TaskRef> readySuccessors;
+		};
+		
+		bool HasCycle(void) const;
+		void Build(void);
+		void ExecuteNode(Node node, Task *self);
+		void CompleteNode(Node node);
+		
+		std::vector<NodeData> m_nodes;
+		std::vector<TaskRef> m_roots;
+		std::atomic<size_t> *m_remainingPredecessors;
+		bool m_isBuilt;
+		ThreadPool *m_pool;
+		Latch m_done;
+	};
+	
+} // namespace awl
+
+#endif // Awl_TaskGraph_hpp
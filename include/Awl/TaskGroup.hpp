@@ -0,0 +1,113 @@
+
+/*
+ *  TaskGroup.hpp
+ *  Awl - Asynchronous Work Library
+ *
+ *  Copyright (c) 2011 Lucas Soltic
+ *  ceylow@gmail.com
+ *
+ *  This software is provided 'as-is', without any express or implied warranty.
+ *  In no event will the authors be held liable for any damages arising from
+ *  the use of this software.
+ *
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute it freely,
+ *  subject to the following restrictions:
+ *
+ *  1. The origin of this software must not be misrepresented;
+ *     you must not claim that you wrote the original software.
+ *     If you use this software in a product, an acknowledgment
+ *     in the product documentation would be appreciated but is not required.
+ *
+ *  2. Altered source versions must be plainly marked as such,
+ *     and must not be misrepresented as being the original software.
+ *
+ *  3. This notice may not be removed or altered from any source distribution.
+ *
+ */
+#ifndef Awl_TaskGroup_hpp
+#define Awl_TaskGroup_hpp
+
+#include <atomic>
+#include <Awl/Config.hpp>
+#include <Awl/Latch.hpp>
+#include <Awl/Task.hpp>
+#include <Awl/boost/noncopyable.hpp>
+
+namespace awl {
+	
+	/** @file TaskGroup.hpp Awl/TaskGroup.hpp
+	 */
+	
+	class ThreadPool;
+	
+	/** @brief Defines a set of tasks that can be waited for as a whole
+	 *
+	 * @details Tasks spawned in a group may spawn more tasks in the same
+	 * group. Wait() returns once all of them are over, and never blocks a
+	 * WorkerThread: the worker executes pending tasks meanwhile, thus
+	 * groups can be nested deeper than the number of workers.
+	 *
+	 * @code
+	 * void Sort(awl::Task *self, Item *begin, Item *end)
+	 * {
+	 *		Item *middle = Partition(begin, end);
+	 *		awl::TaskGroup group;
+	 *		group.Spawn(boost::bind(Sort, _1, begin, middle));
+	 *		Sort(self, middle, end);
+	 *		group.Wait();
+	 * }
+	 * @endcode
+	 */
+	class Awl_Api TaskGroup : boost::noncopyable {
+	public:
+		/** @brief Creates a group whose tasks run on the default ThreadPool
+		 */
+		TaskGroup(void);
+		
+		/** @brief Creates a group whose tasks run on the given @a pool
+		 */
+		explicit TaskGroup(ThreadPool& pool);
+		
+		/** @brief Waits for the tasks of the group
+		 */
+		~TaskGroup(void);
+		
+		/** @brief Schedules a new task in the group
+		 *
+		 * @details Must be called by the owner of the group or by its tasks,
+		 * not by unrelated threads while the owner waits.
+		 *
+		 * @param f The function that represents the task. It must have the
+		 * following signature: void function(awl::Task *self)
+		 * @return The new Task
+		 */
+		TaskRef Spawn(Callback f);
+		
+		/** @brief Cancels the group
+		 *
+		 * @details The tasks of the group that have not started yet are
+		 * skipped. Running tasks can check IsCancelled() to stop early.
+		 */
+		void Cancel(void);
+		
+		/** @brief Returns whether the group has been cancelled
+		 */
+		bool IsCancelled(void) const;
+		
+		/** @brief Waits until all the tasks of the group are over
+		 *
+		 * @details If called from a WorkerThread, pending tasks are executed
+		 * in the meantime, see Latch::Wait().
+		 */
+		void Wait(void);
+		
+	private:
+		ThreadPool& m_pool;
+		Latch m_pending;
+		std::atomic<bool> m_isCancelled;
+	};
+	
+} // namespace awl
+
+#endif // Awl_TaskGroup_hpp
@@ -38,6 +38,7 @@
 #include <Awl/Config.hpp>
 #include <Awl/boost/noncopyable.hpp>
 #include <cstdlib>
+#include <vector>
 
 
 namespace awl
@@ -54,7 +55,6 @@ namespace priv
 ////////////////////////////////////////////////////////////
 class Awl_Api Thread : boost::noncopyable
 {
-	friend class ThreadPool;
 public :
 
 	/** @brief Returns the OS-specific thread identifier
@@ -67,6 +67,17 @@ public :
 	 */
 	static Uint64 GetMainThreadId(void);
 	
+	/** @brief Restricts the calling thread to the given processors
+	 *
+	 * @details Only supported on Linux and Windows (where only the
+	 * first 64 processors can be used).
+	 *
+	 * @param cpus The indices of the processors the thread may run on,
+	 * a single index pins the thread to that processor
+	 * @return true if the affinity has been changed, false otherwise
+	 */
+	static bool SetCurrentThreadAffinity(const std::vector<unsigned>& cpus);
+	
     ////////////////////////////////////////////////////////////
     /// \brief Construct the thread from a functor with no argument
     ///
@@ -200,8 +211,6 @@ private :
     ///
     ////////////////////////////////////////////////////////////
     void Run();
-	
-	static void RegisterMainThread(void);
 
     ////////////////////////////////////////////////////////////
     // Member data
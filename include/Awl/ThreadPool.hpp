@@ -29,59 +29,269 @@
 #ifndef Awl_ThreadPool_hpp
 #define Awl_ThreadPool_hpp
 
-#include <queue>
-#include <set>
+#include <vector>
+#include <atomic>
 #include <Awl/Condition.hpp>
+#include <Awl/Mutex.hpp>
 #include <Awl/Task.hpp>
+#include <Awl/PoolSettings.hpp>
+#include <Awl/boost/noncopyable.hpp>
 
 namespace awl {
 	
 	/** @file ThreadPool.hpp Awl/ThreadPool.hpp
 	 */
 	
-	class ThreadPoolConstructor;
+	namespace priv {
+		class WorkQueue;
+		class SpawnDeque;
+		class PendingQueue;
+		class InjectionQueue;
+		class EventCount;
+		class FiberScheduler;
+	}
 	
 	/** @brief Defines a manager for the different threads that will execute
 	 * the asynchronous Tasks.
+	 *
+	 * @details Most of the time the Default() pool is enough, but independent
+	 * pools can be created, for example to isolate latency-sensitive work
+	 * from batch work.
+	 *
+	 * Each WorkerThread owns a local task queue. Tasks scheduled
+	 * from a WorkerThread (ie. spawned from another Task) are pushed to the
+	 * local queue of that worker, which executes its most recent tasks first.
+	 * Idle workers steal the oldest tasks of the other workers. Tasks scheduled
+	 * from any other thread go through a shared queue, lock-free as long
+	 * as it's not full. Submitters only wake up a worker when one is idle.
+	 *
+	 * With DeadlineScheduling (see PoolSettings), all the tasks go through
+	 * the shared queue, which starts the earliest deadline first.
+	 *
+	 * NUMA-aware pools have one more queue per node, for the tasks with a
+	 * node hint. Workers only take tasks from the queues of another node when
+	 * there is nothing left to do on their own node.
 	 */
-	class Awl_Api ThreadPool {
+	class Awl_Api ThreadPool : boost::noncopyable {
+		friend class ForkJoin;
+		friend class Latch;
+		friend class Task;
 		friend class WorkerThread;
-		friend class ThreadPoolConstructor;
+		friend class priv::FiberScheduler;
 	public:
-		/** Returns the ThreadPool instance
+		/** @brief Creates a pool and launches its worker threads
 		 *
-		 * @return The ThreadPool instance
+		 * @param workerCount The number of worker threads, or 0 to use
+		 * one worker per processor the process may run on
 		 */
-		static ThreadPool& Default();
+		explicit ThreadPool(unsigned workerCount = 0);
+		
+		/** @brief Creates a pool from the given @a settings and launches
+		 * its initial worker threads
+		 *
+		 * @param settings The parameters of the pool, see PoolSettings
+		 */
+		explicit ThreadPool(const PoolSettings& settings);
 		
-		/** @brief Waits for all the tasks to complete
+		/** @brief Waits for all the tasks of the pool to complete
 		 * and releases the worker threads
 		 */
+		~ThreadPool(void);
+		
+		/** Returns the default ThreadPool instance, used by AsyncCall()
+		 * and the AwlAsync* macros when no pool is given
+		 *
+		 * @details The default pool has one worker per processor the process may run on
+		 * and is created on first use.
+		 *
+		 * @return The default ThreadPool instance
+		 */
+		static ThreadPool& Default();
+		
+		/** @brief Waits for all the tasks of the default pool to complete
+		 * and releases its worker threads
+		 */
 		static void WaitAndDie(void);
 		
+		/** @brief Returns the number of worker threads currently running
+		 * in this pool
+		 */
+		unsigned GetWorkerCount(void) const;
+		
+		/** @brief Returns the settings this pool has been created with
+		 */
+		const PoolSettings& GetSettings(void) const;
+		
+		/** @brief Returns the number of completed tasks that had a deadline
+		 */
+		Uint64 GetDeadlineTaskCount(void) const;
+		
+		/** @brief Returns the number of tasks that have been completed
+		 * after their deadline
+		 */
+		Uint64 GetDeadlineMissCount(void) const;
+		
+		/** @brief Returns the number of NUMA nodes known by this pool,
+		 * valid node hints are lower than this number
+		 *
+		 * @return The number of nodes, 0 if the pool is not NUMA-aware
+		 */
+		unsigned GetNodeCount(void) const;
+		
 		/** Registers a Task to be executed by one of the thread pool's threads
 		 *
 		 * @param t The Task to register
 		 */
 		void ScheduleTaskForExecution(TaskRef t);
 		
+		/** Registers a Task to be executed by one of the thread pool's threads
+		 * in the given priority band
+		 *
+		 * @details Tasks of a higher band are always started first. Normal
+		 * priority tasks scheduled from a WorkerThread are kept local to that
+		 * worker, other tasks go through the shared queue of the pool.
+		 *
+		 * @param t The Task to register
+		 * @param priority The priority band of the Task
+		 */
+		void ScheduleTaskForExecution(TaskRef t, Priority priority);
+		
+		/** Registers several Tasks at once
+		 *
+		 * @details Cheaper than registering the Tasks one by one: the shared
+		 * queue is locked at most once and at most one worker is woken up
+		 * directly, the other ones being woken up in cascade.
+		 *
+		 * @param begin Iterator to the first TaskRef to register
+		 * @param end Iterator past the last TaskRef to register
+		 * @param priority The priority band of the Tasks
+		 */
+		template <typename Iterator>
+		void ScheduleTasks(Iterator begin, Iterator end, Priority priority = NormalPriority);
+		
+		/** Registers several Tasks at once
+		 *
+		 * @param tasks The Tasks to register
+		 * @param priority The priority band of the Tasks
+		 */
+		void ScheduleTasks(const std::vector<TaskRef>& tasks, Priority priority = NormalPriority);
+		
+		/** @brief Executes one of the queued tasks on the calling thread
+		 *
+		 * @details Lets a Task that waits for other tasks help them complete
+		 * rather than block its worker. Does nothing if the calling thread is
+		 * not a worker of this pool.
+		 *
+		 * @return true if a task has been executed, false otherwise
+		 */
+		bool ExecutePendingTask(void);
+		
+		/** @brief Returns whether scheduling more tasks from the calling
+		 * thread would likely keep more workers busy
+		 *
+		 * @details This is the case when some workers are idle, or when the
+		 * calling worker's local queue has been emptied by the other workers.
+		 * Used to split work lazily, see ParallelFor().
+		 */
+		bool NeedsMoreTasks(void) const;
+		
+		/** @brief Replaces @a worker and terminates its thread
+		 *
+		 * @details Only meant for Task::Abort(), once it has made sure that
+		 * @a worker is still running the aborted Task.
+		 */
 		void KillWorkerThread(WorkerThread *worker);
 		
-		// Not to be used but public for private convenience
-		ThreadPool(int, int , int);
-		~ThreadPool(void);
 	private:
+		// Where a scheduled task goes
+		enum Route {
+			NodeRoute,		// The queue of its NUMA node
+			LocalRoute,		// The local queue of the scheduling worker
+			SharedRoute		// The shared queue
+		};
+		
+		// Pops between two aging checks while the local queue has tasks
+		enum { AgingCheckInterval = 64 };
+		
 		void Init(void);
+		Route GetRoute(const Task& t, WorkerThread *worker) const;
+		bool WaitForTask(WorkerThread& worker, TaskRef& t);
+		bool TryGetTask(WorkerThread& worker, TaskRef& t);
+		bool PopPendingTask(TaskRef& t, Priority lowest);
+		void AgePendingTasks(void);
+		bool InjectPendingTask(TaskRef& t, Priority priority);
+		void PushPendingTask(TaskRef t, Priority priority);
+		void RefillLocalQueue(WorkerThread& worker);
+		bool StealTask(WorkerThread& thief, TaskRef& t);
+		bool StealFrame(WorkerThread& thief);
+		bool HasStealableFrames(const WorkerThread& thief) const;
+		void FrameSpawned(void);
+		bool WaitForPendingTask(WorkerThread& worker, Uint32 timeout = 0);
+		bool SpinForPendingTask(WorkerThread& worker);
 		
-		bool HasPendingTask_unprotected(void);
-		bool WaitForTask(TaskRef& t);
+		/** @brief Executes pending tasks until @a isDone returns true for
+		 * @a object, parking the worker while there is nothing to execute
+		 *
+		 * @details The thread that makes @a isDone return true must then
+		 * call WakeHelpers() for the parked worker to notice it.
+		 */
+		void HelpUntil(WorkerThread& worker, bool (*isDone)(const void *), const void *object);
+		void WakeHelpers(void);
+		void WakeUpWorker(void);
+		void TaskDone(void);
+		void CheckDeadline(const Task& t);
+		void ApplyAffinity(unsigned workerIndex);
+		int GetWorkerNode(unsigned workerIndex) const;
+		bool IsValidNode(int node) const;
 		void DoWaitAndDie(void);
 		
-		std::queue<TaskRef> m_pendingTasks;
-		Condition m_hasPendingTask;
-		std::set<WorkerThread *> m_threads;
+		bool ShouldSpawnWorker(void) const;
+		bool HasStalledTasks(void);
+		void SpawnWorker(void);
+		bool RetireWorker(WorkerThread& worker);
+		static void ReleaseWorkers(const std::vector<WorkerThread *>& workers);
+		
+		PoolSettings m_settings;
+		std::vector<unsigned> m_workerCpus;
+		
+		// Processors of each NUMA node, the nodes having processors and
+		// the queues of the tasks hinted to each node
+		std::vector<std::vector<unsigned> > m_nodeCpus;
+		std::vector<unsigned> m_workerNodes;
+		std::vector<priv::WorkQueue *> m_nodeQueues;
+		priv::InjectionQueue *m_injectedTasks[PriorityLevels];
+		priv::PendingQueue *m_pendingTasks[PriorityLevels];
+		Mutex m_pendingMutex;
+		priv::EventCount *m_workAvailable;
+		std::atomic<Uint64> m_nextAgingTime;
+		
+		// One slot per potential worker, NULL when the slot is free.
+		// The local queues are never reallocated so that they can be
+		// browsed without lock when stealing
+		Mutex m_workersMutex;
+		std::vector<WorkerThread *> m_workers;
+		std::vector<WorkerThread *> m_retiredWorkers;
+		std::vector<priv::WorkQueue *> m_localQueues;
+		std::vector<priv::SpawnDeque *> m_spawnDeques;
+		std::atomic<int> m_workerCount;
+		std::atomic<bool> m_isSpawningWorker;
+		std::atomic<bool> m_isDying;
+		
+		// Tasks waiting in each band of the locked shared queue
+		std::atomic<int> m_pendingTaskCount[PriorityLevels];
+		// Tasks waiting in any of the queues
+		std::atomic<int> m_queuedTaskCount;
+		// Tasks scheduled but not completed yet
+		std::atomic<int> m_unfinishedTaskCount;
+		std::atomic<int> m_idleWorkerCount;
+		std::atomic<Uint64> m_deadlineTaskCount;
+		std::atomic<Uint64> m_deadlineMissCount;
+		Condition m_allTasksDone;
+		bool m_isAlive;
 	};
 	
+#include <Awl/ThreadPool.inl>
+	
 } // namespace awl
 
 #endif
@@ -0,0 +1,61 @@
+
+/*
+ *  Time.hpp
+ *  Awl - Asynchronous Work Library
+ *
+ *  Copyright (c) 2011 Lucas Soltic
+ *  ceylow@gmail.com
+ *
+ *  This software is provided 'as-is', without any express or implied warranty.
+ *  In no event will the authors be held liable for any damages arising from
+ *  the use of this software.
+ *
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute it freely,
+ *  subject to the following restrictions:
+ *
+ *  1. The origin of this software must not be misrepresented;
+ *     you must not claim that you wrote the original software.
+ *     If you use this software in a product, an acknowledgment
+ *     in the product documentation would be appreciated but is not required.
+ *
+ *  2. Altered source versions must be plainly marked as such,
+ *     and must not be misrepresented as being the original software.
+ *
+ *  3. This notice may not be removed or altered from any source distribution.
+ *
+ */
+
+#ifndef Awl_Time_hpp
+#define Awl_Time_hpp
+
+#include <Awl/Config.hpp>
+
+namespace awl {
+	
+	/** @file Time.hpp Awl/Time.hpp
+	 */
+	
+	/** @brief Returns the current system time
+	 *
+	 * @details This is the wall clock, which may jump backwards or
+	 * forwards when the system time is changed. Use GetMonotonicTime()
+	 * to measure durations.
+	 *
+	 * @return The system time, in milliseconds
+	 */
+	Uint64 Awl_Api GetSystemTime(void);
+	
+	/** @brief Returns the time elapsed since an unspecified point
+	 *
+	 * @details This is the clock used for Task deadlines and timers. It is
+	 * not affected by changes of the system time, and only differences
+	 * between two values are meaningful.
+	 *
+	 * @return The monotonic time, in milliseconds
+	 */
+	Uint64 Awl_Api GetMonotonicTime(void);
+	
+} // namespace awl
+
+#endif // Awl_Time_hpp
@@ -0,0 +1,113 @@
+
+/*
+ *  Timer.hpp
+ *  Awl - Asynchronous Work Library
+ *
+ *  Copyright (c) 2011 Lucas Soltic
+ *  ceylow@gmail.com
+ *
+ *  This software is provided 'as-is', without any express or implied warranty.
+ *  In no event will the authors be held liable for any damages arising from
+ *  the use of this software.
+ *
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute it freely,
+ *  subject to the following restrictions:
+ *
+ *  1. The origin of this software must not be misrepresented;
+ *     you must not claim that you wrote the original software.
+ *     If you use this software in a product, an acknowledgment
+ *     in the product documentation would be appreciated but is not required.
+ *
+ *  2. Altered source versions must be plainly marked as such,
+ *     and must not be misrepresented as being the original software.
+ *
+ *  3. This notice may not be removed or altered from any source distribution.
+ *
+ */
+#ifndef Awl_Timer_hpp
+#define Awl_Timer_hpp
+
+#include <Awl/Config.hpp>
+#include <Awl/Task.hpp>
+#include <Awl/ThreadPool.hpp>
+#include <Awl/Types.hpp>
+
+/** @file Timer.hpp Awl/Timer.hpp
+ * @brief Contains the functions to call callbacks after a delay, at a given
+ * time or periodically
+ *
+ * @details Timers are kept in a hierarchical timing wheel driven by a single
+ * timer thread, with a resolution of a millisecond. Once due, the Task is
+ * scheduled on its ThreadPool like any other Task. Cancelling the returned
+ * Task with Task::Cancel() removes the timer in constant time and completes
+ * the Task without calling its callback.
+ */
+
+namespace awl {
+	
+	/** @brief Call the given callback once @a delay has elapsed
+	 *
+	 * @param f the function or method that represents the task
+	 * with the following signature: void function(awl::Task *self)
+	 * @param delay the time to wait before scheduling the task, in milliseconds
+	 * @return The associated Task object
+	 */
+	TaskRef Awl_Api AsyncCallAfter(Uint32 delay, Callback f);
+	
+	/** @brief Call the given callback on the given ThreadPool once @a delay
+	 * has elapsed
+	 *
+	 * @param pool the ThreadPool that should execute the task
+	 * @param delay the time to wait before scheduling the task, in milliseconds
+	 * @param f the function or method that represents the task
+	 * with the following signature: void function(awl::Task *self)
+	 * @return The associated Task object
+	 */
+	TaskRef Awl_Api AsyncCallAfter(ThreadPool& pool, Uint32 delay, Callback f);
+	
+	/** @brief Call the given callback at the given @a time
+	 *
+	 * @param time the time at which the task should be scheduled,
+	 * in milliseconds as returned by GetMonotonicTime(). A time that is already
+	 * past schedules the task right away
+	 * @param f the function or method that represents the task
+	 * with the following signature: void function(awl::Task *self)
+	 * @return The associated Task object
+	 */
+	TaskRef Awl_Api AsyncCallAt(Uint64 time, Callback f);
+	
+	/** @brief Call the given callback on the given ThreadPool at the
+	 * given @a time
+	 *
+	 * @see AsyncCallAt(Uint64, Callback)
+	 */
+	TaskRef Awl_Api AsyncCallAt(ThreadPool& pool, Uint64 time, Callback f);
+	
+	/** @brief Call the given callback every @a period milliseconds, until
+	 * the returned Task is cancelled
+	 *
+	 * @details Calls are planned on a fixed rate, starting @a period
+	 * milliseconds from now: a late call doesn't delay the next ones, and
+	 * the calls that are missed altogether (because the previous one is
+	 * still running for instance) are skipped rather than piled up. Calls
+	 * never overlap. @a self is the returned Task, which only completes once
+	 * cancelled.
+	 *
+	 * @param period the time between two calls, in milliseconds
+	 * @param f the function or method that represents the task
+	 * with the following signature: void function(awl::Task *self)
+	 * @return The Task object associated to the series of calls
+	 */
+	TaskRef Awl_Api AsyncCallEvery(Uint32 period, Callback f);
+	
+	/** @brief Call the given callback on the given ThreadPool every
+	 * @a period milliseconds, until the returned Task is cancelled
+	 *
+	 * @see AsyncCallEvery(Uint32, Callback)
+	 */
+	TaskRef Awl_Api AsyncCallEvery(ThreadPool& pool, Uint32 period, Callback f);
+	
+} // namespace awl
+
+#endif // Awl_Timer_hpp
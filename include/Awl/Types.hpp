@@ -29,16 +29,27 @@
 #ifndef Awl_Types_hpp
 #define Awl_Types_hpp
 
-#include <Awl/boost/function.hpp>
+#include <Awl/Function.hpp>
 #include <Awl/boost/noncopyable.hpp>
 
 namespace awl {
 	class Task;
 	
 	/** Defines a simple callback to a function defined as follow : void f(Task* self)
-	 * where @a self is the parent Task
+	 * where @a self is the parent Task. It is move-only, see Function
 	 */
-	typedef boost::function <void (Task*)> Callback;
+	typedef Function<void (Task*)> Callback;
+	
+	/** Defines the priority bands of the Tasks executed by a ThreadPool.
+	 * Higher bands are always drained first.
+	 */
+	enum Priority {
+		HighPriority,		///< Interactive work that should start as soon as possible
+		NormalPriority,		///< Default priority
+		LowPriority,		///< Background work
+		
+		PriorityLevels		///< Number of priority bands
+	};
 
 } // namespace awl
 
@@ -0,0 +1,114 @@
+
+/*
+ *  When.hpp
+ *  Awl - Asynchronous Work Library
+ *
+ *  Copyright (c) 2011 Lucas Soltic
+ *  ceylow@gmail.com
+ *
+ *  This software is provided 'as-is', without any express or implied warranty.
+ *  In no event will the authors be held liable for any damages arising from
+ *  the use of this software.
+ *
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute it freely,
+ *  subject to the following restrictions:
+ *
+ *  1. The origin of this software must not be misrepresented;
+ *     you must not claim that you wrote the original software.
+ *     If you use this software in a product, an acknowledgment
+ *     in the product documentation would be appreciated but is not required.
+ *
+ *  2. Altered source versions must be plainly marked as such,
+ *     and must not be misrepresented as being the original software.
+ *
+ *  3. This notice may not be removed or altered from any source distribution.
+ *
+ */
+#ifndef Awl_When_hpp
+#define Awl_When_hpp
+
+#include <vector>
+#include <Awl/Config.hpp>
+#include <Awl/Future.hpp>
+#include <Awl/Task.hpp>
+
+namespace awl {
+	
+	/** @file When.hpp Awl/When.hpp
+	 *
+	 * @brief Contains the functions that wait for a whole set of tasks.
+	 *
+	 * @details Each of these functions hooks a single shared counter to the
+	 * end of the given tasks. The waiting thread, or the continuation, is
+	 * woken up once, whatever the number of tasks, which is much cheaper
+	 * than calling Task::Wait() on each of them.
+	 */
+	
+	/** @brief Returns a Future that is ready once all the given @a tasks
+	 * are over
+	 *
+	 * @details Continuations bound to the returned Future are scheduled on
+	 * the ThreadPool of the worker that completes the last Task.
+	 * Cancelled tasks count as over once they have been skipped, and so do
+	 * tasks destroyed without ever running.
+	 *
+	 * @param tasks The tasks to wait for
+	 * @return A Future that never holds an error
+	 */
+	Future<void> Awl_Api WhenAll(const std::vector<TaskRef>& tasks);
+	
+	/** @brief Returns a Future that is ready once any of the given @a tasks
+	 * is over
+	 *
+	 * @param tasks The tasks to wait for
+	 * @return The Future of the index of the first Task that completed,
+	 * or 0 if @a tasks is empty
+	 */
+	Future<size_t> Awl_Api WhenAny(const std::vector<TaskRef>& tasks);
+	
+	/** @brief Waits until all the given @a tasks are over
+	 *
+	 * @details If called from a WorkerThread, pending tasks are executed
+	 * in the meantime, see Latch::Wait().
+	 *
+	 * @param tasks The tasks to wait for
+	 */
+	void Awl_Api WaitForAll(const std::vector<TaskRef>& tasks);
+	
+	/** @brief Waits until any of the given @a tasks is over
+	 *
+	 * @details If called from a WorkerThread, pending tasks are executed
+	 * in the meantime, see Latch::Wait().
+	 *
+	 * @param tasks The tasks to wait for
+	 * @return The index of the first Task that completed, or 0 if @a tasks
+	 * is empty
+	 */
+	size_t Awl_Api WaitForAny(const std::vector<TaskRef>& tasks);
+	
+	/** @brief Same as WhenAll(const std::vector<TaskRef>&) for futures
+	 */
+	template <typename T>
+	Future<void> WhenAll(const std::vector<Future<T> >& futures);
+	
+	/** @brief Same as WhenAny(const std::vector<TaskRef>&) for futures
+	 */
+	template <typename T>
+	Future<size_t> WhenAny(const std::vector<Future<T> >& futures);
+	
+	/** @brief Same as WaitForAll(const std::vector<TaskRef>&) for futures
+	 */
+	template <typename T>
+	void WaitForAll(const std::vector<Future<T> >& futures);
+	
+	/** @brief Same as WaitForAny(const std::vector<TaskRef>&) for futures
+	 */
+	template <typename T>
+	size_t WaitForAny(const std::vector<Future<T> >& futures);
+	
+#include <Awl/When.inl>
+	
+} // namespace awl
+
+#endif // Awl_When_hpp
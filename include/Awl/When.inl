@@ -0,0 +1,66 @@
+
+/*
+ *  When.inl
+ *  Awl - Asynchronous Work Library
+ *
+ *  Copyright (c) 2011 Lucas Soltic
+ *  ceylow@gmail.com
+ *
+ *  This software is provided 'as-is', without any express or implied warranty.
+ *  In no event will the authors be held liable for any damages arising from
+ *  the use of this software.
+ *
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute it freely,
+ *  subject to the following restrictions:
+ *
+ *  1. The origin of this software must not be misrepresented;
+ *     you must not claim that you wrote the original software.
+ *     If you use this software in a product, an acknowledgment
+ *     in the product documentation would be appreciated but is not required.
+ *
+ *  2. Altered source versions must be plainly marked as such,
+ *     and must not be misrepresented as being the original software.
+ *
+ *  3. This notice may not be removed or altered from any source distribution.
+ *
+ */
+namespace priv {
+	
+	template <typename T>
+	std::vector<TaskRef> GetTasks(const std::vector<Future<T> >& futures)
+	{
+		std::vector<TaskRef> tasks;
+		tasks.reserve(futures.size());
+		
+		for (size_t i = 0; i < futures.size(); i++)
+			tasks.push_back(futures[i].GetTask());
+		
+		return tasks;
+	}
+	
+} // namespace priv
+
+template <typename T>
+Future<void> WhenAll(const std::vector<Future<T> >& futures)
+{
+	return WhenAll(priv::GetTasks(futures));
+}
+
+template <typename T>
+Future<size_t> WhenAny(const std::vector<Future<T> >& futures)
+{
+	return WhenAny(priv::GetTasks(futures));
+}
+
+template <typename T>
+void WaitForAll(const std::vector<Future<T> >& futures)
+{
+	WaitForAll(priv::GetTasks(futures));
+}
+
+template <typename T>
+size_t WaitForAny(const std::vector<Future<T> >& futures)
+{
+	return WaitForAny(priv::GetTasks(futures));
+}
@@ -31,17 +31,30 @@
 
 #include <Awl/Config.hpp>
 #include <Awl/Thread.hpp>
+#include <Awl/Task.hpp>
+#include <vector>
 
 namespace awl {
 	
 	/** @file WorkerThread.hpp Awl/WorkerThread.hpp
 	 */
 	
+	namespace priv {
+		class FiberScheduler;
+		class SpawnArena;
+		class SpawnDeque;
+		class WorkQueue;
+	}
+	
+	class ThreadPool;
+	
 	/** @brief Defines a thread that will grab the tasks from the ThreadPool
 	 * and execute it asynchronously.
 	 */
 	class Awl_Api WorkerThread {
+		friend class ForkJoin;
 		friend class ThreadPool;
+		friend class priv::FiberScheduler;
 	public:
 		
 		/** Returns the id of the WorkerThread according to a global thread id
@@ -57,13 +70,40 @@ namespace awl {
 		 * @a globalThreadId otherwise
 		 */
 		static Uint64 LocalThreadId(Uint64 globalThreadId, bool& isWorkerThread);
+		
+		/** Returns the WorkerThread that runs the calling thread
+		 *
+		 * @return The current WorkerThread, or NULL if the calling thread
+		 * is not a WorkerThread
+		 */
+		static WorkerThread *Current(void);
+		
+		/** Returns the ThreadPool this WorkerThread belongs to
+		 */
+		ThreadPool& GetPool(void) const;
+		
+		/** Returns the NUMA node this WorkerThread runs on, or -1 if its
+		 * ThreadPool is not NUMA-aware
+		 */
+		int GetNode(void) const;
 	private:
-		WorkerThread();
+		WorkerThread(ThreadPool& pool, priv::WorkQueue& queue, priv::SpawnDeque& frames, unsigned index);
 		~WorkerThread();
 		void ThreadCallback(void);
+		void Execute(TaskRef& t);
 		void Die(void);
 		
 		Thread m_thread;
+		ThreadPool& m_pool;
+		priv::WorkQueue& m_queue;
+		priv::SpawnDeque& m_frames;
+		priv::SpawnArena *m_arena;
+		unsigned m_index;
+		int m_node;
+		unsigned m_spinLimit;
+		unsigned m_popCount;
+		std::vector<TaskRef> m_refillBatch;
+		Uint64 m_threadId; // Key of the worker in the thread table
 	};
 	
 } // namespace awl
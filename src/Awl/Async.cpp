@@ -32,9 +32,49 @@ namespace awl {
 	
 	TaskRef AsyncCall(Callback f)
 	{
-		TaskRef t(new Task(f));
-		ThreadPool::Default().ScheduleTaskForExecution(t);
+		return AsyncCall(ThreadPool::Default(), std::move(f));
+	}
+	
+	TaskRef AsyncCall(ThreadPool& pool, Callback f)
+	{
+		TaskRef t(Task::Create(std::move(f)));
+		pool.ScheduleTaskForExecution(t);
+		return t;
+	}
+	
+	TaskRef AsyncCall(ThreadPool& pool, Callback f, Priority priority)
+	{
+		TaskRef t(Task::Create(std::move(f)));
+		pool.ScheduleTaskForExecution(t, priority);
+		return t;
+	}
+	
+	TaskRef AsyncCallBefore(ThreadPool& pool, Callback f, Uint64 deadline)
+	{
+		TaskRef t(Task::Create(std::move(f)));
+		t->SetDeadline(deadline);
+		pool.ScheduleTaskForExecution(t);
 		return t;
 	}
 	
+	TaskRef AsyncCallOnNode(ThreadPool& pool, Callback f, int node)
+	{
+		TaskRef t(new (node) Task(std::move(f)));
+		t->SetNode(node);
+		pool.ScheduleTaskForExecution(t);
+		return t;
+	}
+	
+	std::vector<TaskRef> AsyncCall(ThreadPool& pool, std::vector<Callback> functions)
+	{
+		std::vector<TaskRef> tasks;
+		tasks.reserve(functions.size());
+		
+		for (size_t i = 0; i < functions.size();i++)
+			tasks.push_back(Task::Create(std::move(functions[i])));
+		
+		pool.ScheduleTasks(tasks);
+		return tasks;
+	}
+	
 } // namespace
@@ -34,10 +34,30 @@
 #include <Awl/Unix/ConditionImpl.hpp>
 #endif
 
+#include <Awl/FiberScheduler.hpp>
+#include <Awl/Platform.hpp>
+
 namespace awl {
 	const bool Condition::AutoUnlock = true;
 	const bool Condition::ManualUnlock = false;
 	
+	// Polls the condition rather than block the worker of a task fiber,
+	// deadline is 0 when there is no timeout
+	static bool FiberWaitAndRetain(priv::ConditionImpl& impl, int awaitedValue, Uint64 deadline)
+	{
+		priv::FiberBackoff backoff;
+		
+		while (!impl.tryRetain(awaitedValue))
+		{
+			if (!impl.isValid() || (deadline && priv::Platform::GetMonotonicTime() >= deadline))
+				return false;
+			
+			backoff.Pause();
+		}
+		
+		return true;
+	}
+	
 	
 	Condition::Condition(int value) :
 	m_impl(NULL)
@@ -52,7 +72,12 @@ namespace awl {
 	
 	bool Condition::WaitAndLock(int awaitedValue, bool autorelease)
 	{
-		bool flag = m_impl->waitAndRetain(awaitedValue);
+		bool flag = false;
+		
+		if (priv::FiberScheduler::IsInFiber())
+			flag = FiberWaitAndRetain(*m_impl, awaitedValue, 0);
+		else
+			flag = m_impl->waitAndRetain(awaitedValue);
 		
 		if (autorelease)
 			m_impl->release(awaitedValue);
@@ -60,6 +85,21 @@ namespace awl {
 		return flag;
 	}
 	
+	bool Condition::TimedWaitAndLock(int awaitedValue, Uint32 timeout, bool autorelease)
+	{
+		bool flag = false;
+		
+		if (priv::FiberScheduler::IsInFiber())
+			flag = FiberWaitAndRetain(*m_impl, awaitedValue, priv::Platform::GetMonotonicTime() + timeout);
+		else
+			flag = m_impl->timedWaitAndRetain(awaitedValue, timeout);
+		
+		if (flag && autorelease)
+			m_impl->release(awaitedValue);
+		
+		return flag;
+	}
+	
 	void Condition::Lock(void)
 	{
 		m_impl->lock();
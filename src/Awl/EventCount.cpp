@@ -0,0 +1,106 @@
+
+/*
+ *  EventCount.cpp
+ *  Awl - Asynchronous Work Library
+ *
+ *  Copyright (c) 2011 Lucas Soltic
+ *  ceylow@gmail.com
+ *
+ *  This software is provided 'as-is', without any express or implied warranty.
+ *  In no event will the authors be held liable for any damages arising from
+ *  the use of this software.
+ *
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute it freely,
+ *  subject to the following restrictions:
+ *
+ *  1. The origin of this software must not be misrepresented;
+ *     you must not claim that you wrote the original software.
+ *     If you use this software in a product, an acknowledgment
+ *     in the product documentation would be appreciated but is not required.
+ *
+ *  2. Altered source versions must be plainly marked as such,
+ *     and must not be misrepresented as being the original software.
+ *
+ *  3. This notice may not be removed or altered from any source distribution.
+ *
+ */
+
+#include <Awl/EventCount.hpp>
+#include <Awl/Platform.hpp>
+
+#if defined(Awl_SystemWindows)
+#include <Awl/Win32/FutexImpl.hpp>
+#else
+#include <Awl/Unix/FutexImpl.hpp>
+#endif
+
+namespace awl {
+	namespace priv {
+		
+		EventCount::EventCount(void) :
+		m_epoch(0),
+		m_waiterCount(0)
+		{
+			
+		}
+		
+		Uint32 EventCount::PrepareWait(void)
+		{
+			m_waiterCount++;
+			return m_epoch.load();
+		}
+		
+		void EventCount::CancelWait(void)
+		{
+			m_waiterCount--;
+		}
+		
+		bool EventCount::Wait(Uint32 key, Uint32 timeout)
+		{
+			Uint64 start = timeout ? Platform::GetMonotonicTime() : 0;
+			bool res = true;
+			
+			// Filter out the spurious wake ups
+			while (m_epoch.load() == key)
+			{
+				Uint32 left = 0;
+				
+				if (timeout)
+				{
+					Uint64 elapsed = Platform::GetMonotonicTime() - start;
+					
+					if (elapsed >= timeout)
+					{
+						res = false;
+						break;
+					}
+					
+					left = timeout - (Uint32)elapsed;
+				}
+				
+				FutexImpl::wait(m_epoch, key, left);
+			}
+			
+			m_waiterCount--;
+			return res;
+		}
+		
+		void EventCount::NotifyOne(void)
+		{
+			m_epoch++;
+			
+			if (m_waiterCount > 0)
+				FutexImpl::wakeOne(m_epoch);
+		}
+		
+		void EventCount::NotifyAll(void)
+		{
+			m_epoch++;
+			
+			if (m_waiterCount > 0)
+				FutexImpl::wakeAll(m_epoch);
+		}
+		
+	} // namespace priv
+} // namespace awl
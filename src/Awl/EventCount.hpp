@@ -0,0 +1,73 @@
+
+/*
+ *  EventCount.hpp
+ *  Awl - Asynchronous Work Library
+ *
+ *  Copyright (c) 2011 Lucas Soltic
+ *  ceylow@gmail.com
+ *
+ *  This software is provided 'as-is', without any express or implied warranty.
+ *  In no event will the authors be held liable for any damages arising from
+ *  the use of this software.
+ *
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute it freely,
+ *  subject to the following restrictions:
+ *
+ *  1. The origin of this software must not be misrepresented;
+ *     you must not claim that you wrote the original software.
+ *     If you use this software in a product, an acknowledgment
+ *     in the product documentation would be appreciated but is not required.
+ *
+ *  2. Altered source versions must be plainly marked as such,
+ *     and must not be misrepresented as being the original software.
+ *
+ *  3. This notice may not be removed or altered from any source distribution.
+ *
+ */
+
+#ifndef Awl_EventCount_hpp
+#define Awl_EventCount_hpp
+
+#include <Awl/Config.hpp>
+#include <Awl/boost/noncopyable.hpp>
+#include <atomic>
+
+namespace awl {
+	namespace priv {
+		
+		/** @brief Lets threads park until some condition, checked without
+		 * any lock, may have changed
+		 *
+		 * @details A waiter calls PrepareWait(), checks its condition once more,
+		 * and then either calls CancelWait() or Wait() with the returned key.
+		 * A notifier first makes the condition true and then calls Notify*():
+		 * either the waiter sees the condition, or Wait() returns immediately.
+		 * Notifying costs a single atomic operation when nobody is waiting.
+		 */
+		class EventCount : boost::noncopyable {
+		public:
+			EventCount(void);
+			
+			Uint32 PrepareWait(void);
+			void CancelWait(void);
+			
+			/** @brief Parks the calling thread until notified, or until
+			 * @a timeout milliseconds have elapsed (0 = no timeout)
+			 *
+			 * @return false on timeout
+			 */
+			bool Wait(Uint32 key, Uint32 timeout = 0);
+			
+			void NotifyOne(void);
+			void NotifyAll(void);
+			
+		private:
+			std::atomic<Uint32> m_epoch;
+			std::atomic<int> m_waiterCount;
+		};
+		
+	} // namespace priv
+} // namespace awl
+
+#endif // Awl_EventCount_hpp
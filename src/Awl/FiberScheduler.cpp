@@ -0,0 +1,244 @@
+
+/*
+ *  FiberScheduler.cpp
+ *  Awl - Asynchronous Work Library
+ *
+ *  Copyright (c) 2011 Lucas Soltic
+ *  ceylow@gmail.com
+ *
+ *  This software is provided 'as-is', without any express or implied warranty.
+ *  In no event will the authors be held liable for any damages arising from
+ *  the use of this software.
+ *
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute it freely,
+ *  subject to the following restrictions:
+ *
+ *  1. The origin of this software must not be misrepresented;
+ *     you must not claim that you wrote the original software.
+ *     If you use this software in a product, an acknowledgment
+ *     in the product documentation would be appreciated but is not required.
+ *
+ *  2. Altered source versions must be plainly marked as such,
+ *     and must not be misrepresented as being the original software.
+ *
+ *  3. This notice may not be removed or altered from any source distribution.
+ *
+ */
+#include <Awl/FiberScheduler.hpp>
+#include <Awl/SpawnArena.hpp>
+#include <Awl/ThreadPool.hpp>
+#include <Awl/WorkerThread.hpp>
+#include <Awl/Platform.hpp>
+#include <algorithm>
+
+#if defined(Awl_SystemWindows)
+#include <Awl/Win32/FiberImpl.hpp>
+#else
+#include <Awl/Unix/FiberImpl.hpp>
+#endif
+
+namespace awl {
+	namespace priv {
+		
+		// Fibers kept for reuse by each worker, the other ones are
+		// released once their task is over
+		static const size_t MaxIdleFibers = 16;
+		
+		// Polls that only let the other fibers run before waiting
+		static const unsigned FastPauseCount = 8;
+		
+		static thread_local FiberScheduler *t_scheduler = NULL;
+		
+		struct FiberScheduler::Fiber {
+			Fiber(FiberScheduler& owner, size_t stackSize) :
+			scheduler(owner),
+			context(stackSize, &FiberScheduler::Entry, this),
+			task(),
+			arena()
+			{
+			}
+			
+			FiberScheduler& scheduler;
+			FiberImpl context;
+			TaskRef task;
+			SpawnArena arena;
+		};
+		
+		FiberScheduler::FiberScheduler(WorkerThread& worker) :
+		m_worker(worker),
+		m_pool(worker.GetPool()),
+		m_context(NULL),
+		m_current(NULL),
+		m_finished(NULL),
+		m_idleFibers(),
+		m_suspendedFibers()
+		{
+		}
+		
+		FiberScheduler::~FiberScheduler(void)
+		{
+			for (size_t i = 0; i < m_idleFibers.size(); i++)
+				delete m_idleFibers[i];
+			
+			delete m_context;
+		}
+		
+		void FiberScheduler::Run(void)
+		{
+			m_context = new FiberImpl();
+			t_scheduler = this;
+			TaskRef t;
+			
+			while (true)
+			{
+				if (m_suspendedFibers.empty())
+				{
+					if (!m_pool.WaitForTask(m_worker, t))
+						break;
+					
+					RunTask(t);
+					continue;
+				}
+				
+				// Alternate between the suspended fibers and the new tasks
+				// so that none of them starves
+				Uint64 nextWakeTime = 0;
+				bool resumed = ResumeReadyFiber(Platform::GetMonotonicTime(), nextWakeTime);
+				
+				if (m_pool.TryGetTask(m_worker, t))
+				{
+					RunTask(t);
+				}
+				else if (!resumed)
+				{
+					// Nothing to do until the next fiber is due, unless
+					// new tasks are scheduled
+					Uint64 now = Platform::GetMonotonicTime();
+					Uint32 timeout = (nextWakeTime > now) ? (Uint32)std::min<Uint64>(nextWakeTime - now, 1000) : 1;
+					
+					if (!m_pool.WaitForPendingTask(m_worker, timeout))
+						break;
+				}
+			}
+			
+			t_scheduler = NULL;
+		}
+		
+		bool FiberScheduler::IsInFiber(void)
+		{
+			return t_scheduler && t_scheduler->m_current;
+		}
+		
+		SpawnArena *FiberScheduler::GetFiberArena(void)
+		{
+			return IsInFiber() ? &t_scheduler->m_current->arena : NULL;
+		}
+		
+		bool FiberScheduler::Suspend(Uint64 wakeTime)
+		{
+			FiberScheduler *scheduler = t_scheduler;
+			
+			if (!scheduler || !scheduler->m_current)
+				return false;
+			
+			Fiber *fiber = scheduler->m_current;
+			Sleeper sleeper = {fiber, wakeTime};
+			scheduler->m_suspendedFibers.push_back(sleeper);
+			fiber->context.switchTo(*scheduler->m_context);
+			return true;
+		}
+		
+		void FiberScheduler::Entry(void *argument)
+		{
+			Fiber *fiber = static_cast<Fiber *>(argument);
+			FiberScheduler& scheduler = fiber->scheduler;
+			
+			// The fiber is reused for the next tasks, thus never returns
+			while (true)
+			{
+				scheduler.m_worker.Execute(fiber->task);
+				scheduler.m_finished = fiber;
+				fiber->context.switchTo(*scheduler.m_context);
+			}
+		}
+		
+		bool FiberScheduler::ResumeReadyFiber(Uint64 now, Uint64& nextWakeTime)
+		{
+			size_t count = m_suspendedFibers.size();
+			nextWakeTime = (Uint64)-1;
+			
+			for (size_t i = 0; i < count; i++)
+			{
+				Sleeper sleeper = m_suspendedFibers.front();
+				m_suspendedFibers.pop_front();
+				
+				if (sleeper.wakeTime <= now)
+				{
+					Resume(sleeper.fiber);
+					return true;
+				}
+				
+				nextWakeTime = std::min(nextWakeTime, sleeper.wakeTime);
+				m_suspendedFibers.push_back(sleeper);
+			}
+			
+			return false;
+		}
+		
+		void FiberScheduler::RunTask(TaskRef& t)
+		{
+			Fiber *fiber = NULL;
+			
+			if (m_idleFibers.empty())
+			{
+				fiber = new Fiber(*this, m_pool.GetSettings().fiberStackSize);
+			}
+			else
+			{
+				fiber = m_idleFibers.back();
+				m_idleFibers.pop_back();
+			}
+			
+			fiber->task.swap(t);
+			Resume(fiber);
+		}
+		
+		void FiberScheduler::Resume(Fiber *fiber)
+		{
+			m_current = fiber;
+			m_context->switchTo(fiber->context);
+			m_current = NULL;
+			
+			// A fiber can't release its own stack
+			if (m_finished)
+			{
+				if (m_idleFibers.size() < MaxIdleFibers)
+					m_idleFibers.push_back(m_finished);
+				else
+					delete m_finished;
+				
+				m_finished = NULL;
+			}
+		}
+		
+		FiberBackoff::FiberBackoff(void) :
+		m_pauseCount(0)
+		{
+		}
+		
+		void FiberBackoff::Pause(void)
+		{
+			if (m_pauseCount < FastPauseCount)
+			{
+				m_pauseCount++;
+				FiberScheduler::Suspend(0);
+			}
+			else
+			{
+				FiberScheduler::Suspend(Platform::GetMonotonicTime() + 1);
+			}
+		}
+		
+	} // namespace priv
+} // namespace awl
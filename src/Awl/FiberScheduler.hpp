@@ -0,0 +1,127 @@
+
+/*
+ *  FiberScheduler.hpp
+ *  Awl - Asynchronous Work Library
+ *
+ *  Copyright (c) 2011 Lucas Soltic
+ *  ceylow@gmail.com
+ *
+ *  This software is provided 'as-is', without any express or implied warranty.
+ *  In no event will the authors be held liable for any damages arising from
+ *  the use of this software.
+ *
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute it freely,
+ *  subject to the following restrictions:
+ *
+ *  1. The origin of this software must not be misrepresented;
+ *     you must not claim that you wrote the original software.
+ *     If you use this software in a product, an acknowledgment
+ *     in the product documentation would be appreciated but is not required.
+ *
+ *  2. Altered source versions must be plainly marked as such,
+ *     and must not be misrepresented as being the original software.
+ *
+ *  3. This notice may not be removed or altered from any source distribution.
+ *
+ */
+#ifndef Awl_FiberScheduler_hpp
+#define Awl_FiberScheduler_hpp
+
+#include <Awl/boost/noncopyable.hpp>
+#include <Awl/Config.hpp>
+#include <Awl/Task.hpp>
+#include <deque>
+#include <vector>
+
+namespace awl {
+	
+	class ThreadPool;
+	class WorkerThread;
+	
+	namespace priv {
+		
+		class FiberImpl;
+		class SpawnArena;
+		
+		/** @brief Runs the tasks of a WorkerThread on fibers, see
+		 * PoolSettings::useFibers
+		 *
+		 * @details Each task gets a fiber from a pool of idle ones. When the
+		 * task blocks in an Awl primitive, its fiber is suspended and the
+		 * worker goes on with the other tasks. Suspended fibers are resumed
+		 * on the same worker, thus thread-local storage stays consistent.
+		 */
+		class FiberScheduler : boost::noncopyable {
+		public:
+			explicit FiberScheduler(WorkerThread& worker);
+			~FiberScheduler(void);
+			
+			/** @brief Executes the tasks of the pool until the worker
+			 * has to stop
+			 */
+			void Run(void);
+			
+			/** @brief Returns whether the calling code runs on a task fiber,
+			 * in which case it may be suspended
+			 */
+			static bool IsInFiber(void);
+			
+			/** @brief Suspends the calling fiber until @a wakeTime (system
+			 * time in milliseconds), or until the other fibers and tasks had
+			 * a chance to run if @a wakeTime has already passed
+			 *
+			 * @return false if the calling code does not run on a task
+			 * fiber, true once resumed
+			 */
+			static bool Suspend(Uint64 wakeTime);
+			
+			/** @brief Returns the spawn arena of the calling task fiber, or
+			 * NULL if the calling code does not run on a task fiber
+			 *
+			 * @details The fibers of a worker interleave their ForkJoin
+			 * scopes, thus each of them needs its own arena.
+			 */
+			static SpawnArena *GetFiberArena(void);
+			
+		private:
+			struct Fiber;
+			
+			struct Sleeper {
+				Fiber *fiber;
+				Uint64 wakeTime;
+			};
+			
+			static void Entry(void *fiber);
+			bool ResumeReadyFiber(Uint64 now, Uint64& nextWakeTime);
+			void RunTask(TaskRef& t);
+			void Resume(Fiber *fiber);
+			
+			WorkerThread& m_worker;
+			ThreadPool& m_pool;
+			FiberImpl *m_context;
+			Fiber *m_current;
+			Fiber *m_finished;
+			std::vector<Fiber *> m_idleFibers;
+			std::deque<Sleeper> m_suspendedFibers;
+		};
+		
+		/** @brief Polls a condition from a task fiber, suspending the fiber
+		 * between two polls
+		 *
+		 * @details The first polls only let the other fibers run, the
+		 * following ones wait for a millisecond.
+		 */
+		class FiberBackoff {
+		public:
+			FiberBackoff(void);
+			void Pause(void);
+			
+		private:
+			unsigned m_pauseCount;
+		};
+		
+	} // namespace priv
+} // namespace awl
+
+#endif // Awl_FiberScheduler_hpp
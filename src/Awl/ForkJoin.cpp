@@ -0,0 +1,171 @@
+
+/*
+ *  ForkJoin.cpp
+ *  Awl - Asynchronous Work Library
+ *
+ *  Copyright (c) 2011 Lucas Soltic
+ *  ceylow@gmail.com
+ *
+ *  This software is provided 'as-is', without any express or implied warranty.
+ *  In no event will the authors be held liable for any damages arising from
+ *  the use of this software.
+ *
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute it freely,
+ *  subject to the following restrictions:
+ *
+ *  1. The origin of this software must not be misrepresented;
+ *     you must not claim that you wrote the original software.
+ *     If you use this software in a product, an acknowledgment
+ *     in the product documentation would be appreciated but is not required.
+ *
+ *  2. Altered source versions must be plainly marked as such,
+ *     and must not be misrepresented as being the original software.
+ *
+ *  3. This notice may not be removed or altered from any source distribution.
+ *
+ */
+#include <Awl/ForkJoin.hpp>
+#include <Awl/ThreadPool.hpp>
+#include <Awl/WorkerThread.hpp>
+#include <Awl/SpawnArena.hpp>
+#include <Awl/SpawnDeque.hpp>
+#include <Awl/FiberScheduler.hpp>
+#include <Awl/boost/bind.hpp>
+
+namespace awl {
+	
+	ForkJoin::ForkJoin(void) :
+	m_worker(WorkerThread::Current()),
+	m_pool(m_worker ? m_worker->GetPool() : ThreadPool::Default())
+	{
+		Open();
+	}
+	
+	ForkJoin::ForkJoin(ThreadPool& pool) :
+	m_worker(WorkerThread::Current()),
+	m_pool(pool)
+	{
+		Open();
+	}
+	
+	ForkJoin::~ForkJoin(void)
+	{
+		Sync();
+	}
+	
+	void ForkJoin::Open(void)
+	{
+		// Frames can only be stolen by the workers of the pool that owns
+		// the deque, other threads go through regular tasks. So do fibers:
+		// the scopes of the fibers of a worker would interleave in its deque
+		if (m_worker && (&m_worker->GetPool() != &m_pool || priv::FiberScheduler::IsInFiber()))
+			m_worker = NULL;
+		
+		if (m_worker)
+		{
+			m_deque = &m_worker->m_frames;
+			m_dequeMark = m_deque->GetBottom();
+			m_arena = m_worker->m_arena;
+		}
+		else
+		{
+			m_deque = NULL;
+			m_dequeMark = 0;
+			m_arena = &priv::SpawnArena::Current();
+		}
+		
+		m_arenaMark = m_arena->GetMark();
+		m_frames = NULL;
+		m_spawnCount = 0;
+		m_inlineCount = 0;
+		m_stolenCount.store(0, std::memory_order_relaxed);
+		m_detached = NULL;
+	}
+	
+	void ForkJoin::Sync(void)
+	{
+		if (m_deque)
+		{
+			// Frames pushed after the mark belong to this scope, those of
+			// the nested scopes are already gone
+			while (m_deque->GetBottom() > m_dequeMark)
+			{
+				priv::SpawnFrame *frame = m_deque->Pop();
+				
+				if (!frame)
+					break;
+				
+				frame->run(frame);
+				m_inlineCount++;
+			}
+			
+			// The remaining ones have been stolen, help while they run and
+			// park when there is nothing to help with: the thieves wake
+			// the helpers up once they are done
+			m_pool.HelpUntil(*m_worker, &ForkJoin::IsSynced, this);
+		}
+		
+		if (m_detached)
+		{
+			m_detached->Wait();
+			delete m_detached;
+			m_detached = NULL;
+		}
+		
+		while (m_frames)
+		{
+			priv::SpawnFrame *next = m_frames->next;
+			m_frames->destroy(m_frames);
+			m_frames = next;
+		}
+		
+		m_spawnCount = 0;
+		m_inlineCount = 0;
+		m_stolenCount.store(0, std::memory_order_relaxed);
+		m_arena->Rewind(m_arenaMark);
+	}
+	
+	bool ForkJoin::IsSynced(const void *scope)
+	{
+		const ForkJoin *self = static_cast<const ForkJoin *>(scope);
+		return self->m_inlineCount + self->m_stolenCount.load(std::memory_order_acquire) == self->m_spawnCount;
+	}
+	
+	void *ForkJoin::AllocateFrame(size_t size)
+	{
+		return m_arena->Allocate(size);
+	}
+	
+	void ForkJoin::Publish(priv::SpawnFrame *frame)
+	{
+		if (m_deque)
+		{
+			if (m_deque->Push(frame))
+			{
+				m_pool.FrameSpawned();
+			}
+			else
+			{
+				// Deque full, there is already enough parallelism
+				frame->run(frame);
+				m_inlineCount++;
+			}
+		}
+		else
+		{
+			if (!m_detached)
+				m_detached = new Latch();
+			
+			m_detached->Add();
+			m_pool.ScheduleTaskForExecution(Task::Create(boost::bind(&ForkJoin::RunDetached, this, frame, _1)));
+		}
+	}
+	
+	void ForkJoin::RunDetached(priv::SpawnFrame *frame, Task *)
+	{
+		frame->run(frame);
+		m_detached->CountDown();
+	}
+	
+} // namespace awl
@@ -0,0 +1,145 @@
+
+/*
+ *  InjectionQueue.cpp
+ *  Awl - Asynchronous Work Library
+ *
+ *  Copyright (c) 2011 Lucas Soltic
+ *  ceylow@gmail.com
+ *
+ *  This software is provided 'as-is', without any express or implied warranty.
+ *  In no event will the authors be held liable for any damages arising from
+ *  the use of this software.
+ *
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute it freely,
+ *  subject to the following restrictions:
+ *
+ *  1. The origin of this software must not be misrepresented;
+ *     you must not claim that you wrote the original software.
+ *     If you use this software in a product, an acknowledgment
+ *     in the product documentation would be appreciated but is not required.
+ *
+ *  2. Altered source versions must be plainly marked as such,
+ *     and must not be misrepresented as being the original software.
+ *
+ *  3. This notice may not be removed or altered from any source distribution.
+ *
+ */
+
+#include <Awl/InjectionQueue.hpp>
+
+namespace awl {
+	namespace priv {
+		
+		InjectionQueue::InjectionQueue(size_t capacity) :
+		m_cells(NULL),
+		m_mask(0)
+		{
+			size_t size = 2;
+			
+			while (size < capacity)
+				size *= 2;
+			
+			m_cells = new Cell[size];
+			m_mask = size - 1;
+			
+			for (size_t i = 0; i < size; i++)
+			{
+				m_cells[i].sequence.store(i, std::memory_order_relaxed);
+				m_cells[i].scheduleTime.store(0, std::memory_order_relaxed);
+			}
+			
+			m_enqueuePos.value.store(0, std::memory_order_relaxed);
+			m_dequeuePos.value.store(0, std::memory_order_relaxed);
+		}
+		
+		InjectionQueue::~InjectionQueue(void)
+		{
+			delete[] m_cells;
+		}
+		
+		bool InjectionQueue::TryPush(TaskRef& t, Uint64 scheduleTime)
+		{
+			size_t pos = m_enqueuePos.value.load(std::memory_order_relaxed);
+			Cell *cell;
+			
+			for (;;)
+			{
+				cell = &m_cells[pos & m_mask];
+				size_t sequence = cell->sequence.load(std::memory_order_acquire);
+				ptrdiff_t diff = (ptrdiff_t)sequence - (ptrdiff_t)pos;
+				
+				if (diff == 0)
+				{
+					// The cell is free for this lap, try to claim it
+					if (m_enqueuePos.value.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+						break;
+				}
+				else if (diff < 0)
+				{
+					// The cell still holds a task from the previous lap
+					return false;
+				}
+				else
+				{
+					pos = m_enqueuePos.value.load(std::memory_order_relaxed);
+				}
+			}
+			
+			cell->task = std::move(t);
+			cell->scheduleTime.store(scheduleTime, std::memory_order_relaxed);
+			cell->sequence.store(pos + 1, std::memory_order_release);
+			return true;
+		}
+		
+		bool InjectionQueue::TryPop(TaskRef& t)
+		{
+			size_t pos = m_dequeuePos.value.load(std::memory_order_relaxed);
+			Cell *cell;
+			
+			for (;;)
+			{
+				cell = &m_cells[pos & m_mask];
+				size_t sequence = cell->sequence.load(std::memory_order_acquire);
+				ptrdiff_t diff = (ptrdiff_t)sequence - (ptrdiff_t)(pos + 1);
+				
+				if (diff == 0)
+				{
+					// The cell has been filled for this lap, try to claim it
+					if (m_dequeuePos.value.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+						break;
+				}
+				else if (diff < 0)
+				{
+					// Not filled yet
+					return false;
+				}
+				else
+				{
+					pos = m_dequeuePos.value.load(std::memory_order_relaxed);
+				}
+			}
+			
+			t = std::move(cell->task);
+			
+			// Make the cell available for the next lap
+			cell->sequence.store(pos + m_mask + 1, std::memory_order_release);
+			return true;
+		}
+		
+		bool InjectionQueue::PeekScheduleTime(Uint64& time) const
+		{
+			size_t pos = m_dequeuePos.value.load(std::memory_order_relaxed);
+			const Cell& cell = m_cells[pos & m_mask];
+			
+			if (cell.sequence.load(std::memory_order_acquire) != pos + 1)
+				return false;
+			
+			time = cell.scheduleTime.load(std::memory_order_relaxed);
+			
+			// The cell may have been popped and refilled meanwhile
+			return (cell.sequence.load(std::memory_order_acquire) == pos + 1);
+		}
+		
+	} // namespace priv
+} // namespace awl
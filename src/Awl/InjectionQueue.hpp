@@ -0,0 +1,97 @@
+
+/*
+ *  InjectionQueue.hpp
+ *  Awl - Asynchronous Work Library
+ *
+ *  Copyright (c) 2011 Lucas Soltic
+ *  ceylow@gmail.com
+ *
+ *  This software is provided 'as-is', without any express or implied warranty.
+ *  In no event will the authors be held liable for any damages arising from
+ *  the use of this software.
+ *
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute it freely,
+ *  subject to the following restrictions:
+ *
+ *  1. The origin of this software must not be misrepresented;
+ *     you must not claim that you wrote the original software.
+ *     If you use this software in a product, an acknowledgment
+ *     in the product documentation would be appreciated but is not required.
+ *
+ *  2. Altered source versions must be plainly marked as such,
+ *     and must not be misrepresented as being the original software.
+ *
+ *  3. This notice may not be removed or altered from any source distribution.
+ *
+ */
+
+#ifndef Awl_InjectionQueue_hpp
+#define Awl_InjectionQueue_hpp
+
+#include <Awl/boost/noncopyable.hpp>
+#include <Awl/Task.hpp>
+#include <atomic>
+#include <cstddef>
+
+namespace awl {
+	namespace priv {
+		
+		/** @brief Bounded lock-free multi-producer multi-consumer FIFO
+		 *
+		 * @details Array-based queue where each cell carries a sequence
+		 * number telling whether it's ready to be written or read for the
+		 * current lap (D. Vyukov's design). Producers and consumers only
+		 * contend on their own position counter.
+		 */
+		class InjectionQueue : boost::noncopyable {
+		public:
+			/** @brief Creates a queue able to hold at least @a capacity tasks,
+			 * rounded up to a power of two
+			 */
+			explicit InjectionQueue(size_t capacity);
+			~InjectionQueue(void);
+			
+			/** @brief Moves @a t, scheduled at @a scheduleTime, to the queue
+			 *
+			 * @return false if the queue is full, @a t is then left untouched
+			 */
+			bool TryPush(TaskRef& t, Uint64 scheduleTime);
+			
+			/** @brief Removes the oldest task of the queue and stores it in @a t
+			 *
+			 * @return false if the queue is empty
+			 */
+			bool TryPop(TaskRef& t);
+			
+			/** @brief Reads the schedule time of the oldest task without
+			 * removing it, only meant as a hint as the queue may be modified
+			 * concurrently
+			 *
+			 * @return false if the queue looks empty
+			 */
+			bool PeekScheduleTime(Uint64& time) const;
+			
+		private:
+			struct Cell {
+				std::atomic<size_t> sequence;
+				std::atomic<Uint64> scheduleTime;
+				TaskRef task;
+			};
+			
+			// Keeps the producer and consumer positions on their own cache line
+			struct Position {
+				std::atomic<size_t> value;
+				char padding[64 - sizeof(std::atomic<size_t>)];
+			};
+			
+			Cell *m_cells;
+			size_t m_mask;
+			Position m_enqueuePos;
+			Position m_dequeuePos;
+		};
+		
+	} // namespace priv
+} // namespace awl
+
+#endif // Awl_InjectionQueue_hpp
@@ -0,0 +1,124 @@
+
+/*
+ *  Latch.cpp
+ *  Awl - Asynchronous Work Library
+ *
+ *  Copyright (c) 2011 Lucas Soltic
+ *  ceylow@gmail.com
+ *
+ *  This software is provided 'as-is', without any express or implied warranty.
+ *  In no event will the authors be held liable for any damages arising from
+ *  the use of this software.
+ *
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute it freely,
+ *  subject to the following restrictions:
+ *
+ *  1. The origin of this software must not be misrepresented;
+ *     you must not claim that you wrote the original software.
+ *     If you use this software in a product, an acknowledgment
+ *     in the product documentation would be appreciated but is not required.
+ *
+ *  2. Altered source versions must be plainly marked as such,
+ *     and must not be misrepresented as being the original software.
+ *
+ *  3. This notice may not be removed or altered from any source distribution.
+ *
+ */
+#include <Awl/Latch.hpp>
+#include <Awl/ThreadPool.hpp>
+#include <Awl/WorkerThread.hpp>
+#include <Awl/Platform.hpp>
+#include <Awl/FiberScheduler.hpp>
+
+namespace awl {
+	
+	Latch::Latch(int count) :
+	m_count(count),
+	m_released(count == 0),
+	m_done(count == 0),
+	m_helperPool(NULL)
+	{
+	}
+	
+	void Latch::Add(int count)
+	{
+		if (m_count.fetch_add(count) == 0)
+		{
+			m_done = false;
+			m_released = 0;
+		}
+	}
+	
+	void Latch::CountDown(int count)
+	{
+		if (m_count.fetch_sub(count) == count)
+		{
+			m_released = 1;
+			
+			ThreadPool *pool = m_helperPool.exchange(NULL);
+			
+			if (pool)
+				pool->WakeHelpers();
+			
+			// Last access to the Latch, the waiter may destroy it right away
+			m_done = true;
+		}
+	}
+	
+	bool Latch::IsReleased(void) const
+	{
+		return m_done;
+	}
+	
+	bool Latch::IsCountedDown(const void *latch)
+	{
+		return static_cast<const Latch *>(latch)->m_count <= 0;
+	}
+	
+	void Latch::Wait(void)
+	{
+		WorkerThread *worker = WorkerThread::Current();
+		
+		if (priv::FiberScheduler::IsInFiber())
+		{
+			priv::FiberBackoff backoff;
+			
+			while (!m_done)
+				backoff.Pause();
+		}
+		else if (worker)
+		{
+			ThreadPool& pool = worker->GetPool();
+			ThreadPool *helperPool = NULL;
+			
+			// Execute pending tasks, parking until either the counter
+			// reaches zero or tasks are scheduled. Workers of a second pool
+			// waiting at the same time simply block
+			if (m_helperPool.compare_exchange_strong(helperPool, &pool) || helperPool == &pool)
+			{
+				pool.HelpUntil(*worker, &Latch::IsCountedDown, this);
+				
+				helperPool = &pool;
+				m_helperPool.compare_exchange_strong(helperPool, NULL);
+			}
+			else
+			{
+				m_released.WaitAndLock(1, Condition::AutoUnlock);
+			}
+			
+			// The releasing thread may still be waking us up
+			while (!m_done)
+				priv::Platform::YieldThread();
+		}
+		else
+		{
+			m_released.WaitAndLock(1, Condition::AutoUnlock);
+			
+			// The releasing thread may still be signaling m_released
+			while (!m_done)
+				priv::Platform::YieldThread();
+		}
+	}
+	
+} // namespace awl
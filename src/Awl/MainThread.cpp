@@ -33,7 +33,7 @@ namespace awl {
 	
 	TaskRef MainThreadCall(Callback f)
 	{
-		TaskRef t(new Task(f));
+		TaskRef t(Task::Create(std::move(f)));
 		WorkLoop::Default().ScheduleTaskForExecution(t);
 		return t;
 	}
@@ -0,0 +1,332 @@
+
+/*
+ *  NodeAllocator.cpp
+ *  Awl - Asynchronous Work Library
+ *
+ *  Copyright (c) 2011 Lucas Soltic
+ *  ceylow@gmail.com
+ *
+ *  This software is provided 'as-is', without any express or implied warranty.
+ *  In no event will the authors be held liable for any damages arising from
+ *  the use of this software.
+ *
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute it freely,
+ *  subject to the following restrictions:
+ *
+ *  1. The origin of this software must not be misrepresented;
+ *     you must not claim that you wrote the original software.
+ *     If you use this software in a product, an acknowledgment
+ *     in the product documentation would be appreciated but is not required.
+ *
+ *  2. Altered source versions must be plainly marked as such,
+ *     and must not be misrepresented as being the original software.
+ *
+ *  3. This notice may not be removed or altered from any source distribution.
+ *
+ */
+
+#include <Awl/NodeAllocator.hpp>
+#include <Awl/Platform.hpp>
+#include <Awl/Mutex.hpp>
+#include <Awl/Lock.hpp>
+#include <cstdlib>
+#include <new>
+#include <vector>
+
+namespace awl {
+	namespace priv {
+		
+		namespace {
+			// Blocks of 64, 128, 256 and 512 bytes, header included
+			const size_t MinBlockSize = 64;
+			const unsigned SizeClassCount = 4;
+			const unsigned HeapClass = SizeClassCount;
+			const size_t ChunkSize = 256 * 1024;
+			
+			// Blocks moved at once between a thread cache and its pool, and
+			// number of blocks a thread cache keeps for each size class
+			const unsigned CacheBatch = 32;
+			const unsigned MaxCachedBlocks = 2 * CacheBatch;
+			
+			// Keeps the payload aligned as malloc() would
+			union BlockHeader {
+				struct {
+					int pool;
+					unsigned sizeClass;
+				} info;
+				BlockHeader *next;
+				double alignment[2];
+			};
+			
+			struct NodePool {
+				NodePool(int node) : mutex(), node(node), chunk(NULL), chunkLeft(0)
+				{
+					for (unsigned i = 0; i < SizeClassCount; i++)
+						freeBlocks[i] = NULL;
+				}
+				
+				Mutex mutex;
+				int node;
+				BlockHeader *freeBlocks[SizeClassCount];
+				char *chunk;
+				size_t chunkLeft;
+			};
+			
+			// One pool per NUMA node, followed by the pool for AnyNode
+			// whose chunks come from the global heap
+			std::vector<NodePool *> CreateNodePools(void)
+			{
+				std::vector<NodePool *> pools(Platform::GetNumaNodes().size() + 1);
+				
+				for (size_t i = 0; i < pools.size(); i++)
+					pools[i] = new NodePool((i + 1 < pools.size()) ? (int)i : NodeAllocator::AnyNode);
+				
+				return pools;
+			}
+			
+			// The pools live as long as the process, as do their blocks: never
+			// destroyed, as threads still drain their cache after exit() ran
+			// the static destructors
+			std::vector<NodePool *>& NodePools(void)
+			{
+				static std::vector<NodePool *>& pools = *new std::vector<NodePool *>(CreateNodePools());
+				return pools;
+			}
+			
+			// Blocks recently allocated or released by a thread, all of them
+			// from a single pool, so that most calls don't lock any mutex.
+			// Plain data so that it can still be used (as closed) after the
+			// thread local destructors ran
+			struct ThreadCache {
+				bool isBound;
+				bool isClosed;
+				unsigned pool;
+				int node;
+				bool hasLocalNode;
+				int localNode;
+				BlockHeader *blocks[SizeClassCount];
+				unsigned counts[SizeClassCount];
+			};
+			
+			thread_local ThreadCache t_cache;
+			
+			// Gives the blocks of @a cache back to their pool, @a keep of
+			// them being left in each size class
+			void Drain(ThreadCache& cache, unsigned keep)
+			{
+				NodePool& pool = *NodePools()[cache.pool];
+				Lock l(pool.mutex);
+				
+				for (unsigned sizeClass = 0; sizeClass < SizeClassCount; sizeClass++)
+				{
+					while (cache.counts[sizeClass] > keep)
+					{
+						BlockHeader *header = cache.blocks[sizeClass];
+						cache.blocks[sizeClass] = header->next;
+						cache.counts[sizeClass]--;
+						
+						header->next = pool.freeBlocks[sizeClass];
+						pool.freeBlocks[sizeClass] = header;
+					}
+				}
+			}
+			
+			struct CacheCloser {
+				~CacheCloser(void)
+				{
+					Drain(t_cache, 0);
+					t_cache.isClosed = true;
+				}
+			};
+			
+			// Returns @a cache if it may hold blocks of @a pool, NULL otherwise
+			ThreadCache *BindCache(ThreadCache& cache, unsigned pool)
+			{
+				if (!cache.isBound)
+				{
+					static thread_local CacheCloser closer;
+					(void)closer;
+					
+					cache.isBound = true;
+					cache.pool = pool;
+					cache.node = NodePools()[pool]->node;
+				}
+				
+				return (!cache.isClosed && cache.pool == pool) ? &cache : NULL;
+			}
+			
+			// Takes a free block from @a pool, with its mutex locked
+			BlockHeader *TakeBlock(NodePool& pool, unsigned sizeClass)
+			{
+				BlockHeader *header = pool.freeBlocks[sizeClass];
+				
+				if (header)
+				{
+					pool.freeBlocks[sizeClass] = header->next;
+					return header;
+				}
+				
+				size_t blockSize = MinBlockSize << sizeClass;
+				
+				if (pool.chunkLeft < blockSize)
+				{
+					// What's left of the previous chunk is lost
+					if (pool.node == NodeAllocator::AnyNode)
+						pool.chunk = (char *)malloc(ChunkSize);
+					else
+						pool.chunk = (char *)Platform::AllocateOnNode(ChunkSize, pool.node);
+					
+					pool.chunkLeft = pool.chunk ? ChunkSize : 0;
+				}
+				
+				if (!pool.chunk)
+					return NULL;
+				
+				header = (BlockHeader *)pool.chunk;
+				pool.chunk += blockSize;
+				pool.chunkLeft -= blockSize;
+				return header;
+			}
+			
+			// NodeAllocator::Allocate() for the thread owning @a cache
+			void *AllocateFrom(ThreadCache& cache, size_t size, int node)
+			{
+				size_t blockSize = MinBlockSize;
+				unsigned sizeClass = 0;
+				
+				while (sizeClass < SizeClassCount && blockSize < size + sizeof(BlockHeader))
+				{
+					blockSize *= 2;
+					sizeClass++;
+				}
+				
+				BlockHeader *header = NULL;
+				
+				// Most allocations end here: closed or unbound caches are empty
+				if (sizeClass < SizeClassCount && cache.blocks[sizeClass] && cache.node == node)
+				{
+					header = cache.blocks[sizeClass];
+					cache.blocks[sizeClass] = header->next;
+					cache.counts[sizeClass]--;
+					
+					header->info.pool = (int)cache.pool;
+					header->info.sizeClass = sizeClass;
+					return header + 1;
+				}
+				
+				if (sizeClass < SizeClassCount)
+				{
+					std::vector<NodePool *>& pools = NodePools();
+					unsigned index = (node >= 0 && (size_t)node + 1 < pools.size()) ? (unsigned)node : (unsigned)pools.size() - 1;
+					NodePool& pool = *pools[index];
+					
+					Lock l(pool.mutex);
+					
+					if (BindCache(cache, index))
+					{
+						// Refill the cache before taking a block from it
+						while (cache.counts[sizeClass] < CacheBatch)
+						{
+							BlockHeader *block = TakeBlock(pool, sizeClass);
+							
+							if (!block)
+								break;
+							
+							block->next = cache.blocks[sizeClass];
+							cache.blocks[sizeClass] = block;
+							cache.counts[sizeClass]++;
+						}
+						
+						header = cache.blocks[sizeClass];
+						
+						if (header)
+						{
+							cache.blocks[sizeClass] = header->next;
+							cache.counts[sizeClass]--;
+						}
+					}
+					else
+					{
+						header = TakeBlock(pool, sizeClass);
+					}
+					
+					if (header)
+					{
+						header->info.pool = (int)index;
+						header->info.sizeClass = sizeClass;
+					}
+				}
+				
+				if (!header)
+				{
+					header = (BlockHeader *)malloc(size + sizeof(BlockHeader));
+					
+					if (!header)
+						throw std::bad_alloc();
+					
+					header->info.pool = NodeAllocator::AnyNode;
+					header->info.sizeClass = HeapClass;
+				}
+				
+				return header + 1;
+			}
+		}
+		
+		void *NodeAllocator::Allocate(size_t size, int node)
+		{
+			return AllocateFrom(t_cache, size, node);
+		}
+		
+		void *NodeAllocator::AllocateLocal(size_t size)
+		{
+			ThreadCache& cache = t_cache;
+			return AllocateFrom(cache, size, cache.hasLocalNode ? cache.localNode : AnyNode);
+		}
+		
+		void NodeAllocator::SetLocalNode(int node)
+		{
+			t_cache.hasLocalNode = true;
+			t_cache.localNode = node;
+		}
+		
+		void NodeAllocator::Free(void *block)
+		{
+			if (!block)
+				return;
+			
+			BlockHeader *header = (BlockHeader *)block - 1;
+			
+			if (header->info.sizeClass == HeapClass)
+			{
+				free(header);
+				return;
+			}
+			
+			unsigned index = (unsigned)header->info.pool;
+			unsigned sizeClass = header->info.sizeClass;
+			ThreadCache *cache = BindCache(t_cache, index);
+			
+			if (cache)
+			{
+				header->next = cache->blocks[sizeClass];
+				cache->blocks[sizeClass] = header;
+				cache->counts[sizeClass]++;
+				
+				// Threads that mostly release blocks allocated by other
+				// threads hand them back in batches
+				if (cache->counts[sizeClass] > MaxCachedBlocks)
+					Drain(*cache, CacheBatch);
+			}
+			else
+			{
+				NodePool& pool = *NodePools()[index];
+				
+				Lock l(pool.mutex);
+				header->next = pool.freeBlocks[sizeClass];
+				pool.freeBlocks[sizeClass] = header;
+			}
+		}
+		
+	} // namespace priv
+} // namespace awl
@@ -0,0 +1,77 @@
+
+/*
+ *  NodeAllocator.hpp
+ *  Awl - Asynchronous Work Library
+ *
+ *  Copyright (c) 2011 Lucas Soltic
+ *  ceylow@gmail.com
+ *
+ *  This software is provided 'as-is', without any express or implied warranty.
+ *  In no event will the authors be held liable for any damages arising from
+ *  the use of this software.
+ *
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute it freely,
+ *  subject to the following restrictions:
+ *
+ *  1. The origin of this software must not be misrepresented;
+ *     you must not claim that you wrote the original software.
+ *     If you use this software in a product, an acknowledgment
+ *     in the product documentation would be appreciated but is not required.
+ *
+ *  2. Altered source versions must be plainly marked as such,
+ *     and must not be misrepresented as being the original software.
+ *
+ *  3. This notice may not be removed or altered from any source distribution.
+ *
+ */
+
+#ifndef Awl_NodeAllocator_hpp
+#define Awl_NodeAllocator_hpp
+
+#include <Awl/Config.hpp>
+#include <cstddef>
+
+namespace awl {
+	namespace priv {
+		
+		/** @brief Allocator for small objects (mainly Tasks) whose memory
+		 * should be local to a NUMA node
+		 *
+		 * @details Blocks are carved from chunks provided by the node and
+		 * recycled through per-size free lists. The chunks are never given
+		 * back to the system. Requests for an unknown node are served from
+		 * chunks of the global heap, and big blocks come straight from it.
+		 *
+		 * Each thread keeps a few free blocks of the pool it uses most, so
+		 * that allocating and releasing blocks usually takes no lock. They
+		 * are exchanged with the pool in batches.
+		 */
+		class NodeAllocator {
+		public:
+			/** Used to request memory that isn't bound to any node
+			 */
+			static const int AnyNode = -1;
+			
+			/** @brief Allocates @a size bytes, on @a node if possible
+			 */
+			static void *Allocate(size_t size, int node);
+			
+			/** @brief Allocates @a size bytes on the node set for the calling
+			 * thread by SetLocalNode(), or on AnyNode
+			 */
+			static void *AllocateLocal(size_t size);
+			
+			/** @brief Sets the node of the calling thread, see AllocateLocal()
+			 */
+			static void SetLocalNode(int node);
+			
+			/** @brief Releases a block returned by Allocate()
+			 */
+			static void Free(void *block);
+		};
+		
+	} // namespace priv
+} // namespace awl
+
+#endif // Awl_NodeAllocator_hpp
@@ -0,0 +1,115 @@
+
+/*
+ *  PendingQueue.cpp
+ *  Awl - Asynchronous Work Library
+ *
+ *  Copyright (c) 2011 Lucas Soltic
+ *  ceylow@gmail.com
+ *
+ *  This software is provided 'as-is', without any express or implied warranty.
+ *  In no event will the authors be held liable for any damages arising from
+ *  the use of this software.
+ *
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute it freely,
+ *  subject to the following restrictions:
+ *
+ *  1. The origin of this software must not be misrepresented;
+ *     you must not claim that you wrote the original software.
+ *     If you use this software in a product, an acknowledgment
+ *     in the product documentation would be appreciated but is not required.
+ *
+ *  2. Altered source versions must be plainly marked as such,
+ *     and must not be misrepresented as being the original software.
+ *
+ *  3. This notice may not be removed or altered from any source distribution.
+ *
+ */
+
+#include <Awl/PendingQueue.hpp>
+#include <algorithm>
+
+namespace awl {
+	namespace priv {
+		
+		PendingQueue::~PendingQueue(void)
+		{
+			
+		}
+		
+		PendingQueue *PendingQueue::Create(SchedulingPolicy policy)
+		{
+			if (policy == DeadlineScheduling)
+				return new DeadlineQueue();
+			else
+				return new FifoQueue();
+		}
+		
+		void FifoQueue::Push(TaskRef t)
+		{
+			m_tasks.PushBack(std::move(t));
+		}
+		
+		const TaskRef& FifoQueue::Front(void) const
+		{
+			return m_tasks.Front();
+		}
+		
+		void FifoQueue::Pop(void)
+		{
+			m_tasks.PopFront();
+		}
+		
+		bool FifoQueue::IsEmpty(void) const
+		{
+			return m_tasks.IsEmpty();
+		}
+		
+		DeadlineQueue::DeadlineQueue(void) :
+		m_heap(),
+		m_sequence(0)
+		{
+			
+		}
+		
+		void DeadlineQueue::Push(TaskRef t)
+		{
+			Entry e;
+			e.deadline = t->GetDeadline();
+			e.sequence = m_sequence++;
+			e.task = std::move(t);
+			
+			// No deadline means "whenever possible"
+			if (e.deadline == Task::NoDeadline)
+				e.deadline = (Uint64)-1;
+			
+			m_heap.push_back(std::move(e));
+			std::push_heap(m_heap.begin(), m_heap.end(), &DeadlineQueue::IsLater);
+		}
+		
+		const TaskRef& DeadlineQueue::Front(void) const
+		{
+			return m_heap.front().task;
+		}
+		
+		void DeadlineQueue::Pop(void)
+		{
+			std::pop_heap(m_heap.begin(), m_heap.end(), &DeadlineQueue::IsLater);
+			m_heap.pop_back();
+		}
+		
+		bool DeadlineQueue::IsEmpty(void) const
+		{
+			return m_heap.empty();
+		}
+		
+		bool DeadlineQueue::IsLater(const Entry& a, const Entry& b)
+		{
+			if (a.deadline != b.deadline)
+				return a.deadline > b.deadline;
+			else
+				return a.sequence > b.sequence;
+		}
+		
+	} // namespace priv
+} // namespace awl
@@ -0,0 +1,115 @@
+
+/*
+ *  PendingQueue.hpp
+ *  Awl - Asynchronous Work Library
+ *
+ *  Copyright (c) 2011 Lucas Soltic
+ *  ceylow@gmail.com
+ *
+ *  This software is provided 'as-is', without any express or implied warranty.
+ *  In no event will the authors be held liable for any damages arising from
+ *  the use of this software.
+ *
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute it freely,
+ *  subject to the following restrictions:
+ *
+ *  1. The origin of this software must not be misrepresented;
+ *     you must not claim that you wrote the original software.
+ *     If you use this software in a product, an acknowledgment
+ *     in the product documentation would be appreciated but is not required.
+ *
+ *  2. Altered source versions must be plainly marked as such,
+ *     and must not be misrepresented as being the original software.
+ *
+ *  3. This notice may not be removed or altered from any source distribution.
+ *
+ */
+
+#ifndef Awl_PendingQueue_hpp
+#define Awl_PendingQueue_hpp
+
+#include <Awl/boost/noncopyable.hpp>
+#include <Awl/PoolSettings.hpp>
+#include <Awl/Task.hpp>
+#include <Awl/TaskRing.hpp>
+#include <vector>
+
+namespace awl {
+	namespace priv {
+		
+		/** @brief Ordering of the tasks waiting in one priority band of the
+		 * shared queue of a ThreadPool
+		 *
+		 * @details Implementations are not thread-safe, the ThreadPool
+		 * protects them with its own lock.
+		 */
+		class PendingQueue : boost::noncopyable {
+		public:
+			virtual ~PendingQueue(void);
+			
+			/** @brief Creates the queue implementing the given @a policy
+			 */
+			static PendingQueue *Create(SchedulingPolicy policy);
+			
+			/** @brief Adds @a t to the queue
+			 */
+			virtual void Push(TaskRef t) = 0;
+			
+			/** @brief Returns the task that should be executed next,
+			 * the queue must not be empty
+			 */
+			virtual const TaskRef& Front(void) const = 0;
+			
+			/** @brief Removes the task returned by Front()
+			 */
+			virtual void Pop(void) = 0;
+			
+			virtual bool IsEmpty(void) const = 0;
+		};
+		
+		/** @brief First in, first out
+		 */
+		class FifoQueue : public PendingQueue {
+		public:
+			void Push(TaskRef t);
+			const TaskRef& Front(void) const;
+			void Pop(void);
+			bool IsEmpty(void) const;
+			
+		private:
+			TaskRing m_tasks;
+		};
+		
+		/** @brief Earliest deadline first
+		 *
+		 * @details Tasks without deadline come after all the others. Tasks
+		 * with the same deadline are kept in submission order.
+		 */
+		class DeadlineQueue : public PendingQueue {
+		public:
+			DeadlineQueue(void);
+			
+			void Push(TaskRef t);
+			const TaskRef& Front(void) const;
+			void Pop(void);
+			bool IsEmpty(void) const;
+			
+		private:
+			struct Entry {
+				Uint64 deadline;
+				Uint64 sequence;
+				TaskRef task;
+			};
+			
+			// Orders the heap so that its top is the earliest entry
+			static bool IsLater(const Entry& a, const Entry& b);
+			
+			std::vector<Entry> m_heap;
+			Uint64 m_sequence;
+		};
+		
+	} // namespace priv
+} // namespace awl
+
+#endif // Awl_PendingQueue_hpp
@@ -31,13 +31,16 @@
 
 #include <Awl/Sleep.hpp>
 #include <Awl/Platform.hpp>
+#include <Awl/FiberScheduler.hpp>
 
 namespace awl {
 	
 	////////////////////////////////////////////////////////////
 	void Sleep(Uint32 duration)
 	{
-		priv::Platform::Sleep(duration);
+		// Task fibers let the other tasks of their worker run meanwhile
+		if (!priv::FiberScheduler::Suspend(priv::Platform::GetMonotonicTime() + duration))
+			priv::Platform::Sleep(duration);
 	}
 	
 } // namespace awl
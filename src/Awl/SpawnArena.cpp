@@ -0,0 +1,108 @@
+
+/*
+ *  SpawnArena.cpp
+ *  Awl - Asynchronous Work Library
+ *
+ *  Copyright (c) 2011 Lucas Soltic
+ *  ceylow@gmail.com
+ *
+ *  This software is provided 'as-is', without any express or implied warranty.
+ *  In no event will the authors be held liable for any damages arising from
+ *  the use of this software.
+ *
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute it freely,
+ *  subject to the following restrictions:
+ *
+ *  1. The origin of this software must not be misrepresented;
+ *     you must not claim that you wrote the original software.
+ *     If you use this software in a product, an acknowledgment
+ *     in the product documentation would be appreciated but is not required.
+ *
+ *  2. Altered source versions must be plainly marked as such,
+ *     and must not be misrepresented as being the original software.
+ *
+ *  3. This notice may not be removed or altered from any source distribution.
+ *
+ */
+#include <Awl/SpawnArena.hpp>
+#include <Awl/FiberScheduler.hpp>
+#include <Awl/Err.hpp>
+#include <algorithm>
+#include <cstdlib>
+#include <ostream>
+
+namespace awl {
+	namespace priv {
+		
+		static const size_t ChunkSize = 64 * 1024;
+		static const size_t Alignment = 16;
+		
+		SpawnArena::SpawnArena(void)
+		{
+			m_top.chunk = 0;
+			m_top.offset = 0;
+		}
+		
+		SpawnArena::~SpawnArena(void)
+		{
+			for (size_t i = 0; i < m_chunks.size(); i++)
+				free(m_chunks[i].memory);
+		}
+		
+		SpawnArena& SpawnArena::Current(void)
+		{
+			SpawnArena *fiberArena = FiberScheduler::GetFiberArena();
+			
+			if (fiberArena)
+				return *fiberArena;
+			
+			static thread_local SpawnArena arena;
+			return arena;
+		}
+		
+		void *SpawnArena::Allocate(size_t size)
+		{
+			size = (size + Alignment - 1) & ~(Alignment - 1);
+			
+			// Skip the chunks that are too small, they'll be used again
+			// once rewound
+			while (m_top.chunk < m_chunks.size() &&
+				   m_top.offset + size > m_chunks[m_top.chunk].size)
+			{
+				m_top.chunk++;
+				m_top.offset = 0;
+			}
+			
+			if (m_top.chunk == m_chunks.size())
+			{
+				Chunk chunk;
+				chunk.size = std::max(size, ChunkSize);
+				chunk.memory = static_cast<char *>(malloc(chunk.size));
+				
+				if (!chunk.memory)
+				{
+					Err() << "SpawnArena::Allocate() - malloc() error" << std::endl;
+					return NULL;
+				}
+				
+				m_chunks.push_back(chunk);
+			}
+			
+			void *memory = m_chunks[m_top.chunk].memory + m_top.offset;
+			m_top.offset += size;
+			return memory;
+		}
+		
+		ArenaMark SpawnArena::GetMark(void) const
+		{
+			return m_top;
+		}
+		
+		void SpawnArena::Rewind(const ArenaMark& mark)
+		{
+			m_top = mark;
+		}
+		
+	} // namespace priv
+} // namespace awl
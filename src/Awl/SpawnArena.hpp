@@ -0,0 +1,82 @@
+
+/*
+ *  SpawnArena.hpp
+ *  Awl - Asynchronous Work Library
+ *
+ *  Copyright (c) 2011 Lucas Soltic
+ *  ceylow@gmail.com
+ *
+ *  This software is provided 'as-is', without any express or implied warranty.
+ *  In no event will the authors be held liable for any damages arising from
+ *  the use of this software.
+ *
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute it freely,
+ *  subject to the following restrictions:
+ *
+ *  1. The origin of this software must not be misrepresented;
+ *     you must not claim that you wrote the original software.
+ *     If you use this software in a product, an acknowledgment
+ *     in the product documentation would be appreciated but is not required.
+ *
+ *  2. Altered source versions must be plainly marked as such,
+ *     and must not be misrepresented as being the original software.
+ *
+ *  3. This notice may not be removed or altered from any source distribution.
+ *
+ */
+#ifndef Awl_SpawnArena_hpp
+#define Awl_SpawnArena_hpp
+
+#include <Awl/boost/noncopyable.hpp>
+#include <Awl/ForkJoin.hpp>
+#include <vector>
+
+namespace awl {
+	namespace priv {
+		
+		/** @brief Per-thread stack-like allocator of the spawned frames
+		 *
+		 * @details Memory is bumped from chunks that are kept once allocated,
+		 * and released all at once by rewinding to a previous mark, which is
+		 * what nested ForkJoin scopes do when they are synced.
+		 */
+		class SpawnArena : boost::noncopyable {
+		public:
+			SpawnArena(void);
+			~SpawnArena(void);
+			
+			/** @brief Returns the arena of the calling thread, or of the
+			 * calling task fiber
+			 */
+			static SpawnArena& Current(void);
+			
+			/** @brief Allocates @a size bytes, suitably aligned for any type
+			 *
+			 * @return The allocated memory, or NULL if out of memory
+			 */
+			void *Allocate(size_t size);
+			
+			/** @brief Returns the current position of the arena
+			 */
+			ArenaMark GetMark(void) const;
+			
+			/** @brief Releases everything that has been allocated since
+			 * @a mark has been taken
+			 */
+			void Rewind(const ArenaMark& mark);
+			
+		private:
+			struct Chunk {
+				char *memory;
+				size_t size;
+			};
+			
+			std::vector<Chunk> m_chunks;
+			ArenaMark m_top;
+		};
+		
+	} // namespace priv
+} // namespace awl
+
+#endif // Awl_SpawnArena_hpp
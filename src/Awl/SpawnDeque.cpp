@@ -0,0 +1,132 @@
+
+/*
+ *  SpawnDeque.cpp
+ *  Awl - Asynchronous Work Library
+ *
+ *  Copyright (c) 2011 Lucas Soltic
+ *  ceylow@gmail.com
+ *
+ *  This software is provided 'as-is', without any express or implied warranty.
+ *  In no event will the authors be held liable for any damages arising from
+ *  the use of this software.
+ *
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute it freely,
+ *  subject to the following restrictions:
+ *
+ *  1. The origin of this software must not be misrepresented;
+ *     you must not claim that you wrote the original software.
+ *     If you use this software in a product, an acknowledgment
+ *     in the product documentation would be appreciated but is not required.
+ *
+ *  2. Altered source versions must be plainly marked as such,
+ *     and must not be misrepresented as being the original software.
+ *
+ *  3. This notice may not be removed or altered from any source distribution.
+ *
+ */
+#include <Awl/SpawnDeque.hpp>
+
+namespace awl {
+	namespace priv {
+		
+		SpawnDeque::SpawnDeque(size_t capacity) :
+		m_frames(NULL),
+		m_mask(0),
+		m_top(0),
+		m_bottom(0)
+		{
+			size_t size = 1;
+			
+			while (size < capacity)
+				size *= 2;
+			
+			m_frames = new std::atomic<SpawnFrame *>[size];
+			m_mask = size - 1;
+			
+			for (size_t i = 0; i < size; i++)
+				m_frames[i].store(NULL, std::memory_order_relaxed);
+		}
+		
+		SpawnDeque::~SpawnDeque(void)
+		{
+			delete[] m_frames;
+		}
+		
+		bool SpawnDeque::Push(SpawnFrame *frame)
+		{
+			Int64 bottom = m_bottom.load(std::memory_order_relaxed);
+			Int64 top = m_top.load(std::memory_order_acquire);
+			
+			if (bottom - top > m_mask)
+				return false;
+			
+			m_frames[bottom & m_mask].store(frame, std::memory_order_relaxed);
+			m_bottom.store(bottom + 1, std::memory_order_release);
+			return true;
+		}
+		
+		SpawnFrame *SpawnDeque::Pop(void)
+		{
+			Int64 bottom = m_bottom.load(std::memory_order_relaxed) - 1;
+			// Sequentially consistent store and load: a thief either sees the
+			// new bottom or is seen by the check below
+			m_bottom.store(bottom, std::memory_order_seq_cst);
+			Int64 top = m_top.load(std::memory_order_seq_cst);
+			
+			if (top > bottom)
+			{
+				// Empty
+				m_bottom.store(bottom + 1, std::memory_order_relaxed);
+				return NULL;
+			}
+			
+			SpawnFrame *frame = m_frames[bottom & m_mask].load(std::memory_order_relaxed);
+			
+			if (top == bottom)
+			{
+				// Last frame: race against the thieves
+				if (!m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst,
+												   std::memory_order_relaxed))
+				{
+					frame = NULL;
+				}
+				
+				m_bottom.store(bottom + 1, std::memory_order_relaxed);
+			}
+			
+			return frame;
+		}
+		
+		SpawnFrame *SpawnDeque::Steal(void)
+		{
+			Int64 top = m_top.load(std::memory_order_acquire);
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			Int64 bottom = m_bottom.load(std::memory_order_acquire);
+			
+			if (top >= bottom)
+				return NULL;
+			
+			SpawnFrame *frame = m_frames[top & m_mask].load(std::memory_order_relaxed);
+			
+			if (!m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst,
+											   std::memory_order_relaxed))
+			{
+				return NULL;
+			}
+			
+			return frame;
+		}
+		
+		Int64 SpawnDeque::GetBottom(void) const
+		{
+			return m_bottom.load(std::memory_order_relaxed);
+		}
+		
+		bool SpawnDeque::IsEmpty(void) const
+		{
+			return m_top.load(std::memory_order_relaxed) >= m_bottom.load(std::memory_order_relaxed);
+		}
+		
+	} // namespace priv
+} // namespace awl
@@ -0,0 +1,98 @@
+
+/*
+ *  SpawnDeque.hpp
+ *  Awl - Asynchronous Work Library
+ *
+ *  Copyright (c) 2011 Lucas Soltic
+ *  ceylow@gmail.com
+ *
+ *  This software is provided 'as-is', without any express or implied warranty.
+ *  In no event will the authors be held liable for any damages arising from
+ *  the use of this software.
+ *
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute it freely,
+ *  subject to the following restrictions:
+ *
+ *  1. The origin of this software must not be misrepresented;
+ *     you must not claim that you wrote the original software.
+ *     If you use this software in a product, an acknowledgment
+ *     in the product documentation would be appreciated but is not required.
+ *
+ *  2. Altered source versions must be plainly marked as such,
+ *     and must not be misrepresented as being the original software.
+ *
+ *  3. This notice may not be removed or altered from any source distribution.
+ *
+ */
+#ifndef Awl_SpawnDeque_hpp
+#define Awl_SpawnDeque_hpp
+
+#include <Awl/boost/noncopyable.hpp>
+#include <Awl/ForkJoin.hpp>
+#include <atomic>
+
+namespace awl {
+	namespace priv {
+		
+		/** @brief Bounded lock-free deque of the frames spawned by a
+		 * single WorkerThread (Chase-Lev)
+		 *
+		 * @details The owner pushes and pops at the bottom without any
+		 * atomic read-modify-write except when racing for the last frame,
+		 * while the other workers steal from the top.
+		 */
+		class SpawnDeque : boost::noncopyable {
+		public:
+			/** @param capacity The maximum number of queued frames,
+			 * rounded up to a power of two
+			 */
+			explicit SpawnDeque(size_t capacity = 1024);
+			~SpawnDeque(void);
+			
+			/** @brief Push @a frame at the bottom of the deque (owner side)
+			 *
+			 * @return false if the deque is full
+			 */
+			bool Push(SpawnFrame *frame);
+			
+			/** @brief Pop the most recently pushed frame (owner side)
+			 *
+			 * @return The frame, or NULL if the deque is empty or if its
+			 * last frame has just been stolen
+			 */
+			SpawnFrame *Pop(void);
+			
+			/** @brief Pop the oldest frame (thief side)
+			 *
+			 * @return The frame, or NULL if the deque is empty or if another
+			 * worker got the frame first
+			 */
+			SpawnFrame *Steal(void);
+			
+			/** @brief Returns the index of the next pushed frame (owner side)
+			 */
+			Int64 GetBottom(void) const;
+			
+			/** @brief Non-blocking check, only meant as a hint as the deque
+			 * may be modified concurrently
+			 */
+			bool IsEmpty(void) const;
+			
+		private:
+			std::atomic<SpawnFrame *> *m_frames;
+			Int64 m_mask;
+			
+			// Kept on separate cache lines: the owner writes the bottom,
+			// the thieves write the top
+			char m_pad0[64];
+			std::atomic<Int64> m_top;
+			char m_pad1[64];
+			std::atomic<Int64> m_bottom;
+			char m_pad2[64];
+		};
+		
+	} // namespace priv
+} // namespace awl
+
+#endif // Awl_SpawnDeque_hpp
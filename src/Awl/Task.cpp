@@ -30,98 +30,462 @@
 #include <Awl/Debug.hpp>
 #include <Awl/Thread.hpp>
 #include <Awl/ThreadPool.hpp>
+#include <Awl/WorkerThread.hpp>
+#include <Awl/NodeAllocator.hpp>
+#include <Awl/Platform.hpp>
+#include <Awl/FiberScheduler.hpp>
+
+#if defined(Awl_SystemWindows)
+#include <Awl/Win32/FutexImpl.hpp>
+#else
+#include <Awl/Unix/FutexImpl.hpp>
+#endif
 
 namespace awl {
 	
+	namespace priv {
+		
+		/** @brief Marks the list of a Task whose continuations have been run,
+		 * never run itself
+		 */
+		class ClosedMarker : public Continuation {
+		public:
+			void Run(ThreadPool&)
+			{
+			}
+			
+			void Discard(void)
+			{
+			}
+		};
+		
+		static ClosedMarker s_closedList;
+		static Continuation * const ClosedList = &s_closedList;
+	}
+	
+	void *Task::operator new(size_t size)
+	{
+		return priv::NodeAllocator::AllocateLocal(size);
+	}
+	
+	void *Task::operator new(size_t size, int node)
+	{
+		return priv::NodeAllocator::Allocate(size, node);
+	}
+	
+	void Task::operator delete(void *block)
+	{
+		priv::NodeAllocator::Free(block);
+	}
+	
+	void Task::operator delete(void *block, int)
+	{
+		priv::NodeAllocator::Free(block);
+	}
+	
 	Task::Task(void) :
+	m_referenceCount(0),
+	m_state(0),
 	m_callback(),
-	m_isCancelled(false),
-	m_isOver(false),
 	m_owner(NULL),
+	m_helperPool(NULL),
 	m_threadId(-1),
-	m_taskDone()
+	m_scheduleTime(0),
+	m_priority(NormalPriority),
+	m_deadline(NoDeadline),
+	m_node(AnyNode),
+	m_continuations(NULL),
+	m_successor(*this)
 	{
 		
 	}
 	
 	Task::Task(Callback f) :
-	m_callback(f),
-	m_isCancelled(false),
-	m_isOver(false),
+	m_referenceCount(0),
+	m_state(0),
+	m_callback(std::move(f)),
 	m_owner(NULL),
+	m_helperPool(NULL),
 	m_threadId(-1),
-	m_taskDone()
+	m_scheduleTime(0),
+	m_priority(NormalPriority),
+	m_deadline(NoDeadline),
+	m_node(AnyNode),
+	m_continuations(NULL),
+	m_successor(*this)
 	{
 		
 	}
 		
+	TaskRef Task::Create(Callback f)
+	{
+		// Nobody else knows about the Task yet, no need for an atomic increment
+		Task *task = new Task(std::move(f));
+		task->m_referenceCount.store(1, std::memory_order_relaxed);
+		return TaskRef(task, false);
+	}
+	
 	Task::~Task(void)
 	{
+		DiscardContinuations();
+	}
+	
+	void Task::DiscardContinuations(void)
+	{
+		priv::Continuation *c = m_continuations.exchange(priv::ClosedList);
 		
+		// Never executed: drop the pending continuations
+		while (c && c != priv::ClosedList)
+		{
+			priv::Continuation *next = c->next;
+			c->Discard();
+			c = next;
+		}
 	}
 	
 	void Task::Cancel(void)
 	{
-		m_isCancelled = true;
+		m_state.fetch_or(CancelledFlag);
+		OnCancel();
+	}
+	
+	void Task::OnCancel(void)
+	{
 	}
 	
 	void Task::Abort(void)
 	{
 		Cancel();
 		
-		if (m_owner)
+		WorkerThread *owner = m_owner.load();
+		Uint32 state = m_state.load();
+		
+		// Only kill the worker while it still runs this Task, and complete
+		// the Task in its place as the worker never will. The Task is
+		// finished first as the worker may be the calling thread
+		while (owner && (state & RunningFlag) && !(state & DoneFlag))
 		{
-			ThreadPool::Default().KillWorkerThread(m_owner);
+			if (m_state.compare_exchange_weak(state, state | DoneFlag))
+			{
+				Finish(state, owner->GetPool());
+				owner->GetPool().KillWorkerThread(owner);
+				return;
+			}
 		}
 	}
 	
 	bool Task::IsCancelled(void) const
 	{
-		return m_isCancelled;
+		return (m_state.load() & CancelledFlag) != 0;
 	}
 	
 	bool Task::IsOver(void) const
 	{
-		return m_isOver;
+		return (m_state.load() & OverFlag) != 0;
+	}
+	
+	bool Task::IsDone(void) const
+	{
+		return (m_state.load(std::memory_order_acquire) & DoneFlag) != 0;
+	}
+	
+	bool Task::IsDone(const void *task)
+	{
+		return static_cast<const Task *>(task)->IsDone();
+	}
+	
+	void Task::Reset(void)
+	{
+		// Started when its thread is known: the executing thread may still
+		// be running the end of Execute(), even though the callback
+		// returned and made the caller reset the Task
+		if (m_state.load() & RunningFlag)
+		{
+			while (m_continuations.load() != priv::ClosedList)
+				priv::Platform::YieldThread();
+			
+			m_continuations = NULL;
+		}
+		
+		m_threadId.store(-1, std::memory_order_relaxed);
+		m_helperPool = NULL;
+		m_state = 0;
 	}
 	
 	bool Task::Wait(void)
 	{
-		if (m_threadId == Thread::GetCurrentThreadId())
+		WorkerThread *worker = WorkerThread::Current();
+		
+		if (priv::FiberScheduler::IsInFiber())
+		{
+			// The Task may be suspended on the same worker: don't compare
+			// the threads, let the other fibers run instead
+			priv::FiberBackoff backoff;
+			
+			while (!IsDone())
+				backoff.Pause();
+			
+			return true;
+		}
+		else if (m_threadId.load(std::memory_order_relaxed) == Thread::GetCurrentThreadId() && !IsDone())
 		{
 			MT_DEBUG_COUT(std::cout << "trying to wait on same thread" << std::endl);
 			return false;
 		}
+		else if (worker)
+		{
+			ThreadPool& pool = worker->GetPool();
+			ThreadPool *helperPool = NULL;
+			
+			// A blocked worker could be the one the Task is waiting for:
+			// execute pending tasks instead, parking until either the Task
+			// completes or tasks are scheduled. Workers of a second pool
+			// waiting at the same time simply block
+			if (m_helperPool.compare_exchange_strong(helperPool, &pool) || helperPool == &pool)
+			{
+				m_state.fetch_or(HelperFlag);
+				pool.HelpUntil(*worker, &Task::IsDone, this);
+				
+				helperPool = &pool;
+				m_helperPool.compare_exchange_strong(helperPool, NULL);
+			}
+			else
+			{
+				WaitUntilDone(0);
+			}
+			
+			return true;
+		}
 		else
 		{
-			m_taskDone.WaitAndLock(1, Condition::AutoUnlock);
+			WaitUntilDone(0);
 			return true;
 		}
 	}
 	
+	void Task::WaitUntilDone(Uint32 timeout)
+	{
+		Uint32 state = m_state.load(std::memory_order_acquire);
+		
+		while (!(state & DoneFlag))
+		{
+			// Tell Execute() that it will have to wake us up
+			if (!(state & WaiterFlag) && !m_state.compare_exchange_weak(state, state | WaiterFlag))
+				continue;
+			
+			// Returns right away if the state changed in the meantime
+			priv::FutexImpl::wait(m_state, state | WaiterFlag, timeout);
+			
+			if (timeout)
+				return;
+			
+			state = m_state.load(std::memory_order_acquire);
+		}
+	}
+	
+	void Task::Then(const TaskRef& next)
+	{
+		Chain(NULL, next);
+	}
+	
+	void Task::Then(ThreadPool& pool, const TaskRef& next)
+	{
+		Chain(&pool, next);
+	}
+	
+	void Task::Chain(ThreadPool *pool, const TaskRef& next)
+	{
+		// The reference is given back by Successor::Run() or Discard()
+		intrusive_ptr_add_ref(next.get());
+		next->m_successor.pool = pool;
+		AddContinuation(&next->m_successor);
+	}
+	
+	Task::Successor::Successor(Task& task) :
+	pool(NULL),
+	m_task(task)
+	{
+	}
+	
+	void Task::Successor::Run(ThreadPool& current)
+	{
+		// Adopts the reference taken by Chain(), the Task may be executed
+		// and released as soon as it is scheduled
+		TaskRef task(&m_task, false);
+		(pool ? *pool : current).ScheduleTaskForExecution(task);
+	}
+	
+	void Task::Successor::Discard(void)
+	{
+		TaskRef task(&m_task, false);
+		
+		// The antecedent will never be over: neither will the Task, which
+		// Future reports as TaskCancelled
+		WorkerThread *worker = WorkerThread::Current();
+		task->Complete(CancelledFlag | RunningFlag, worker ? worker->GetPool() : ThreadPool::Default());
+	}
+	
+	void Task::AddContinuation(priv::Continuation *c)
+	{
+		c->next = m_continuations;
+		
+		while (c->next != priv::ClosedList)
+		{
+			if (m_continuations.compare_exchange_weak(c->next, c))
+				return;
+		}
+		
+		// Already over
+		WorkerThread *worker = WorkerThread::Current();
+		c->Run(worker ? worker->GetPool() : ThreadPool::Default());
+	}
+	
+	Priority Task::GetPriority(void) const
+	{
+		return m_priority;
+	}
+	
+	void Task::SetDeadline(Uint64 deadline)
+	{
+		m_deadline = deadline;
+	}
+	
+	Uint64 Task::GetDeadline(void) const
+	{
+		return m_deadline;
+	}
+	
+	void Task::SetNode(int node)
+	{
+		m_node = node;
+	}
+	
+	int Task::GetNode(void) const
+	{
+		return m_node;
+	}
+	
 	void Task::SetInput(std::map<std::string, void *>& inputValues)
 	{
 		input = inputValues;
 	}
 	
-	void Task::Execute(WorkerThread& owner)
+	bool Task::Execute(WorkerThread& owner)
 	{
-		// Save the worker thread from which we're executing the task
+		ThreadPool& pool = owner.GetPool();
+		
+		// Save the worker thread from which we're executing the task,
+		// Abort() relies on it while the callback runs
 		m_owner = &owner;
-		Execute();
+		Uint32 over = RunCallback(pool);
+		
+		// Be done with the Task before completing it: its continuations
+		// may execute it again right away, see TaskGraph
+		m_owner = NULL;
+		
+		if (over)
+			pool.CheckDeadline(*this);
+		
+		return Complete(over, pool);
 	}
 	
-	void Task::Execute(void)
+	bool Task::Execute(void)
 	{
-		m_threadId = Thread::GetCurrentThreadId();
+		ThreadPool& pool = ThreadPool::Default();
+		return Complete(RunCallback(pool), pool);
+	}
+	
+	Uint32 Task::RunCallback(ThreadPool& pool)
+	{
+		// Completes the Task if the callback throws, so that its waiters and
+		// continuations are not left behind
+		struct CompletionGuard {
+			CompletionGuard(Task& task, ThreadPool& pool) :
+			task(task),
+			pool(pool),
+			isArmed(true)
+			{
+			}
+			
+			~CompletionGuard(void)
+			{
+				if (isArmed)
+				{
+					task.m_owner = NULL;
+					task.Complete(0, pool);
+				}
+			}
+			
+			Task& task;
+			ThreadPool& pool;
+			bool isArmed;
+		};
+		
+		m_threadId.store(Thread::GetCurrentThreadId(), std::memory_order_relaxed);
 		
-		if (!m_isCancelled)
+		CompletionGuard guard(*this, pool);
+		Uint32 over = 0;
+		
+		if (!(m_state.fetch_or(RunningFlag) & CancelledFlag))
 		{
 			m_callback(this);
-			m_isOver = true;
+			over = OverFlag;
 		}
 		
-		m_taskDone = 1;
+		guard.isArmed = false;
+		return over;
+	}
+	
+	bool Task::Complete(Uint32 flags, ThreadPool& pool)
+	{
+		Uint32 previous = m_state.fetch_or(flags | DoneFlag, std::memory_order_acq_rel);
+		
+		// Aborted: Abort() has finished the Task already
+		if (previous & DoneFlag)
+			return false;
+		
+		Finish(previous, pool);
+		return true;
+	}
+	
+	void Task::Finish(Uint32 previousState, ThreadPool& current)
+	{
+		// Only go to the kernel when somebody is actually waiting
+		if (previousState & WaiterFlag)
+			priv::FutexImpl::wakeAll(m_state);
+		
+		if (previousState & HelperFlag)
+		{
+			ThreadPool *pool = m_helperPool.exchange(NULL);
+			
+			if (pool)
+				pool->WakeHelpers();
+		}
+		
+		RunContinuations(current);
+	}
+	
+	void Task::RunContinuations(ThreadPool& current)
+	{
+		// Last access to the Task, see Reset()
+		priv::Continuation *c = m_continuations.exchange(priv::ClosedList);
+		priv::Continuation *ordered = NULL;
+		
+		// The list is built in reverse order of registration
+		while (c)
+		{
+			priv::Continuation *next = c->next;
+			c->next = ordered;
+			ordered = c;
+			c = next;
+		}
+		
+		while (ordered)
+		{
+			priv::Continuation *next = ordered->next;
+			ordered->Run(current);
+			ordered = next;
+		}
 	}
 	
 } // namespace awl
@@ -0,0 +1,267 @@
+
+/*
+ *  TaskGraph.cpp
+ *  Awl - Asynchronous Work Library
+ *
+ *  Copyright (c) 2011 Lucas Soltic
+ *  ceylow@gmail.com
+ *
+ *  This software is provided 'as-is', without any express or implied warranty.
+ *  In no event will the authors be held liable for any damages arising from
+ *  the use of this software.
+ *
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute it freely,
+ *  subject to the following restrictions:
+ *
+ *  1. The origin of this software must not be misrepresented;
+ *     you must not claim that you wrote the original software.
+ *     If you use this software in a product, an acknowledgment
+ *     in the product documentation would be appreciated but is not required.
+ *
+ *  2. Altered source versions must be plainly marked as such,
+ *     and must not be misrepresented as being the original software.
+ *
+ *  3. This notice may not be removed or altered from any source distribution.
+ *
+ */
+#include <Awl/TaskGraph.hpp>
+#include <Awl/ThreadPool.hpp>
+#include <Awl/Continuation.hpp>
+#include <Awl/Err.hpp>
+#include <Awl/boost/bind.hpp>
+#include <ostream>
+
+namespace awl {
+	
+	namespace priv {
+		
+		/** @brief Task of a TaskGraph node, which completes its node once
+		 * over, even when skipped
+		 */
+		class GraphTask : public Task {
+		public:
+			GraphTask(TaskGraph& graph, TaskGraph::Node node, Callback f) :
+			Task(std::move(f)),
+			m_node(graph, node)
+			{
+			}
+			
+			~GraphTask(void)
+			{
+				DiscardContinuations();
+			}
+			
+			Continuation& GetNode(void)
+			{
+				return m_node;
+			}
+			
+		private:
+			// Embedded in the Task and registered again by each run
+			class Node : public Continuation {
+			public:
+				Node(TaskGraph& graph, TaskGraph::Node node) :
+				m_graph(graph),
+				m_node(node)
+				{
+				}
+				
+				void Run(ThreadPool&)
+				{
+					m_graph.CompleteNode(m_node);
+				}
+				
+				void Discard(void)
+				{
+					// The graph waits for its nodes before destroying them,
+					// thus only a graph that never ran gets there
+				}
+				
+			private:
+				TaskGraph& m_graph;
+				TaskGraph::Node m_node;
+			};
+			
+			Node m_node;
+		};
+		
+	} // namespace priv
+	
+	TaskGraph::TaskGraph(void) :
+	m_nodes(),
+	m_roots(),
+	m_remainingPredecessors(NULL),
+	m_isBuilt(false),
+	m_pool(NULL),
+	m_done(0)
+	{
+	}
+	
+	TaskGraph::~TaskGraph(void)
+	{
+		Wait();
+		delete[] m_remainingPredecessors;
+	}
+	
+	TaskGraph::Node TaskGraph::AddNode(Callback f)
+	{
+		NodeData data;
+		data.callback = std::move(f);
+		data.predecessorCount = 0;
+		
+		m_nodes.push_back(std::move(data));
+		m_isBuilt = false;
+		return m_nodes.size() - 1;
+	}
+	
+	void TaskGraph::AddEdge(Node predecessor, Node successor)
+	{
+		m_nodes[predecessor].successors.push_back(successor);
+		m_nodes[successor].predecessorCount++;
+		m_isBuilt = false;
+	}
+	
+	size_t TaskGraph::GetNodeCount(void) const
+	{
+		return m_nodes.size();
+	}
+	
+	bool TaskGraph::Run(ThreadPool& pool)
+	{
+		if (IsRunning())
+		{
+			Err() << "TaskGraph::Run() - the graph is already running" << std::endl;
+			return false;
+		}
+		
+		if (m_nodes.empty())
+			return true;
+		
+		if (!m_isBuilt)
+		{
+			if (HasCycle())
+			{
+				Err() << "TaskGraph::Run() - the graph contains a cycle" << std::endl;
+				return false;
+			}
+			
+			Build();
+		}
+		
+		for (Node i = 0; i < m_nodes.size(); i++)
+		{
+			TaskRef& task = m_nodes[i].task;
+			
+			task->Reset();
+			task->AddContinuation(&static_cast<priv::GraphTask&>(*task).GetNode());
+			m_remainingPredecessors[i] = m_nodes[i].predecessorCount;
+		}
+		
+		m_pool = &pool;
+		m_done.Add(m_nodes.size());
+		pool.ScheduleTasks(m_roots);
+		return true;
+	}
+	
+	bool TaskGraph::Run(void)
+	{
+		return Run(ThreadPool::Default());
+	}
+	
+	bool TaskGraph::IsRunning(void) const
+	{
+		return !m_done.IsReleased();
+	}
+	
+	void TaskGraph::Wait(void)
+	{
+		m_done.Wait();
+	}
+	
+	bool TaskGraph::HasCycle(void) const
+	{
+		// Kahn's algorithm: a node can only be visited once all of its
+		// predecessors have been, which never happens in a cycle
+		std::vector<size_t> remaining(m_nodes.size());
+		std::vector<Node> ready;
+		size_t visited = 0;
+		
+		for (Node i = 0; i < m_nodes.size(); i++)
+		{
+			remaining[i] = m_nodes[i].predecessorCount;
+			
+			if (remaining[i] == 0)
+				ready.push_back(i);
+		}
+		
+		while (!ready.empty())
+		{
+			Node node = ready.back();
+			ready.pop_back();
+			visited++;
+			
+			for (size_t i = 0; i < m_nodes[node].successors.size(); i++)
+			{
+				Node successor = m_nodes[node].successors[i];
+				
+				if (--remaining[successor] == 0)
+					ready.push_back(successor);
+			}
+		}
+		
+		return visited != m_nodes.size();
+	}
+	
+	void TaskGraph::Build(void)
+	{
+		delete[] m_remainingPredecessors;
+		m_remainingPredecessors = new std::atomic<size_t>[m_nodes.size()];
+		m_roots.clear();
+		
+		for (Node i = 0; i < m_nodes.size(); i++)
+		{
+			NodeData& data = m_nodes[i];
+			
+			data.task.reset(new priv::GraphTask(*this, i, boost::bind(&TaskGraph::ExecuteNode, this, i, _1)));
+			data.readySuccessors.clear();
+			data.readySuccessors.reserve(data.successors.size());
+			
+			if (data.predecessorCount == 0)
+				m_roots.push_back(data.task);
+		}
+		
+		m_isBuilt = true;
+	}
+	
+	void TaskGraph::ExecuteNode(Node node, Task *self)
+	{
+		m_nodes[node].callback(self);
+	}
+	
+	void TaskGraph::CompleteNode(Node node)
+	{
+		NodeData& data = m_nodes[node];
+		
+		// Each node completes once per run, thus owns its buffer
+		for (size_t i = 0; i < data.successors.size(); i++)
+		{
+			Node successor = data.successors[i];
+			
+			if (--m_remainingPredecessors[successor] == 0)
+				data.readySuccessors.push_back(m_nodes[successor].task);
+		}
+		
+		// A single ready successor does not need the batch
+		if (data.readySuccessors.size() == 1)
+			m_pool->ScheduleTaskForExecution(data.readySuccessors[0]);
+		else
+			m_pool->ScheduleTasks(data.readySuccessors);
+		
+		data.readySuccessors.clear();
+		
+		// Last access to the graph, which may be destroyed right after
+		m_done.CountDown();
+	}
+	
+} // namespace awl
@@ -0,0 +1,142 @@
+
+/*
+ *  TaskGroup.cpp
+ *  Awl - Asynchronous Work Library
+ *
+ *  Copyright (c) 2011 Lucas Soltic
+ *  ceylow@gmail.com
+ *
+ *  This software is provided 'as-is', without any express or implied warranty.
+ *  In no event will the authors be held liable for any damages arising from
+ *  the use of this software.
+ *
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute it freely,
+ *  subject to the following restrictions:
+ *
+ *  1. The origin of this software must not be misrepresented;
+ *     you must not claim that you wrote the original software.
+ *     If you use this software in a product, an acknowledgment
+ *     in the product documentation would be appreciated but is not required.
+ *
+ *  2. Altered source versions must be plainly marked as such,
+ *     and must not be misrepresented as being the original software.
+ *
+ *  3. This notice may not be removed or altered from any source distribution.
+ *
+ */
+#include <Awl/TaskGroup.hpp>
+#include <Awl/ThreadPool.hpp>
+#include <Awl/Continuation.hpp>
+
+namespace awl {
+	
+	namespace priv {
+		
+		/** @brief Task of a TaskGroup, which counts itself down once over,
+		 * even when skipped
+		 */
+		class GroupTask : public Task {
+		public:
+			GroupTask(const TaskGroup& group, Latch& pending, Callback f) :
+			Task(&GroupTask::Call),
+			m_group(group),
+			m_function(std::move(f)),
+			m_node(pending)
+			{
+			}
+			
+			~GroupTask(void)
+			{
+				DiscardContinuations();
+			}
+			
+			Continuation& GetNode(void)
+			{
+				return m_node;
+			}
+			
+		private:
+			// Embedded in the Task, thus does not need to be allocated
+			class Node : public Continuation {
+			public:
+				Node(Latch& pending) :
+				m_pending(pending)
+				{
+				}
+				
+				void Run(ThreadPool&)
+				{
+					m_pending.CountDown();
+				}
+				
+				void Discard(void)
+				{
+					m_pending.CountDown();
+				}
+				
+			private:
+				Latch& m_pending;
+			};
+			
+			static void Call(Task *self)
+			{
+				GroupTask *task = static_cast<GroupTask *>(self);
+				
+				if (!task->m_group.IsCancelled())
+					task->m_function(self);
+			}
+			
+			const TaskGroup& m_group;
+			Callback m_function;
+			Node m_node;
+		};
+		
+	} // namespace priv
+	
+	TaskGroup::TaskGroup(void) :
+	m_pool(ThreadPool::Default()),
+	m_pending(0),
+	m_isCancelled(false)
+	{
+	}
+	
+	TaskGroup::TaskGroup(ThreadPool& pool) :
+	m_pool(pool),
+	m_pending(0),
+	m_isCancelled(false)
+	{
+	}
+	
+	TaskGroup::~TaskGroup(void)
+	{
+		Wait();
+	}
+	
+	TaskRef TaskGroup::Spawn(Callback f)
+	{
+		priv::GroupTask *task = new priv::GroupTask(*this, m_pending, std::move(f));
+		TaskRef t(task);
+		
+		m_pending.Add();
+		t->AddContinuation(&task->GetNode());
+		m_pool.ScheduleTaskForExecution(t);
+		return t;
+	}
+	
+	void TaskGroup::Cancel(void)
+	{
+		m_isCancelled = true;
+	}
+	
+	bool TaskGroup::IsCancelled(void) const
+	{
+		return m_isCancelled;
+	}
+	
+	void TaskGroup::Wait(void)
+	{
+		m_pending.Wait();
+	}
+	
+} // namespace awl
@@ -0,0 +1,101 @@
+
+/*
+ *  TaskRing.cpp
+ *  Awl - Asynchronous Work Library
+ *
+ *  Copyright (c) 2011 Lucas Soltic
+ *  ceylow@gmail.com
+ *
+ *  This software is provided 'as-is', without any express or implied warranty.
+ *  In no event will the authors be held liable for any damages arising from
+ *  the use of this software.
+ *
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute it freely,
+ *  subject to the following restrictions:
+ *
+ *  1. The origin of this software must not be misrepresented;
+ *     you must not claim that you wrote the original software.
+ *     If you use this software in a product, an acknowledgment
+ *     in the product documentation would be appreciated but is not required.
+ *
+ *  2. Altered source versions must be plainly marked as such,
+ *     and must not be misrepresented as being the original software.
+ *
+ *  3. This notice may not be removed or altered from any source distribution.
+ *
+ */
+#include <Awl/TaskRing.hpp>
+
+namespace awl {
+	namespace priv {
+		
+		namespace {
+			const size_t InitialCapacity = 64;
+		}
+		
+		TaskRing::TaskRing(void) :
+		m_slots(),
+		m_head(0),
+		m_size(0)
+		{
+		}
+		
+		void TaskRing::PushBack(TaskRef t)
+		{
+			if (m_size == m_slots.size())
+				Grow();
+			
+			m_slots[(m_head + m_size) & (m_slots.size() - 1)] = std::move(t);
+			m_size++;
+		}
+		
+		const TaskRef& TaskRing::Front(void) const
+		{
+			return m_slots[m_head];
+		}
+		
+		void TaskRing::PopFront(void)
+		{
+			m_slots[m_head].reset();
+			m_head = (m_head + 1) & (m_slots.size() - 1);
+			m_size--;
+		}
+		
+		void TaskRing::TakeFront(TaskRef& t)
+		{
+			t.swap(m_slots[m_head]);
+			PopFront();
+		}
+		
+		void TaskRing::TakeBack(TaskRef& t)
+		{
+			TaskRef& slot = m_slots[(m_head + m_size - 1) & (m_slots.size() - 1)];
+			t.swap(slot);
+			slot.reset();
+			m_size--;
+		}
+		
+		size_t TaskRing::GetSize(void) const
+		{
+			return m_size;
+		}
+		
+		bool TaskRing::IsEmpty(void) const
+		{
+			return m_size == 0;
+		}
+		
+		void TaskRing::Grow(void)
+		{
+			std::vector<TaskRef> slots(m_slots.empty() ? InitialCapacity : 2 * m_slots.size());
+			
+			for (size_t i = 0; i < m_size; i++)
+				slots[i].swap(m_slots[(m_head + i) & (m_slots.size() - 1)]);
+			
+			m_slots.swap(slots);
+			m_head = 0;
+		}
+		
+	} // namespace priv
+} // namespace awl
@@ -0,0 +1,81 @@
+
+/*
+ *  TaskRing.hpp
+ *  Awl - Asynchronous Work Library
+ *
+ *  Copyright (c) 2011 Lucas Soltic
+ *  ceylow@gmail.com
+ *
+ *  This software is provided 'as-is', without any express or implied warranty.
+ *  In no event will the authors be held liable for any damages arising from
+ *  the use of this software.
+ *
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute it freely,
+ *  subject to the following restrictions:
+ *
+ *  1. The origin of this software must not be misrepresented;
+ *     you must not claim that you wrote the original software.
+ *     If you use this software in a product, an acknowledgment
+ *     in the product documentation would be appreciated but is not required.
+ *
+ *  2. Altered source versions must be plainly marked as such,
+ *     and must not be misrepresented as being the original software.
+ *
+ *  3. This notice may not be removed or altered from any source distribution.
+ *
+ */
+#ifndef Awl_TaskRing_hpp
+#define Awl_TaskRing_hpp
+
+#include <Awl/boost/noncopyable.hpp>
+#include <Awl/Task.hpp>
+#include <vector>
+
+namespace awl {
+	namespace priv {
+		
+		/** @brief Double-ended queue of tasks stored in a circular buffer
+		 *
+		 * @details Unlike std::deque, the buffer is kept once grown so that
+		 * a queue that keeps filling up and draining doesn't allocate
+		 * anything. Not thread-safe.
+		 */
+		class TaskRing : boost::noncopyable {
+		public:
+			TaskRing(void);
+			
+			void PushBack(TaskRef t);
+			
+			/** @brief Returns the oldest task, the ring must not be empty
+			 */
+			const TaskRef& Front(void) const;
+			
+			/** @brief Removes the oldest task
+			 */
+			void PopFront(void);
+			
+			/** @brief Moves the oldest task to @a t, the ring must not be empty
+			 */
+			void TakeFront(TaskRef& t);
+			
+			/** @brief Moves the newest task to @a t, the ring must not be empty
+			 */
+			void TakeBack(TaskRef& t);
+			
+			size_t GetSize(void) const;
+			bool IsEmpty(void) const;
+			
+		private:
+			void Grow(void);
+			
+			// The size of the buffer is always a power of 2
+			std::vector<TaskRef> m_slots;
+			size_t m_head;
+			size_t m_size;
+		};
+		
+	} // namespace priv
+} // namespace awl
+
+#endif // Awl_TaskRing_hpp
@@ -44,7 +44,8 @@
 namespace awl
 {
 	namespace {
-		Uint64 g_mainThreadId = 0;
+		// Static initialization happens on the main thread
+		Uint64 g_mainThreadId = priv::ThreadImpl::CurrentThreadId();
 	}
 	
 	Uint64 Thread::GetCurrentThreadId(void)
@@ -57,6 +58,11 @@ namespace awl
 		return g_mainThreadId;
 	}
 	
+	bool Thread::SetCurrentThreadAffinity(const std::vector<unsigned>& cpus)
+	{
+		return priv::ThreadImpl::SetCurrentAffinity(cpus);
+	}
+	
 	////////////////////////////////////////////////////////////
 	Thread::~Thread()
 	{
@@ -103,10 +109,4 @@ namespace awl
 		myFunction->Run();
 	}
 	
-	// Registered by the global thread pool at construction time
-	void Thread::RegisterMainThread(void)
-	{
-		g_mainThreadId = GetCurrentThreadId();
-	}
-	
 } // namespace awl
@@ -28,22 +28,155 @@
 
 #include <Awl/ThreadPool.hpp>
 #include <Awl/WorkerThread.hpp>
+#include <Awl/WorkQueue.hpp>
+#include <Awl/SpawnDeque.hpp>
+#include <Awl/PendingQueue.hpp>
+#include <Awl/InjectionQueue.hpp>
+#include <Awl/EventCount.hpp>
 #include <Awl/Mutex.hpp>
 #include <Awl/Lock.hpp>
 #include <Awl/Debug.hpp>
 #include <Awl/Thread.hpp>
+#include <Awl/Platform.hpp>
+#include <algorithm>
 
 namespace awl {
-
-	namespace {
-		ThreadPool shared(1, 1, 1);
+	
+	// Times read by different threads are not ordered: never wrap around
+	static Uint64 GetElapsedTime(Uint64 now, Uint64 since)
+	{
+		return now > since ? now - since : 0;
 	}
 	
-#define THREAD_COUNT 10
+	ThreadPool::ThreadPool(unsigned workerCount) :
+	m_settings(workerCount),
+	m_workerCpus(),
+	m_nodeCpus(),
+	m_workerNodes(),
+	m_nodeQueues(),
+	m_pendingMutex(),
+	m_workAvailable(new priv::EventCount()),
+	m_nextAgingTime(0),
+	m_workersMutex(),
+	m_workers(),
+	m_retiredWorkers(),
+	m_localQueues(),
+	m_workerCount(0),
+	m_isSpawningWorker(false),
+	m_isDying(false),
+	m_queuedTaskCount(0),
+	m_unfinishedTaskCount(0),
+	m_idleWorkerCount(0),
+	m_deadlineTaskCount(0),
+	m_deadlineMissCount(0),
+	m_allTasksDone(1),
+	m_isAlive(true)
+	{
+		Init();
+	}
+	
+	ThreadPool::ThreadPool(const PoolSettings& settings) :
+	m_settings(settings),
+	m_workerCpus(),
+	m_nodeCpus(),
+	m_workerNodes(),
+	m_nodeQueues(),
+	m_pendingMutex(),
+	m_workAvailable(new priv::EventCount()),
+	m_nextAgingTime(0),
+	m_workersMutex(),
+	m_workers(),
+	m_retiredWorkers(),
+	m_localQueues(),
+	m_workerCount(0),
+	m_isSpawningWorker(false),
+	m_isDying(false),
+	m_queuedTaskCount(0),
+	m_unfinishedTaskCount(0),
+	m_idleWorkerCount(0),
+	m_deadlineTaskCount(0),
+	m_deadlineMissCount(0),
+	m_allTasksDone(1),
+	m_isAlive(true)
+	{
+		Init();
+	}
+	
+	void ThreadPool::Init(void)
+	{
+		for (int i = 0; i < PriorityLevels;i++)
+		{
+			m_pendingTasks[i] = priv::PendingQueue::Create(m_settings.scheduling);
+			m_injectedTasks[i] = NULL;
+			
+			// Deadline ordering needs the locked heap
+			if (m_settings.scheduling == FifoScheduling && m_settings.injectionQueueSize > 0)
+				m_injectedTasks[i] = new priv::InjectionQueue(m_settings.injectionQueueSize);
+			m_pendingTaskCount[i] = 0;
+		}
+		
+		if (m_settings.maxWorkers == 0)
+			m_settings.maxWorkers = priv::Platform::GetCpuCount();
+		
+		if (m_settings.minWorkers == 0)
+			m_settings.minWorkers = 1;
+		
+		if (m_settings.minWorkers > m_settings.maxWorkers)
+			m_settings.minWorkers = m_settings.maxWorkers;
+		
+		// Aging promotes the oldest tasks, which the deadline heaps can't tell
+		if (m_settings.scheduling == DeadlineScheduling)
+			m_settings.priorityAging = 0;
+		
+		if (m_settings.numaAware)
+		{
+			m_nodeCpus = priv::Platform::GetNumaNodes();
+			
+			for (unsigned i = 0; i < m_nodeCpus.size();i++)
+			{
+				m_nodeQueues.push_back(new priv::WorkQueue());
+				
+				if (!m_nodeCpus[i].empty())
+					m_workerNodes.push_back(i);
+			}
+		}
+		else if (m_settings.affinity != NoAffinity)
+		{
+			m_workerCpus = m_settings.cpuSet;
+			
+			// The allowed processors may not be numbered from 0 when the
+			// process is restricted to some of them
+			if (m_workerCpus.empty())
+				m_workerCpus = priv::Platform::GetAllowedCpus();
+			
+			if (m_settings.reserveMainThreadCpu && m_workerCpus.size() > 1)
+				m_workerCpus.erase(m_workerCpus.begin());
+		}
+		
+		for (unsigned i = 0; i < m_settings.maxWorkers;i++)
+		{
+			m_localQueues.push_back(new priv::WorkQueue());
+			m_spawnDeques.push_back(new priv::SpawnDeque());
+			m_workers.push_back(NULL);
+		}
+		
+		Lock l(m_workersMutex);
+		for (unsigned i = 0; i < m_settings.minWorkers;i++)
+		{
+			m_workers[i] = new WorkerThread(*this, *m_localQueues[i], *m_spawnDeques[i], i);
+			m_workerCount++;
+		}
+	}
+	
+	ThreadPool::~ThreadPool()
+	{
+		DoWaitAndDie();
+		delete m_workAvailable;
+	}
 	
 	ThreadPool& ThreadPool::Default()
 	{
-		shared.Init();
+		static ThreadPool shared;
 		return shared;
 	}
 	
@@ -52,91 +185,884 @@ namespace awl {
 		Default().DoWaitAndDie();
 	}
 	
+	unsigned ThreadPool::GetNodeCount(void) const
+	{
+		return (unsigned)m_nodeCpus.size();
+	}
+	
+	unsigned ThreadPool::GetWorkerCount(void) const
+	{
+		return m_workerCount;
+	}
+	
+	const PoolSettings& ThreadPool::GetSettings(void) const
+	{
+		return m_settings;
+	}
+	
+	Uint64 ThreadPool::GetDeadlineTaskCount(void) const
+	{
+		return m_deadlineTaskCount;
+	}
+	
+	Uint64 ThreadPool::GetDeadlineMissCount(void) const
+	{
+		return m_deadlineMissCount;
+	}
+	
 	void ThreadPool::ScheduleTaskForExecution(TaskRef t)
 	{
-		m_hasPendingTask.Lock();
-		m_pendingTasks.push(t);
-		m_hasPendingTask.Unlock(1);
-		//m_hasPendingTask = 1;
+		ScheduleTaskForExecution(std::move(t), NormalPriority);
+	}
+	
+	void ThreadPool::ScheduleTaskForExecution(TaskRef t, Priority priority)
+	{
+		m_unfinishedTaskCount++;
+		t->m_priority = priority;
+		
+		WorkerThread *worker = WorkerThread::Current();
+		
+		switch (GetRoute(*t, worker))
+		{
+			case NodeRoute:
+			{
+				// Keep it on the node that owns its data
+				priv::WorkQueue& queue = *m_nodeQueues[t->m_node];
+				queue.Push(std::move(t));
+				m_queuedTaskCount++;
+				
+				if (m_idleWorkerCount > 0)
+					WakeUpWorker();
+				break;
+			}
+				
+			case LocalRoute:
+				// Spawned from a task: keep it local to the spawning worker,
+				// and only bother the other workers if some of them are idle
+				worker->m_queue.Push(std::move(t));
+				m_queuedTaskCount++;
+				
+				if (m_idleWorkerCount > 0)
+					WakeUpWorker();
+				break;
+				
+			case SharedRoute:
+				t->m_scheduleTime = priv::Platform::GetMonotonicTime();
+				PushPendingTask(std::move(t), priority);
+				break;
+		}
+		
+		// Checked here too as the workers may all be blocked, and never
+		// get to check the wait time of the tasks they pop
+		if (m_settings.IsElastic() && ShouldSpawnWorker() &&
+			(m_queuedTaskCount > (int)(m_settings.spawnQueueDepth * m_workerCount) || HasStalledTasks()))
+		{
+			SpawnWorker();
+		}
+	}
+	
+	void ThreadPool::ScheduleTasks(const std::vector<TaskRef>& tasks, Priority priority)
+	{
+		if (tasks.empty())
+			return;
+		
+		m_unfinishedTaskCount += (int)tasks.size();
+		
+		WorkerThread *worker = WorkerThread::Current();
+		Uint64 now = priv::Platform::GetMonotonicTime();
+		size_t localTaskCount = 0;
+		std::vector<TaskRef> lockedTasks;
+		
+		for (size_t i = 0; i < tasks.size();i++)
+		{
+			const TaskRef& t = tasks[i];
+			t->m_priority = priority;
+			
+			switch (GetRoute(*t, worker))
+			{
+				case NodeRoute:
+					m_nodeQueues[t->m_node]->Push(t);
+					m_queuedTaskCount++;
+					break;
+					
+				case LocalRoute:
+					localTaskCount++;
+					break;
+					
+				case SharedRoute:
+				{
+					TaskRef shared(t);
+					shared->m_scheduleTime = now;
+					
+					if (!InjectPendingTask(shared, priority))
+						lockedTasks.push_back(std::move(shared));
+					break;
+				}
+			}
+		}
+		
+		// Usual case for tasks scheduled by a worker: no copy needed
+		if (localTaskCount == tasks.size())
+		{
+			worker->m_queue.PushBatch(tasks);
+		}
+		else if (localTaskCount > 0)
+		{
+			std::vector<TaskRef> localTasks;
+			
+			for (size_t i = 0; i < tasks.size();i++)
+			{
+				if (GetRoute(*tasks[i], worker) == LocalRoute)
+					localTasks.push_back(tasks[i]);
+			}
+			
+			worker->m_queue.PushBatch(localTasks);
+		}
+		
+		m_queuedTaskCount += (int)localTaskCount;
+		
+		if (!lockedTasks.empty())
+		{
+			// One lock for all of them
+			Lock l(m_pendingMutex);
+			
+			for (size_t i = 0; i < lockedTasks.size();i++)
+				m_pendingTasks[priority]->Push(std::move(lockedTasks[i]));
+			
+			m_pendingTaskCount[priority] += (int)lockedTasks.size();
+			m_queuedTaskCount += (int)lockedTasks.size();
+		}
+		
+		// And one wake up: each woken worker wakes up the next one
+		// while tasks remain
+		if (m_idleWorkerCount > 0)
+			WakeUpWorker();
+		
+		// Checked here too as the workers may all be blocked, and never
+		// get to check the wait time of the tasks they pop
+		if (m_settings.IsElastic() && ShouldSpawnWorker() &&
+			(m_queuedTaskCount > (int)(m_settings.spawnQueueDepth * m_workerCount) || HasStalledTasks()))
+		{
+			SpawnWorker();
+		}
+	}
+	
+	ThreadPool::Route ThreadPool::GetRoute(const Task& t, WorkerThread *worker) const
+	{
+		// Deadline ordering needs all the tasks in the shared queue,
+		// and only normal priority tasks may bypass it
+		if (t.m_priority != NormalPriority || m_settings.scheduling != FifoScheduling)
+			return SharedRoute;
+		
+		bool isOurWorker = (worker && &worker->m_pool == this);
+		
+		if (IsValidNode(t.m_node) && !(isOurWorker && worker->m_node == t.m_node))
+			return NodeRoute;
+		else if (isOurWorker)
+			return LocalRoute;
+		else
+			return SharedRoute;
 	}
 	
 	void ThreadPool::KillWorkerThread(WorkerThread *worker)
 	{
-		std::set<WorkerThread *>::iterator it = m_threads.find(worker);
+		{
+			Lock l(m_workersMutex);
+			
+			if (worker->m_index >= m_workers.size() || m_workers[worker->m_index] != worker)
+			{
+				MT_DEBUG_COUT(std::cout << "Worker thread not found in list." << std::endl);
+				return;
+			}
+			
+			// The replacement worker takes over the local queues of the killed one
+			m_workers[worker->m_index] = new WorkerThread(*this, worker->m_queue, worker->m_frames, worker->m_index);
+			
+			// Killed workers are joined by the next retiring worker, or
+			// when the pool dies
+			m_retiredWorkers.push_back(worker);
+		}
+		
+		// The aborted task will never complete by itself
+		TaskDone();
+		worker->Die();
+	}
+	
+	bool ThreadPool::ExecutePendingTask(void)
+	{
+		WorkerThread *worker = WorkerThread::Current();
+		TaskRef t;
+		
+		if (!worker || &worker->m_pool != this)
+			return false;
+		
+		if (!TryGetTask(*worker, t))
+			return StealFrame(*worker);
+		
+		worker->Execute(t);
+		return true;
+	}
+	
+	bool ThreadPool::NeedsMoreTasks(void) const
+	{
+		WorkerThread *worker = WorkerThread::Current();
+		
+		if (m_idleWorkerCount > 0)
+			return true;
+		
+		// Thieves emptied our queue: the other workers are hungry too
+		return (worker && &worker->m_pool == this && m_workerCount > 1 &&
+				worker->m_queue.IsEmpty());
+	}
+	
+	bool ThreadPool::WaitForTask(WorkerThread& worker, TaskRef& t)
+	{
+		while (!TryGetTask(worker, t))
+		{
+			if (StealFrame(worker))
+				continue;
+			
+			if (!WaitForPendingTask(worker))
+				return false;
+		}
+		
+		return true;
+	}
+	
+	bool ThreadPool::TryGetTask(WorkerThread& worker, TaskRef& t)
+	{
+		// Reading the clock on each pop is too costly: a worker busy with
+		// its local queue only checks for aging every few pops
+		if (m_settings.priorityAging > 0 &&
+			(++worker.m_popCount % AgingCheckInterval == 0 || worker.m_queue.IsEmpty()) &&
+			priv::Platform::GetMonotonicTime() >= m_nextAgingTime)
+		{
+			AgePendingTasks();
+		}
+		
+		// Bands are drained in order: shared high priority tasks first,
+		// then normal priority tasks (local, node, shared, stolen), and
+		// finally shared low priority tasks
+		if (PopPendingTask(t, HighPriority) || worker.m_queue.Pop(t) ||
+			(worker.m_node >= 0 && m_nodeQueues[worker.m_node]->Steal(t)))
+		{
+			m_queuedTaskCount--;
+			return true;
+		}
+		
+		if (PopPendingTask(t, NormalPriority))
+		{
+			m_queuedTaskCount--;
+			RefillLocalQueue(worker);
+			
+			// Tasks wait for too long, more workers are needed
+			if (m_settings.IsElastic() && ShouldSpawnWorker() &&
+				GetElapsedTime(priv::Platform::GetMonotonicTime(), t->m_scheduleTime) > m_settings.spawnWaitTime)
+			{
+				SpawnWorker();
+			}
+			
+			return true;
+		}
+		
+		if (StealTask(worker, t) || PopPendingTask(t, LowPriority))
+		{
+			m_queuedTaskCount--;
+			return true;
+		}
+		
+		return false;
+	}
+	
+	bool ThreadPool::WaitForPendingTask(WorkerThread& worker, Uint32 timeout)
+	{
+		if (SpinForPendingTask(worker))
+			return true;
+		
+		// Nothing to do: declare ourselves as idle before checking one last
+		// time for queued tasks, so that a concurrent scheduling either
+		// sees us idle and wakes us up, or is seen by the check below
+		m_idleWorkerCount++;
+		Uint32 key = m_workAvailable->PrepareWait();
+		
+		if (m_queuedTaskCount > 0 || HasStealableFrames(worker) || m_isDying)
+		{
+			m_workAvailable->CancelWait();
+			m_idleWorkerCount--;
+			return !m_isDying;
+		}
 		
-		if (it != m_threads.end())
+		if (timeout > 0)
+		{
+			// The caller has other things to do later on, never retire
+			m_workAvailable->Wait(key, timeout);
+		}
+		else if (m_settings.IsElastic() && m_workerCount > (int)m_settings.minWorkers)
 		{
-			m_threads.insert(m_threads.end(), new WorkerThread());
-			(*it)->Die();
+			if (!m_workAvailable->Wait(key, m_settings.keepAlive) && !m_isDying)
+			{
+				// Timed out, we've been idle for long enough
+				m_idleWorkerCount--;
+				return !RetireWorker(worker);
+			}
 		}
 		else
 		{
-			MT_DEBUG_COUT(std::cout << "Worker thread not found in list." << std::endl);
+			m_workAvailable->Wait(key);
 		}
+		
+		// Wake up the next worker in cascade while there is work left,
+		// so that submitters only ever have to wake up a single one
+		if (m_queuedTaskCount > 0 && m_idleWorkerCount > 1)
+			m_workAvailable->NotifyOne();
+		
+		m_idleWorkerCount--;
+		return !m_isDying;
+	}
+	
+	void ThreadPool::HelpUntil(WorkerThread& worker, bool (*isDone)(const void *), const void *object)
+	{
+		while (!isDone(object))
+		{
+			if (ExecutePendingTask())
+				continue;
+			
+			// Same protocol as WaitForPendingTask(): a scheduling either
+			// sees us idle and wakes us up, or is seen by the check below
+			m_idleWorkerCount++;
+			Uint32 key = m_workAvailable->PrepareWait();
+			
+			if (isDone(object) || m_queuedTaskCount > 0 || HasStealableFrames(worker))
+				m_workAvailable->CancelWait();
+			else
+				m_workAvailable->Wait(key);
+			
+			m_idleWorkerCount--;
+		}
+	}
+	
+	void ThreadPool::WakeHelpers(void)
+	{
+		// The idle workers go back to sleep, the helpers check their wait
+		m_workAvailable->NotifyAll();
 	}
 	
-	bool ThreadPool::WaitForTask(TaskRef& t)
+	bool ThreadPool::SpinForPendingTask(WorkerThread& worker)
 	{
-		bool res = m_hasPendingTask.WaitAndLock(1);
+		// Short waits are cheaper to spin through than to park for. The spin
+		// length adapts: it's doubled when spinning pays off and halved when
+		// the worker has to park anyway
+		for (unsigned i = 0; i < worker.m_spinLimit;i++)
+		{
+			if (m_queuedTaskCount > 0 || HasStealableFrames(worker))
+			{
+				worker.m_spinLimit = std::min(worker.m_spinLimit * 2, m_settings.idleSpinCount);
+				return true;
+			}
+			
+			priv::Platform::CpuRelax();
+		}
 		
-		if (res)
+		for (unsigned i = 0; i < m_settings.idleYieldCount;i++)
 		{
-			t = m_pendingTasks.front();
-			m_pendingTasks.pop();
-			m_hasPendingTask.Unlock(HasPendingTask_unprotected());
+			if (m_queuedTaskCount > 0 || HasStealableFrames(worker))
+				return true;
+			
+			priv::Platform::YieldThread();
 		}
 		
-		return res;
+		worker.m_spinLimit = std::max(worker.m_spinLimit / 2, m_settings.idleSpinCount / 16);
+		return false;
 	}
 	
-	void ThreadPool::DoWaitAndDie()
+	bool ThreadPool::InjectPendingTask(TaskRef& t, Priority priority)
 	{
-		m_hasPendingTask.WaitAndLock(0, Condition::AutoUnlock);
-		m_hasPendingTask.Invalidate();
+		if (!m_injectedTasks[priority])
+			return false;
 		
-		// Clean threads' set
+		m_queuedTaskCount++;
 		
-		while (!m_threads.empty())
+		if (m_injectedTasks[priority]->TryPush(t, t->m_scheduleTime))
+			return true;
+		
+		// Full, the caller falls back to the locked queue
+		m_queuedTaskCount--;
+		return false;
+	}
+	
+	void ThreadPool::PushPendingTask(TaskRef t, Priority priority)
+	{
+		if (InjectPendingTask(t, priority))
 		{
-			std::set<WorkerThread *>::iterator it = m_threads.begin();
-			WorkerThread *w = *it;
-			delete w;
-			m_threads.erase(it);
+			// Same protocol as for the local queues: the condition
+			// is only touched when a worker may be parked on it
+			if (m_idleWorkerCount > 0)
+				WakeUpWorker();
+			
+			return;
 		}
+		
+		{
+			Lock l(m_pendingMutex);
+			m_pendingTasks[priority]->Push(std::move(t));
+			m_pendingTaskCount[priority]++;
+			m_queuedTaskCount++;
+		}
+		
+		if (m_idleWorkerCount > 0)
+			WakeUpWorker();
 	}
-
 	
-	ThreadPool::ThreadPool(int, int, int)
+	bool ThreadPool::PopPendingTask(TaskRef& t, Priority lowest)
 	{
-		Thread::RegisterMainThread();
+		for (int i = 0; i <= lowest;i++)
+		{
+			if (m_injectedTasks[i] && m_injectedTasks[i]->TryPop(t))
+				return true;
+			
+			// Avoid locking the shared queue when we know the band is empty
+			if (m_pendingTaskCount[i] == 0)
+				continue;
+			
+			Lock l(m_pendingMutex);
+			
+			if (!m_pendingTasks[i]->IsEmpty())
+			{
+				t = m_pendingTasks[i]->Front();
+				m_pendingTasks[i]->Pop();
+				m_pendingTaskCount[i]--;
+				return true;
+			}
+		}
+		
+		return false;
 	}
 	
-	void ThreadPool::Init(void)
+	void ThreadPool::RefillLocalQueue(WorkerThread& worker)
 	{
-		static awl::Mutex initMutex;
-		static bool initialized = false;
+		if (m_settings.dequeueBatchSize <= 1 || m_settings.scheduling != FifoScheduling)
+			return;
+		
+		// Take our share of the queued tasks at most, so that the other
+		// workers don't have to steal them back from us
+		size_t limit = m_settings.dequeueBatchSize - 1;
+		size_t share = (size_t)std::max(0, (int)m_queuedTaskCount) / std::max(1, (int)m_workerCount);
+		limit = std::min(limit, share);
 		
-		awl::Lock l(initMutex);
-		if (!initialized)
+		if (limit == 0)
+			return;
+		
+		// Reserved by the worker, to keep the refill allocation-free
+		std::vector<TaskRef>& batch = worker.m_refillBatch;
+		TaskRef t;
+		
+		while (batch.size() < limit && m_injectedTasks[NormalPriority] &&
+			   m_injectedTasks[NormalPriority]->TryPop(t))
+		{
+			batch.push_back(std::move(t));
+		}
+		
+		if (batch.size() < limit && m_pendingTaskCount[NormalPriority] > 0)
 		{
-			for (int i = 0; i < THREAD_COUNT;i++)
+			priv::PendingQueue& band = *m_pendingTasks[NormalPriority];
+			Lock l(m_pendingMutex);
+			
+			while (batch.size() < limit && !band.IsEmpty())
 			{
-				WorkerThread *w = new WorkerThread();
-				m_threads.insert(m_threads.end(), w);
+				batch.push_back(band.Front());
+				band.Pop();
+				m_pendingTaskCount[NormalPriority]--;
 			}
-			initialized = true;
+		}
+		
+		if (!batch.empty())
+		{
+			// We pop from the back of our queue: keep the oldest there
+			std::reverse(batch.begin(), batch.end());
+			worker.m_queue.PushBatch(batch);
+			batch.clear();
 		}
 	}
 	
+	void ThreadPool::AgePendingTasks(void)
+	{
+		Uint64 now = priv::Platform::GetMonotonicTime();
+		Uint64 next = m_nextAgingTime;
+		
+		// Only one worker ages the tasks in each period
+		if (now < next || !m_nextAgingTime.compare_exchange_strong(next, now + m_settings.priorityAging / 2))
+			return;
+		
+		for (int i = HighPriority + 1; i < PriorityLevels && m_injectedTasks[i];i++)
+		{
+			Uint64 scheduleTime;
+			TaskRef oldest;
+			
+			for (unsigned j = 0; j < m_settings.maxWorkers;j++)
+			{
+				if (!m_injectedTasks[i]->PeekScheduleTime(scheduleTime) ||
+					GetElapsedTime(now, scheduleTime) < m_settings.priorityAging ||
+					!m_injectedTasks[i]->TryPop(oldest))
+				{
+					break;
+				}
+				
+				// We may have raced with a worker and popped a younger task,
+				// it's still the oldest one of its band
+				oldest->m_scheduleTime = now;
+				oldest->m_priority = (Priority)(i - 1);
+				m_queuedTaskCount--;
+				PushPendingTask(std::move(oldest), (Priority)(i - 1));
+			}
+		}
+		
+		if (m_pendingTaskCount[NormalPriority] == 0 && m_pendingTaskCount[LowPriority] == 0)
+			return;
+		
+		Lock l(m_pendingMutex);
+		
+		// Promote the oldest tasks of each band, a few at a time to
+		// avoid holding the lock for too long
+		for (int i = HighPriority + 1; i < PriorityLevels;i++)
+		{
+			priv::PendingQueue& band = *m_pendingTasks[i];
+			
+			for (unsigned j = 0; j < m_settings.maxWorkers && !band.IsEmpty();j++)
+			{
+				const TaskRef& oldest = band.Front();
+				
+				if (GetElapsedTime(now, oldest->m_scheduleTime) < m_settings.priorityAging)
+					break;
+				
+				oldest->m_scheduleTime = now;
+				oldest->m_priority = (Priority)(i - 1);
+				m_pendingTasks[i - 1]->Push(oldest);
+				m_pendingTaskCount[i - 1]++;
+				band.Pop();
+				m_pendingTaskCount[i]--;
+			}
+		}
+	}
 	
-	ThreadPool::~ThreadPool()
+	bool ThreadPool::StealTask(WorkerThread& thief, TaskRef& t)
 	{
-		DoWaitAndDie();
+		size_t count = m_localQueues.size();
+		
+		if (m_workerNodes.size() <= 1)
+		{
+			for (size_t i = 1; i < count; i++)
+			{
+				priv::WorkQueue *victim = m_localQueues[(thief.m_index + i) % count];
+				
+				if (victim->Steal(t))
+					return true;
+			}
+			
+			return false;
+		}
+		
+		// Steal from the workers of our node first, and only then from the
+		// other nodes: we've got nothing to do on ours anymore
+		for (size_t i = 1; i < count; i++)
+		{
+			unsigned victim = (thief.m_index + i) % count;
+			
+			if (GetWorkerNode(victim) == thief.m_node && m_localQueues[victim]->Steal(t))
+				return true;
+		}
+		
+		for (size_t i = 1; i < m_nodeQueues.size(); i++)
+		{
+			if (m_nodeQueues[(thief.m_node + i) % m_nodeQueues.size()]->Steal(t))
+				return true;
+		}
+		
+		for (size_t i = 1; i < count; i++)
+		{
+			unsigned victim = (thief.m_index + i) % count;
+			
+			if (GetWorkerNode(victim) != thief.m_node && m_localQueues[victim]->Steal(t))
+				return true;
+		}
+		
+		return false;
 	}
 	
-	bool ThreadPool::HasPendingTask_unprotected(void)
+	bool ThreadPool::StealFrame(WorkerThread& thief)
 	{
-		return (m_pendingTasks.empty() == false);
+		size_t count = m_spawnDeques.size();
+		
+		for (size_t i = 1; i < count; i++)
+		{
+			priv::SpawnFrame *frame = m_spawnDeques[(thief.m_index + i) % count]->Steal();
+			
+			if (frame)
+			{
+				std::atomic<Uint32> *done = frame->stolenDone;
+				frame->run(frame);
+				
+				// Last access to the frame, its scope may be synced right away.
+				// The owner of the scope may be parked in HelpUntil()
+				done->fetch_add(1, std::memory_order_release);
+				WakeHelpers();
+				return true;
+			}
+		}
+		
+		return false;
+	}
+	
+	bool ThreadPool::HasStealableFrames(const WorkerThread& thief) const
+	{
+		size_t count = m_spawnDeques.size();
+		
+		for (size_t i = 1; i < count; i++)
+		{
+			if (!m_spawnDeques[(thief.m_index + i) % count]->IsEmpty())
+				return true;
+		}
+		
+		return false;
+	}
+	
+	void ThreadPool::FrameSpawned(void)
+	{
+		// Deliberately unfenced: a worker going idle concurrently may miss
+		// this frame, the owner runs it anyway and the next spawn wakes it
+		if (m_idleWorkerCount.load(std::memory_order_relaxed) > 0)
+			WakeUpWorker();
+	}
+	
+	void ThreadPool::WakeUpWorker(void)
+	{
+		m_workAvailable->NotifyOne();
+	}
+	
+	void ThreadPool::TaskDone(void)
+	{
+		if (--m_unfinishedTaskCount == 0)
+			m_allTasksDone = 1;
+	}
+	
+	void ThreadPool::CheckDeadline(const Task& t)
+	{
+		if (t.m_deadline == Task::NoDeadline)
+			return;
+		
+		m_deadlineTaskCount++;
+		
+		if (priv::Platform::GetMonotonicTime() > t.m_deadline)
+			m_deadlineMissCount++;
+	}
+	
+	void ThreadPool::ApplyAffinity(unsigned workerIndex)
+	{
+		int node = GetWorkerNode(workerIndex);
+		
+		if (node >= 0)
+		{
+			const std::vector<unsigned>& cpus = m_nodeCpus[node];
+			
+			if (m_settings.affinity == PinWorkersToCores)
+			{
+				unsigned cpu = cpus[(workerIndex / m_workerNodes.size()) % cpus.size()];
+				Thread::SetCurrentThreadAffinity(std::vector<unsigned>(1, cpu));
+			}
+			else if (m_workerNodes.size() > 1)
+			{
+				Thread::SetCurrentThreadAffinity(cpus);
+			}
+			
+			return;
+		}
+		
+		if (m_workerCpus.empty())
+			return;
+		
+		if (m_settings.affinity == PinWorkersToCores)
+		{
+			std::vector<unsigned> cpu(1, m_workerCpus[workerIndex % m_workerCpus.size()]);
+			Thread::SetCurrentThreadAffinity(cpu);
+		}
+		else
+		{
+			Thread::SetCurrentThreadAffinity(m_workerCpus);
+		}
+	}
+	
+	int ThreadPool::GetWorkerNode(unsigned workerIndex) const
+	{
+		if (m_workerNodes.empty())
+			return -1;
+		else
+			return (int)m_workerNodes[workerIndex % m_workerNodes.size()];
+	}
+	
+	bool ThreadPool::IsValidNode(int node) const
+	{
+		return (node >= 0 && (size_t)node < m_nodeQueues.size() && !m_nodeCpus[node].empty());
+	}
+	
+	bool ThreadPool::ShouldSpawnWorker(void) const
+	{
+		return (m_idleWorkerCount == 0 &&
+				m_workerCount < (int)m_settings.maxWorkers &&
+				!m_isSpawningWorker && !m_isDying);
+	}
+	
+	bool ThreadPool::HasStalledTasks(void)
+	{
+		Uint64 now = priv::Platform::GetMonotonicTime();
+		
+		// Only the first task of each band is looked at: the oldest one
+		// with FifoScheduling, the most urgent one with DeadlineScheduling
+		for (int i = 0; i < PriorityLevels;i++)
+		{
+			Uint64 scheduleTime;
+			
+			if (m_injectedTasks[i] && m_injectedTasks[i]->PeekScheduleTime(scheduleTime) &&
+				GetElapsedTime(now, scheduleTime) > m_settings.spawnWaitTime)
+			{
+				return true;
+			}
+			
+			if (m_pendingTaskCount[i] == 0)
+				continue;
+			
+			Lock l(m_pendingMutex);
+			
+			if (!m_pendingTasks[i]->IsEmpty() &&
+				GetElapsedTime(now, m_pendingTasks[i]->Front()->m_scheduleTime) > m_settings.spawnWaitTime)
+			{
+				return true;
+			}
+		}
+		
+		return false;
+	}
+	
+	void ThreadPool::SpawnWorker(void)
+	{
+		// Only one spawn at a time, concurrent requests are dropped
+		if (m_isSpawningWorker.exchange(true))
+			return;
+		
+		{
+			Lock l(m_workersMutex);
+			
+			for (unsigned i = 0; i < m_workers.size() && !m_isDying;i++)
+			{
+				if (m_workers[i] == NULL)
+				{
+					m_workers[i] = new WorkerThread(*this, *m_localQueues[i], *m_spawnDeques[i], i);
+					m_workerCount++;
+					break;
+				}
+			}
+		}
+		
+		m_isSpawningWorker = false;
+	}
+	
+	bool ThreadPool::RetireWorker(WorkerThread& worker)
+	{
+		std::vector<WorkerThread *> retired;
+		
+		{
+			Lock l(m_workersMutex);
+			
+			if (m_isDying || m_workerCount <= (int)m_settings.minWorkers)
+				return false;
+			
+			// Our local queue is empty as we were idle, and nobody else pushes to it
+			m_workers[worker.m_index] = NULL;
+			m_workerCount--;
+			
+			// The workers that retired before us are joined here rather
+			// than by SpawnWorker(), which runs on the scheduling path
+			retired.swap(m_retiredWorkers);
+			m_retiredWorkers.push_back(&worker);
+		}
+		
+		ReleaseWorkers(retired);
+		return true;
+	}
+	
+	void ThreadPool::ReleaseWorkers(const std::vector<WorkerThread *>& workers)
+	{
+		// Waits for the threads to exit, never called with m_workersMutex
+		// locked as exiting workers may still need it
+		for (unsigned i = 0; i < workers.size();i++)
+			delete workers[i];
+	}
+	
+	void ThreadPool::DoWaitAndDie()
+	{
+		if (!m_isAlive)
+			return;
+		
+		// Tasks may still be spawned by running tasks, so wait until
+		// there is no unfinished task at all
+		for (;;)
+		{
+			m_allTasksDone.WaitAndLock(1);
+			m_allTasksDone.Unlock(0);
+			
+			if (m_unfinishedTaskCount == 0)
+				break;
+		}
+		
+		m_isDying = true;
+		m_workAvailable->NotifyAll();
+		
+		// Release the worker threads, without holding the lock as
+		// exiting workers may still need it
+		std::vector<WorkerThread *> workers;
+		
+		{
+			Lock l(m_workersMutex);
+			
+			for (unsigned i = 0; i < m_workers.size();i++)
+			{
+				if (m_workers[i])
+					workers.push_back(m_workers[i]);
+				m_workers[i] = NULL;
+			}
+			
+			workers.insert(workers.end(), m_retiredWorkers.begin(), m_retiredWorkers.end());
+			m_retiredWorkers.clear();
+			m_workerCount = 0;
+		}
+		
+		ReleaseWorkers(workers);
+		
+		while (!m_localQueues.empty())
+		{
+			delete m_localQueues.back();
+			m_localQueues.pop_back();
+		}
+		
+		while (!m_spawnDeques.empty())
+		{
+			delete m_spawnDeques.back();
+			m_spawnDeques.pop_back();
+		}
+		
+		while (!m_nodeQueues.empty())
+		{
+			delete m_nodeQueues.back();
+			m_nodeQueues.pop_back();
+		}
+		
+		for (int i = 0; i < PriorityLevels;i++)
+		{
+			delete m_injectedTasks[i];
+			m_injectedTasks[i] = NULL;
+			delete m_pendingTasks[i];
+			m_pendingTasks[i] = NULL;
+		}
+		
+		m_isAlive = false;
 	}
 
 } // namespace awl
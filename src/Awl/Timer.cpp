@@ -0,0 +1,77 @@
+
+/*
+ *  Timer.cpp
+ *  Awl - Asynchronous Work Library
+ *
+ *  Copyright (c) 2011 Lucas Soltic
+ *  ceylow@gmail.com
+ *
+ *  This software is provided 'as-is', without any express or implied warranty.
+ *  In no event will the authors be held liable for any damages arising from
+ *  the use of this software.
+ *
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute it freely,
+ *  subject to the following restrictions:
+ *
+ *  1. The origin of this software must not be misrepresented;
+ *     you must not claim that you wrote the original software.
+ *     If you use this software in a product, an acknowledgment
+ *     in the product documentation would be appreciated but is not required.
+ *
+ *  2. Altered source versions must be plainly marked as such,
+ *     and must not be misrepresented as being the original software.
+ *
+ *  3. This notice may not be removed or altered from any source distribution.
+ *
+ */
+#include <Awl/Timer.hpp>
+#include <Awl/TimerService.hpp>
+#include <Awl/Time.hpp>
+
+namespace awl {
+	
+	static TaskRef StartTimer(ThreadPool& pool, Uint64 time, Uint32 period, Callback f)
+	{
+		priv::TimerTask *timer = new priv::TimerTask(pool, std::move(f), period);
+		timer->expiry = time;
+		
+		TaskRef t(timer);
+		priv::TimerService::Default().Arm(t);
+		return t;
+	}
+	
+	TaskRef AsyncCallAfter(Uint32 delay, Callback f)
+	{
+		return AsyncCallAfter(ThreadPool::Default(), delay, std::move(f));
+	}
+	
+	TaskRef AsyncCallAfter(ThreadPool& pool, Uint32 delay, Callback f)
+	{
+		return StartTimer(pool, GetMonotonicTime() + delay, 0, std::move(f));
+	}
+	
+	TaskRef AsyncCallAt(Uint64 time, Callback f)
+	{
+		return AsyncCallAt(ThreadPool::Default(), time, std::move(f));
+	}
+	
+	TaskRef AsyncCallAt(ThreadPool& pool, Uint64 time, Callback f)
+	{
+		return StartTimer(pool, time, 0, std::move(f));
+	}
+	
+	TaskRef AsyncCallEvery(Uint32 period, Callback f)
+	{
+		return AsyncCallEvery(ThreadPool::Default(), period, std::move(f));
+	}
+	
+	TaskRef AsyncCallEvery(ThreadPool& pool, Uint32 period, Callback f)
+	{
+		if (period == 0)
+			period = 1;
+		
+		return StartTimer(pool, GetMonotonicTime() + period, period, std::move(f));
+	}
+	
+} // namespace awl
@@ -0,0 +1,212 @@
+
+/*
+ *  TimerService.cpp
+ *  Awl - Asynchronous Work Library
+ *
+ *  Copyright (c) 2011 Lucas Soltic
+ *  ceylow@gmail.com
+ *
+ *  This software is provided 'as-is', without any express or implied warranty.
+ *  In no event will the authors be held liable for any damages arising from
+ *  the use of this software.
+ *
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute it freely,
+ *  subject to the following restrictions:
+ *
+ *  1. The origin of this software must not be misrepresented;
+ *     you must not claim that you wrote the original software.
+ *     If you use this software in a product, an acknowledgment
+ *     in the product documentation would be appreciated but is not required.
+ *
+ *  2. Altered source versions must be plainly marked as such,
+ *     and must not be misrepresented as being the original software.
+ *
+ *  3. This notice may not be removed or altered from any source distribution.
+ *
+ */
+#include <Awl/TimerService.hpp>
+#include <Awl/ThreadPool.hpp>
+#include <Awl/Lock.hpp>
+#include <Awl/Time.hpp>
+#include <Awl/boost/bind.hpp>
+
+namespace awl {
+	namespace priv {
+		
+		TimerTask::TimerTask(ThreadPool& pool, Callback f, Uint32 period) :
+		// A one-shot timer runs as itself, a periodic one through Tick()
+		Task(period == 0 ? std::move(f) : Callback()),
+		TimerLink(),
+		m_pool(pool),
+		m_function(std::move(f)),
+		m_period(period),
+		m_self()
+		{
+		}
+		
+		void TimerTask::OnCancel(void)
+		{
+			TimerService::Default().Disarm(*this);
+		}
+		
+		void TimerTask::Tick(const TaskRef& series, Task *)
+		{
+			TimerTask& timer = static_cast<TimerTask&>(*series);
+			
+			if (!timer.IsCancelled())
+				timer.m_function(series.get());
+			
+			// Keep the original phase, skipping the calls that are too late
+			Uint64 now = GetMonotonicTime();
+			timer.expiry += timer.m_period;
+			
+			if (timer.expiry <= now)
+				timer.expiry += ((now - timer.expiry) / timer.m_period + 1) * timer.m_period;
+			
+			TimerService::Default().Arm(series);
+		}
+		
+		TimerService& TimerService::Default(void)
+		{
+			static TimerService shared;
+			return shared;
+		}
+		
+		TimerService::TimerService(void) :
+		m_mutex(),
+		m_wheel(GetMonotonicTime()),
+		m_wakeUp(),
+		m_wakeTime(0),
+		m_isRunning(true),
+		m_expired(),
+		m_due(),
+		m_thread(&TimerService::ThreadCallback, this)
+		{
+			m_thread.Launch();
+		}
+		
+		TimerService::~TimerService(void)
+		{
+			{
+				Lock l(m_mutex);
+				m_isRunning = false;
+			}
+			
+			m_wakeUp.NotifyAll();
+			m_thread.Wait();
+			
+			// Pending timers are dropped without being scheduled
+			m_wheel.Clear(m_expired);
+			
+			for (size_t i = 0; i < m_expired.size(); i++)
+				static_cast<TimerTask *>(m_expired[i])->m_self.reset();
+			
+			m_expired.clear();
+		}
+		
+		void TimerService::Arm(const TaskRef& task)
+		{
+			TimerTask& timer = static_cast<TimerTask&>(*task);
+			bool isCancelled = timer.IsCancelled();
+			bool wakeUp = false;
+			
+			if (!isCancelled)
+			{
+				Lock l(m_mutex);
+				
+				// Checked again as Disarm() relies on the lock
+				isCancelled = timer.IsCancelled();
+				
+				if (!isCancelled)
+				{
+					timer.m_self = task;
+					m_wheel.Insert(timer);
+					
+					// Only bother the timer thread if it sleeps for too long
+					wakeUp = (m_wakeTime == 0 || timer.expiry < m_wakeTime);
+				}
+			}
+			
+			if (isCancelled)
+				timer.m_pool.ScheduleTaskForExecution(task);
+			else if (wakeUp)
+				m_wakeUp.NotifyOne();
+		}
+		
+		void TimerService::Disarm(TimerTask& task)
+		{
+			TaskRef self;
+			
+			{
+				Lock l(m_mutex);
+				
+				if (!task.IsLinked())
+					return;
+				
+				m_wheel.Remove(task);
+				self.swap(task.m_self);
+			}
+			
+			task.m_pool.ScheduleTaskForExecution(self);
+		}
+		
+		void TimerService::ThreadCallback(void)
+		{
+			while (true)
+			{
+				Uint32 key;
+				Uint64 wakeTime;
+				
+				{
+					Lock l(m_mutex);
+					
+					if (!m_isRunning)
+						break;
+					
+					m_wheel.Advance(GetMonotonicTime(), m_expired);
+					CollectExpired();
+					
+					m_wakeTime = m_wheel.GetNextWakeTime();
+					wakeTime = m_wakeTime;
+					key = m_wakeUp.PrepareWait();
+				}
+				
+				for (size_t i = 0; i < m_due.size(); i++)
+					m_due[i].first->ScheduleTaskForExecution(m_due[i].second);
+				
+				m_due.clear();
+				
+				Uint32 timeout = 0;
+				
+				if (wakeTime != 0)
+				{
+					Uint64 now = GetMonotonicTime();
+					timeout = (wakeTime > now) ? (Uint32)(wakeTime - now) : 1;
+				}
+				
+				m_wakeUp.Wait(key, timeout);
+			}
+		}
+		
+		void TimerService::CollectExpired(void)
+		{
+			for (size_t i = 0; i < m_expired.size(); i++)
+			{
+				TimerTask& timer = static_cast<TimerTask&>(*m_expired[i]);
+				TaskRef self;
+				self.swap(timer.m_self);
+				
+				// Periodic timers run each call in a separate Task, and
+				// complete once cancelled
+				if (timer.m_period != 0 && !timer.IsCancelled())
+					self = Task::Create(boost::bind(&TimerTask::Tick, self, _1));
+				
+				m_due.push_back(std::make_pair(&timer.m_pool, std::move(self)));
+			}
+			
+			m_expired.clear();
+		}
+		
+	} // namespace priv
+} // namespace awl
@@ -0,0 +1,109 @@
+
+/*
+ *  TimerService.hpp
+ *  Awl - Asynchronous Work Library
+ *
+ *  Copyright (c) 2011 Lucas Soltic
+ *  ceylow@gmail.com
+ *
+ *  This software is provided 'as-is', without any express or implied warranty.
+ *  In no event will the authors be held liable for any damages arising from
+ *  the use of this software.
+ *
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute it freely,
+ *  subject to the following restrictions:
+ *
+ *  1. The origin of this software must not be misrepresented;
+ *     you must not claim that you wrote the original software.
+ *     If you use this software in a product, an acknowledgment
+ *     in the product documentation would be appreciated but is not required.
+ *
+ *  2. Altered source versions must be plainly marked as such,
+ *     and must not be misrepresented as being the original software.
+ *
+ *  3. This notice may not be removed or altered from any source distribution.
+ *
+ */
+#ifndef Awl_TimerService_hpp
+#define Awl_TimerService_hpp
+
+#include <Awl/boost/noncopyable.hpp>
+#include <Awl/Config.hpp>
+#include <Awl/EventCount.hpp>
+#include <Awl/Mutex.hpp>
+#include <Awl/Task.hpp>
+#include <Awl/Thread.hpp>
+#include <Awl/TimingWheel.hpp>
+#include <utility>
+#include <vector>
+
+namespace awl {
+	class ThreadPool;
+	
+	namespace priv {
+		
+		/** @brief Task that waits in the TimerService before being scheduled
+		 */
+		class TimerTask : public Task, public TimerLink {
+			friend class TimerService;
+		public:
+			/** @param period 0 for a single call, the time between two
+			 * calls otherwise
+			 */
+			TimerTask(ThreadPool& pool, Callback f, Uint32 period);
+			
+		protected:
+			void OnCancel(void);
+			
+		private:
+			// Runs one call of a periodic TimerTask
+			static void Tick(const TaskRef& series, Task *self);
+			
+			ThreadPool& m_pool;
+			Callback m_function;
+			Uint32 m_period;
+			
+			// Reference held by the timing wheel while the timer is armed
+			TaskRef m_self;
+		};
+		
+		/** @brief Thread that schedules the TimerTasks once they're due
+		 */
+		class TimerService : boost::noncopyable {
+		public:
+			static TimerService& Default(void);
+			
+			/** @brief Starts waiting for the expiry of @a task, which must
+			 * be a TimerTask
+			 */
+			void Arm(const TaskRef& task);
+			
+			/** @brief Removes @a task from the wheel if it's still there,
+			 * and schedules it so that it completes
+			 */
+			void Disarm(TimerTask& task);
+			
+		private:
+			TimerService(void);
+			~TimerService(void);
+			
+			void ThreadCallback(void);
+			
+			// Takes the reference of the wheel on expired timers
+			void CollectExpired(void);
+			
+			Mutex m_mutex;
+			TimingWheel m_wheel;
+			EventCount m_wakeUp;
+			Uint64 m_wakeTime;
+			bool m_isRunning;
+			std::vector<TimerLink *> m_expired;
+			std::vector<std::pair<ThreadPool *, TaskRef> > m_due;
+			Thread m_thread;
+		};
+		
+	} // namespace priv
+} // namespace awl
+
+#endif // Awl_TimerService_hpp
@@ -0,0 +1,226 @@
+
+/*
+ *  TimingWheel.cpp
+ *  Awl - Asynchronous Work Library
+ *
+ *  Copyright (c) 2011 Lucas Soltic
+ *  ceylow@gmail.com
+ *
+ *  This software is provided 'as-is', without any express or implied warranty.
+ *  In no event will the authors be held liable for any damages arising from
+ *  the use of this software.
+ *
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute it freely,
+ *  subject to the following restrictions:
+ *
+ *  1. The origin of this software must not be misrepresented;
+ *     you must not claim that you wrote the original software.
+ *     If you use this software in a product, an acknowledgment
+ *     in the product documentation would be appreciated but is not required.
+ *
+ *  2. Altered source versions must be plainly marked as such,
+ *     and must not be misrepresented as being the original software.
+ *
+ *  3. This notice may not be removed or altered from any source distribution.
+ *
+ */
+#include <Awl/TimingWheel.hpp>
+
+namespace awl {
+	namespace priv {
+		
+		TimerLink::TimerLink(void) :
+		prev(NULL),
+		next(NULL),
+		expiry(0)
+		{
+		}
+		
+		bool TimerLink::IsLinked(void) const
+		{
+			return next != NULL;
+		}
+		
+		TimingWheel::TimingWheel(Uint64 now) :
+		m_currentTick(now),
+		m_size(0)
+		{
+			for (unsigned level = 0; level < LevelCount; level++)
+			{
+				for (unsigned slot = 0; slot < SlotCount; slot++)
+				{
+					m_slots[level][slot].prev = &m_slots[level][slot];
+					m_slots[level][slot].next = &m_slots[level][slot];
+				}
+			}
+		}
+		
+		void TimingWheel::Insert(TimerLink& link)
+		{
+			Place(link);
+			m_size++;
+		}
+		
+		void TimingWheel::Remove(TimerLink& link)
+		{
+			Unlink(link);
+			m_size--;
+		}
+		
+		size_t TimingWheel::GetSize(void) const
+		{
+			return m_size;
+		}
+		
+		void TimingWheel::Advance(Uint64 now, std::vector<TimerLink *>& expired)
+		{
+			if (m_size == 0)
+			{
+				if (now > m_currentTick)
+					m_currentTick = now;
+				
+				return;
+			}
+			
+			while (m_currentTick < now)
+			{
+				// Jump over the empty slots at once
+				Uint64 tick = FindNextTick();
+				
+				if (tick > now)
+				{
+					m_currentTick = now;
+					break;
+				}
+				
+				m_currentTick = tick;
+				
+				// Move the entries of the upper levels down whenever the
+				// lower level wraps around, uppermost first
+				if ((m_currentTick & SlotMask) == 0)
+				{
+					unsigned top = 1;
+					
+					while (top < LevelCount - 1 && ((m_currentTick >> (top * SlotBits)) & SlotMask) == 0)
+						top++;
+					
+					for (unsigned level = top; level > 0; level--)
+						Cascade(level);
+				}
+				
+				TimerLink& head = m_slots[0][m_currentTick & SlotMask];
+				
+				while (head.next != &head)
+				{
+					TimerLink& link = *head.next;
+					Unlink(link);
+					
+					// Timers beyond the range of the wheel come back until due
+					if (link.expiry > m_currentTick)
+					{
+						Place(link);
+					}
+					else
+					{
+						m_size--;
+						expired.push_back(&link);
+					}
+				}
+			}
+		}
+		
+		Uint64 TimingWheel::GetNextWakeTime(void) const
+		{
+			if (m_size == 0)
+				return 0;
+			
+			return FindNextTick();
+		}
+		
+		Uint64 TimingWheel::FindNextTick(void) const
+		{
+			// Look for the next busy slot of the first level, up to the next
+			// cascade after which the first level has to be looked at again
+			Uint64 boundary = (m_currentTick | SlotMask) + 1;
+			
+			for (Uint64 tick = m_currentTick + 1; tick < boundary; tick++)
+			{
+				const TimerLink& head = m_slots[0][tick & SlotMask];
+				
+				if (head.next != &head)
+					return tick;
+			}
+			
+			return boundary;
+		}
+		
+		void TimingWheel::Clear(std::vector<TimerLink *>& entries)
+		{
+			for (unsigned level = 0; level < LevelCount; level++)
+			{
+				for (unsigned slot = 0; slot < SlotCount; slot++)
+				{
+					TimerLink& head = m_slots[level][slot];
+					
+					while (head.next != &head)
+					{
+						TimerLink& link = *head.next;
+						Unlink(link);
+						entries.push_back(&link);
+					}
+				}
+			}
+			
+			m_size = 0;
+		}
+		
+		void TimingWheel::Place(TimerLink& link)
+		{
+			// Expired timers fire on the next tick
+			Uint64 expiry = (link.expiry > m_currentTick) ? link.expiry : m_currentTick + 1;
+			Uint64 delta = expiry - m_currentTick;
+			unsigned level = 0;
+			
+			while (level < LevelCount - 1 && delta >= ((Uint64)1 << ((level + 1) * SlotBits)))
+				level++;
+			
+			// Too far: park in the furthest slot, Advance() puts it back
+			Uint64 range = (Uint64)1 << (LevelCount * SlotBits);
+			
+			if (delta >= range)
+				expiry = m_currentTick + range - 1;
+			
+			Link(m_slots[level][(expiry >> (level * SlotBits)) & SlotMask], link);
+		}
+		
+		void TimingWheel::Cascade(unsigned level)
+		{
+			TimerLink& head = m_slots[level][(m_currentTick >> (level * SlotBits)) & SlotMask];
+			
+			while (head.next != &head)
+			{
+				TimerLink& link = *head.next;
+				Unlink(link);
+				Place(link);
+			}
+		}
+		
+		void TimingWheel::Link(TimerLink& head, TimerLink& link)
+		{
+			link.prev = head.prev;
+			link.next = &head;
+			head.prev->next = &link;
+			head.prev = &link;
+		}
+		
+		void TimingWheel::Unlink(TimerLink& link)
+		{
+			link.prev->next = link.next;
+			link.next->prev = link.prev;
+			link.prev = NULL;
+			link.next = NULL;
+		}
+		
+	} // namespace priv
+} // namespace awl
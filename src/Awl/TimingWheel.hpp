@@ -0,0 +1,114 @@
+
+/*
+ *  TimingWheel.hpp
+ *  Awl - Asynchronous Work Library
+ *
+ *  Copyright (c) 2011 Lucas Soltic
+ *  ceylow@gmail.com
+ *
+ *  This software is provided 'as-is', without any express or implied warranty.
+ *  In no event will the authors be held liable for any damages arising from
+ *  the use of this software.
+ *
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute it freely,
+ *  subject to the following restrictions:
+ *
+ *  1. The origin of this software must not be misrepresented;
+ *     you must not claim that you wrote the original software.
+ *     If you use this software in a product, an acknowledgment
+ *     in the product documentation would be appreciated but is not required.
+ *
+ *  2. Altered source versions must be plainly marked as such,
+ *     and must not be misrepresented as being the original software.
+ *
+ *  3. This notice may not be removed or altered from any source distribution.
+ *
+ */
+#ifndef Awl_TimingWheel_hpp
+#define Awl_TimingWheel_hpp
+
+#include <Awl/boost/noncopyable.hpp>
+#include <Awl/Config.hpp>
+#include <cstddef>
+#include <vector>
+
+namespace awl {
+	namespace priv {
+		
+		/** @brief Entry of a TimingWheel, to be inherited by the timers
+		 */
+		struct TimerLink {
+			TimerLink(void);
+			
+			/** @brief Returns whether the entry is in a TimingWheel
+			 */
+			bool IsLinked(void) const;
+			
+			TimerLink *prev;
+			TimerLink *next;
+			
+			// Expiry time, in milliseconds
+			Uint64 expiry;
+		};
+		
+		/** @brief Hierarchical timing wheel with a resolution of a millisecond
+		 *
+		 * @details Each level has 256 slots, each slot of a level covering
+		 * the whole previous level. Entries are inserted in the level that
+		 * matches their distance to the current time and move down to the
+		 * lower levels as time goes on. Insertion and removal are O(1), and
+		 * advancing the wheel only visits the busy slots and the cascade
+		 * boundaries, plus the entries moved down. Not thread-safe.
+		 */
+		class TimingWheel : boost::noncopyable {
+		public:
+			/** @param now The current time, in milliseconds
+			 */
+			explicit TimingWheel(Uint64 now);
+			
+			void Insert(TimerLink& link);
+			void Remove(TimerLink& link);
+			
+			/** @brief Returns the number of entries in the wheel
+			 */
+			size_t GetSize(void) const;
+			
+			/** @brief Moves the current time to @a now and appends the
+			 * entries that have expired to @a expired, removing them
+			 */
+			void Advance(Uint64 now, std::vector<TimerLink *>& expired);
+			
+			/** @brief Returns the time at which Advance() should be called
+			 * next, or 0 if the wheel is empty
+			 */
+			Uint64 GetNextWakeTime(void) const;
+			
+			/** @brief Removes all the entries, appending them to @a entries
+			 */
+			void Clear(std::vector<TimerLink *>& entries);
+			
+		private:
+			enum {
+				LevelCount = 4,
+				SlotBits = 8,
+				SlotCount = 1 << SlotBits,
+				SlotMask = SlotCount - 1
+			};
+			
+			Uint64 FindNextTick(void) const;
+			void Place(TimerLink& link);
+			void Cascade(unsigned level);
+			static void Link(TimerLink& head, TimerLink& link);
+			static void Unlink(TimerLink& link);
+			
+			// Circular lists, each head being its own sentinel
+			TimerLink m_slots[LevelCount][SlotCount];
+			Uint64 m_currentTick;
+			size_t m_size;
+		};
+		
+	} // namespace priv
+} // namespace awl
+
+#endif // Awl_TimingWheel_hpp
@@ -27,6 +27,8 @@
  */
 
 #include <Awl/Unix/ConditionImpl.hpp>
+#include <sys/time.h>
+#include <errno.h>
 //#include "utils.h"
 #include <iostream>
 using namespace std;
@@ -85,6 +87,46 @@ namespace awl {
 			}
 		}
 		
+		bool ConditionImpl::timedWaitAndRetain(int value, unsigned int timeout)
+		{
+			timeval now = {0, 0};
+			gettimeofday(&now, NULL);
+			
+			Uint64 nsec = (Uint64)now.tv_usec * 1000 + (Uint64)(timeout % 1000) * 1000000;
+			timespec deadline;
+			deadline.tv_sec = now.tv_sec + timeout / 1000 + nsec / 1000000000;
+			deadline.tv_nsec = nsec % 1000000000;
+			
+			pthread_mutex_lock(&m_mutex);
+			
+			while (m_conditionnedVar != value && m_isValid)
+			{
+				if (ETIMEDOUT == pthread_cond_timedwait(&m_cond, &m_mutex, &deadline))
+					break;
+			}
+			
+			if (m_conditionnedVar == value && m_isValid)
+			{
+				return true;
+			}
+			else
+			{
+				pthread_mutex_unlock(&m_mutex);
+				return false;
+			}
+		}
+		
+		bool ConditionImpl::tryRetain(int value)
+		{
+			pthread_mutex_lock(&m_mutex);
+			
+			if (m_conditionnedVar == value && m_isValid)
+				return true;
+			
+			pthread_mutex_unlock(&m_mutex);
+			return false;
+		}
+		
 		void ConditionImpl::release(int value)
 		{
 			m_conditionnedVar = value;
@@ -142,6 +184,11 @@ namespace awl {
 			}
 		}
 		
+		bool ConditionImpl::isValid(void) const
+		{
+			return m_isValid;
+		}
+		
 	} // namespace priv
 } // namespace awl
 
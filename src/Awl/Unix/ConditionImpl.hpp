@@ -31,6 +31,7 @@
 #define Awl_ConditionImpl_hpp
 
 #include <pthread.h>
+#include <Awl/Config.hpp>
 namespace awl {
 	namespace priv {
 		
@@ -39,6 +40,8 @@ namespace awl {
 			ConditionImpl(int var);
 			~ConditionImpl(void);
 			bool waitAndRetain(int value);
+			bool timedWaitAndRetain(int value, unsigned int timeout);
+			bool tryRetain(int value);
 			void release(int value);
 			void lock(void);
 			void setValue(int value);
@@ -47,6 +50,7 @@ namespace awl {
 			void broadcast(void);
 			void invalidate(void);
 			void restore(void);
+			bool isValid(void) const;
 			
 		private:
 			int m_isValid;
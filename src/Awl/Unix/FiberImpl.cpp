@@ -0,0 +1,103 @@
+
+/*
+ *  Unix/FiberImpl.cpp
+ *  Awl - Asynchronous Work Library
+ *
+ *  Copyright (c) 2011 Lucas Soltic
+ *  ceylow@gmail.com
+ *
+ *  This software is provided 'as-is', without any express or implied warranty.
+ *  In no event will the authors be held liable for any damages arising from
+ *  the use of this software.
+ *
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute it freely,
+ *  subject to the following restrictions:
+ *
+ *  1. The origin of this software must not be misrepresented;
+ *     you must not claim that you wrote the original software.
+ *     If you use this software in a product, an acknowledgment
+ *     in the product documentation would be appreciated but is not required.
+ *
+ *  2. Altered source versions must be plainly marked as such,
+ *     and must not be misrepresented as being the original software.
+ *
+ *  3. This notice may not be removed or altered from any source distribution.
+ *
+ */
+
+#include <Awl/Unix/FiberImpl.hpp>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <iostream>
+
+namespace awl {
+	namespace priv {
+		
+		FiberImpl::FiberImpl(void) :
+		m_mapping(NULL),
+		m_mappingSize(0),
+		m_entry(NULL),
+		m_argument(NULL)
+		{
+		}
+		
+		FiberImpl::FiberImpl(size_t stackSize, void (*entry)(void *), void *argument) :
+		m_mapping(NULL),
+		m_mappingSize(0),
+		m_entry(entry),
+		m_argument(argument)
+		{
+			// The stack size is rounded up to whole pages, and not kept in a
+			// local variable that getcontext() could clobber
+			size_t pageSize = sysconf(_SC_PAGESIZE);
+			m_mappingSize = (stackSize + pageSize - 1) / pageSize * pageSize + pageSize;
+			
+			void *mapping = mmap(NULL, m_mappingSize, PROT_READ | PROT_WRITE,
+								 MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+			
+			if (mapping == MAP_FAILED)
+			{
+				std::cerr << "FiberImpl() - mmap() error\n";
+				return;
+			}
+			
+			// Stacks grow downwards: the guard page is the lowest one
+			m_mapping = static_cast<char *>(mapping);
+			
+			if (0 != mprotect(m_mapping, pageSize, PROT_NONE))
+				std::cerr << "FiberImpl() - mprotect() error\n";
+			
+			if (0 != getcontext(&m_context))
+				std::cerr << "FiberImpl() - getcontext() error\n";
+			
+			m_context.uc_stack.ss_sp = m_mapping + pageSize;
+			m_context.uc_stack.ss_size = m_mappingSize - pageSize;
+			m_context.uc_link = NULL;
+			
+			// makecontext() only passes int arguments
+			Uint64 self = reinterpret_cast<Uint64>(this);
+			makecontext(&m_context, (void (*)(void))&FiberImpl::start, 2,
+						(unsigned)(self >> 32), (unsigned)(self & 0xffffffff));
+		}
+		
+		FiberImpl::~FiberImpl(void)
+		{
+			if (m_mapping)
+				munmap(m_mapping, m_mappingSize);
+		}
+		
+		void FiberImpl::switchTo(FiberImpl& target)
+		{
+			if (0 != swapcontext(&m_context, &target.m_context))
+				std::cerr << "FiberImpl::switchTo() - swapcontext() error\n";
+		}
+		
+		void FiberImpl::start(unsigned high, unsigned low)
+		{
+			FiberImpl *self = reinterpret_cast<FiberImpl *>(((Uint64)high << 32) | low);
+			self->m_entry(self->m_argument);
+		}
+		
+	} // namespace priv
+} // namespace awl
@@ -0,0 +1,76 @@
+
+/*
+ *  Unix/FiberImpl.hpp
+ *  Awl - Asynchronous Work Library
+ *
+ *  Copyright (c) 2011 Lucas Soltic
+ *  ceylow@gmail.com
+ *
+ *  This software is provided 'as-is', without any express or implied warranty.
+ *  In no event will the authors be held liable for any damages arising from
+ *  the use of this software.
+ *
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute it freely,
+ *  subject to the following restrictions:
+ *
+ *  1. The origin of this software must not be misrepresented;
+ *     you must not claim that you wrote the original software.
+ *     If you use this software in a product, an acknowledgment
+ *     in the product documentation would be appreciated but is not required.
+ *
+ *  2. Altered source versions must be plainly marked as such,
+ *     and must not be misrepresented as being the original software.
+ *
+ *  3. This notice may not be removed or altered from any source distribution.
+ *
+ */
+
+#ifndef Awl_FiberImpl_hpp
+#define Awl_FiberImpl_hpp
+
+#include <Awl/Config.hpp>
+#include <cstddef>
+#include <ucontext.h>
+
+namespace awl {
+	namespace priv {
+		
+		/** @brief Execution context with its own stack, switched to
+		 * cooperatively
+		 *
+		 * @details Uses ucontext. Stacks are mapped with a guard page below
+		 * them, so that an overflow faults rather than corrupts memory.
+		 */
+		class FiberImpl {
+		public:
+			/** @brief Wraps the context of the calling thread
+			 */
+			FiberImpl(void);
+			
+			/** @brief Creates a fiber that will call @a entry(@a argument)
+			 * when first switched to. @a entry must never return
+			 */
+			FiberImpl(size_t stackSize, void (*entry)(void *), void *argument);
+			
+			~FiberImpl(void);
+			
+			/** @brief Saves the calling context in this fiber and resumes
+			 * @a target
+			 */
+			void switchTo(FiberImpl& target);
+			
+		private:
+			static void start(unsigned high, unsigned low);
+			
+			ucontext_t m_context;
+			char *m_mapping;
+			size_t m_mappingSize;
+			void (*m_entry)(void *);
+			void *m_argument;
+		};
+		
+	} // namespace priv
+} // namespace awl
+
+#endif // Awl_FiberImpl_hpp
@@ -0,0 +1,154 @@
+
+/*
+ *  Unix/FutexImpl.cpp
+ *  Awl - Asynchronous Work Library
+ *
+ *  Copyright (c) 2011 Lucas Soltic
+ *  ceylow@gmail.com
+ *
+ *  This software is provided 'as-is', without any express or implied warranty.
+ *  In no event will the authors be held liable for any damages arising from
+ *  the use of this software.
+ *
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute it freely,
+ *  subject to the following restrictions:
+ *
+ *  1. The origin of this software must not be misrepresented;
+ *     you must not claim that you wrote the original software.
+ *     If you use this software in a product, an acknowledgment
+ *     in the product documentation would be appreciated but is not required.
+ *
+ *  2. Altered source versions must be plainly marked as such,
+ *     and must not be misrepresented as being the original software.
+ *
+ *  3. This notice may not be removed or altered from any source distribution.
+ *
+ */
+
+#include <Awl/Unix/FutexImpl.hpp>
+#include <sys/time.h>
+#include <errno.h>
+#include <time.h>
+
+#if defined(Awl_SystemLinux)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#else
+#include <pthread.h>
+#endif
+
+namespace awl {
+	namespace priv {
+		
+#if defined(Awl_SystemLinux)
+		
+		static long futex(std::atomic<Uint32>& word, int op, Uint32 value, const timespec *timeout)
+		{
+			return syscall(SYS_futex, reinterpret_cast<Uint32 *>(&word), op, value, timeout, NULL, 0);
+		}
+		
+		bool FutexImpl::wait(std::atomic<Uint32>& word, Uint32 expected, Uint32 timeout)
+		{
+			timespec delay;
+			delay.tv_sec = timeout / 1000;
+			delay.tv_nsec = (timeout % 1000) * 1000000;
+			
+			// The timeout of FUTEX_WAIT is relative
+			long res = futex(word, FUTEX_WAIT_PRIVATE, expected, timeout ? &delay : NULL);
+			
+			return !(res != 0 && errno == ETIMEDOUT);
+		}
+		
+		void FutexImpl::wakeOne(std::atomic<Uint32>& word)
+		{
+			futex(word, FUTEX_WAKE_PRIVATE, 1, NULL);
+		}
+		
+		void FutexImpl::wakeAll(std::atomic<Uint32>& word)
+		{
+			futex(word, FUTEX_WAKE_PRIVATE, 0x7fffffff, NULL);
+		}
+		
+#else
+		
+		namespace {
+			const unsigned SlotCount = 64;
+			
+			struct Slot {
+				pthread_mutex_t mutex;
+				pthread_cond_t cond;
+			};
+			
+			Slot g_slots[SlotCount];
+			
+			struct SlotsInitializer {
+				SlotsInitializer(void)
+				{
+					for (unsigned i = 0; i < SlotCount; i++)
+					{
+						pthread_mutex_init(&g_slots[i].mutex, NULL);
+						pthread_cond_init(&g_slots[i].cond, NULL);
+					}
+				}
+			} g_slotsInitializer;
+			
+			Slot& SlotFor(std::atomic<Uint32>& word)
+			{
+				return g_slots[(reinterpret_cast<size_t>(&word) >> 4) % SlotCount];
+			}
+		}
+		
+		bool FutexImpl::wait(std::atomic<Uint32>& word, Uint32 expected, Uint32 timeout)
+		{
+			Slot& slot = SlotFor(word);
+			bool res = true;
+			
+			pthread_mutex_lock(&slot.mutex);
+			
+			if (word.load() == expected)
+			{
+				if (timeout)
+				{
+					timeval now = {0, 0};
+					gettimeofday(&now, NULL);
+					
+					Uint64 nsec = (Uint64)now.tv_usec * 1000 + (Uint64)(timeout % 1000) * 1000000;
+					timespec deadline;
+					deadline.tv_sec = now.tv_sec + timeout / 1000 + nsec / 1000000000;
+					deadline.tv_nsec = nsec % 1000000000;
+					
+					res = (ETIMEDOUT != pthread_cond_timedwait(&slot.cond, &slot.mutex, &deadline));
+				}
+				else
+				{
+					pthread_cond_wait(&slot.cond, &slot.mutex);
+				}
+			}
+			
+			pthread_mutex_unlock(&slot.mutex);
+			return res;
+		}
+		
+		void FutexImpl::wakeOne(std::atomic<Uint32>& word)
+		{
+			// Other words may share the slot, wake them all up
+			wakeAll(word);
+		}
+		
+		void FutexImpl::wakeAll(std::atomic<Uint32>& word)
+		{
+			Slot& slot = SlotFor(word);
+			
+			// Taking the lock orders the wake up after a concurrent
+			// check of the word in wait()
+			pthread_mutex_lock(&slot.mutex);
+			pthread_cond_broadcast(&slot.cond);
+			pthread_mutex_unlock(&slot.mutex);
+		}
+		
+#endif
+		
+	} // namespace priv
+} // namespace awl
@@ -30,6 +30,15 @@
  */
 
 #include <Awl/Unix/Platform.hpp>
+#include <sys/mman.h>
+#include <sched.h>
+#include <time.h>
+#include <algorithm>
+#include <cstdio>
+
+#if defined(Awl_SystemLinux)
+#include <sys/syscall.h>
+#endif
 
 namespace awl {
 	namespace priv {
@@ -44,11 +53,177 @@ namespace awl {
 		}
 		
 		
+		////////////////////////////////////////////////////////////
+		Uint64 Platform::GetMonotonicTime()
+		{
+			timespec time = {0, 0};
+			clock_gettime(CLOCK_MONOTONIC, &time);
+			
+			return (Uint64)time.tv_sec * 1000 + time.tv_nsec / 1000000;
+		}
+		
+		
 		////////////////////////////////////////////////////////////
 		void Platform::Sleep(Uint32 time)
 		{
 			usleep(time * 1000);
 		}
 		
+		
+		////////////////////////////////////////////////////////////
+		void Platform::YieldThread()
+		{
+			sched_yield();
+		}
+		
+		
+		////////////////////////////////////////////////////////////
+		void Platform::CpuRelax()
+		{
+#if defined(__i386__) || defined(__x86_64__)
+			__builtin_ia32_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+			__asm__ __volatile__("yield");
+#endif
+		}
+		
+		
+		////////////////////////////////////////////////////////////
+		unsigned int Platform::GetCpuCount()
+		{
+			return (unsigned int)GetAllowedCpus().size();
+		}
+		
+		
+		////////////////////////////////////////////////////////////
+		std::vector<unsigned> Platform::GetAllowedCpus()
+		{
+			std::vector<unsigned> cpus;
+			
+#if defined(Awl_SystemLinux)
+			// The kernel rejects masks smaller than its own, which may be
+			// larger than cpu_set_t on big machines
+			for (int size = CPU_SETSIZE; cpus.empty() && size <= 64 * CPU_SETSIZE; size *= 2)
+			{
+				cpu_set_t *set = CPU_ALLOC(size);
+				size_t setSize = CPU_ALLOC_SIZE(size);
+				
+				if (!set)
+					break;
+				
+				CPU_ZERO_S(setSize, set);
+				
+				if (sched_getaffinity(0, setSize, set) == 0)
+				{
+					for (int cpu = 0; cpu < size; cpu++)
+					{
+						if (CPU_ISSET_S(cpu, setSize, set))
+							cpus.push_back(cpu);
+					}
+				}
+				
+				CPU_FREE(set);
+			}
+#endif
+			
+			if (cpus.empty())
+			{
+				long count = sysconf(_SC_NPROCESSORS_ONLN);
+				
+				for (long cpu = 0; cpu < std::max(count, 1L); cpu++)
+					cpus.push_back((unsigned)cpu);
+			}
+			
+			return cpus;
+		}
+		
+		
+		////////////////////////////////////////////////////////////
+		std::vector<std::vector<unsigned> > Platform::GetNumaNodes()
+		{
+			std::vector<std::vector<unsigned> > nodes;
+			std::vector<unsigned> allowed = GetAllowedCpus();
+			
+#if defined(Awl_SystemLinux)
+			// Node numbers may have holes, stop after a few missing ones
+			for (unsigned node = 0, missing = 0; missing < 8; node++)
+			{
+				char path[64];
+				snprintf(path, sizeof(path), "/sys/devices/system/node/node%u/cpulist", node);
+				
+				FILE *file = fopen(path, "r");
+				
+				if (!file)
+				{
+					missing++;
+					continue;
+				}
+				
+				nodes.resize(node + 1);
+				missing = 0;
+				
+				// cpulist format is "0-3,8,10-11"
+				unsigned first, last;
+				int read;
+				
+				while ((read = fscanf(file, "%u-%u", &first, &last)) > 0)
+				{
+					if (read == 1)
+						last = first;
+					
+					for (unsigned cpu = first; cpu <= last; cpu++)
+					{
+						if (std::binary_search(allowed.begin(), allowed.end(), cpu))
+							nodes[node].push_back(cpu);
+					}
+					
+					if (fgetc(file) != ',')
+						break;
+				}
+				
+				fclose(file);
+			}
+#endif
+			
+			bool hasCpu = false;
+			
+			for (size_t i = 0; i < nodes.size(); i++)
+				hasCpu = hasCpu || !nodes[i].empty();
+			
+			if (!hasCpu)
+				nodes.assign(1, allowed);
+			
+			return nodes;
+		}
+		
+		
+		////////////////////////////////////////////////////////////
+		void *Platform::AllocateOnNode(size_t size, unsigned node)
+		{
+			void *block = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+			
+			if (block == MAP_FAILED)
+				return NULL;
+			
+#if defined(Awl_SystemLinux)
+			// Prefer the node rather than binding to it, so that the
+			// allocation can still succeed when the node is out of memory.
+			// Failing here only means the pages will be first-touch placed
+			const int preferredPolicy = 1; // MPOL_PREFERRED
+			unsigned long mask[16] = {0};
+			const size_t bitsPerLong = sizeof(unsigned long) * 8;
+			
+			if (node < sizeof(mask) * 8)
+			{
+				mask[node / bitsPerLong] = 1UL << (node % bitsPerLong);
+				syscall(SYS_mbind, block, size, preferredPolicy, mask, sizeof(mask) * 8 + 1, 0);
+			}
+#else
+			(void)node;
+#endif
+			
+			return block;
+		}
+		
 	} // namespace priv	
 } // namespace awl
@@ -30,6 +30,9 @@
  */
 	
 #include <Awl/Unix/ThreadImpl.hpp>
+#if defined(Awl_SystemLinux)
+#include <sched.h>
+#endif
 
 namespace awl {
 	namespace priv {
@@ -38,6 +41,33 @@ Uint64 ThreadImpl::CurrentThreadId(void)
 {
 	return (Uint64)pthread_self();
 }
+
+////////////////////////////////////////////////////////////
+bool ThreadImpl::SetCurrentAffinity(const std::vector<unsigned>& cpus)
+{
+#if defined(Awl_SystemLinux)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+
+    for (size_t i = 0; i < cpus.size(); i++)
+    {
+        if (cpus[i] < CPU_SETSIZE)
+            CPU_SET(cpus[i], &set);
+    }
+
+    if (CPU_COUNT(&set) == 0 || pthread_setaffinity_np(pthread_self(), sizeof(set), &set) != 0)
+    {
+        std::cerr << "Failed to set thread affinity" << std::endl;
+        return false;
+    }
+
+    return true;
+#else
+    // No portable affinity API on the other Unix systems
+    (void)cpus;
+    return false;
+#endif
+}
 	
 ////////////////////////////////////////////////////////////
 ThreadImpl::ThreadImpl(Thread* owner) :
@@ -53,6 +53,16 @@ public :
 
 	static Uint64 CurrentThreadId(void);
 	
+    ////////////////////////////////////////////////////////////
+    /// \brief Restrict the calling thread to the given processors
+    ///
+    /// \param cpus Indices of the allowed processors
+    ///
+    /// \return True on success, false if not supported or on error
+    ///
+    ////////////////////////////////////////////////////////////
+	static bool SetCurrentAffinity(const std::vector<unsigned>& cpus);
+	
     ////////////////////////////////////////////////////////////
     /// \brief Default constructor, launch the thread
     ///
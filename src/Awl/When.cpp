@@ -0,0 +1,222 @@
+
+/*
+ *  When.cpp
+ *  Awl - Asynchronous Work Library
+ *
+ *  Copyright (c) 2011 Lucas Soltic
+ *  ceylow@gmail.com
+ *
+ *  This software is provided 'as-is', without any express or implied warranty.
+ *  In no event will the authors be held liable for any damages arising from
+ *  the use of this software.
+ *
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute it freely,
+ *  subject to the following restrictions:
+ *
+ *  1. The origin of this software must not be misrepresented;
+ *     you must not claim that you wrote the original software.
+ *     If you use this software in a product, an acknowledgment
+ *     in the product documentation would be appreciated but is not required.
+ *
+ *  2. Altered source versions must be plainly marked as such,
+ *     and must not be misrepresented as being the original software.
+ *
+ *  3. This notice may not be removed or altered from any source distribution.
+ *
+ */
+#include <Awl/When.hpp>
+#include <Awl/Latch.hpp>
+#include <Awl/WorkerThread.hpp>
+#include <Awl/Continuation.hpp>
+#include <Awl/boost/noncopyable.hpp>
+#include <Awl/boost/shared_ptr.hpp>
+#include <atomic>
+
+namespace awl {
+	
+	namespace priv {
+		
+		/** @brief Counts the ends of a set of tasks, and completes a result
+		 * Task and a Latch when all of them, or the first of them, are over
+		 */
+		class TaskJoin : boost::noncopyable {
+		public:
+			enum Mode {
+				JoinAll,
+				JoinAny
+			};
+			
+			TaskJoin(Mode mode, size_t count) :
+			m_mode(mode),
+			m_remaining(count),
+			m_fired(false),
+			m_winner(0),
+			m_result(),
+			m_latch(1),
+			m_nodes()
+			{
+				m_nodes.reserve(count);
+				
+				for (size_t i = 0; i < count; i++)
+					m_nodes.push_back(Node(i));
+			}
+			
+			static void Attach(const boost::shared_ptr<TaskJoin>& join, const std::vector<TaskRef>& tasks)
+			{
+				if (tasks.empty())
+				{
+					WorkerThread *worker = WorkerThread::Current();
+					join->Complete(worker ? worker->GetPool() : ThreadPool::Default());
+					return;
+				}
+				
+				for (size_t i = 0; i < tasks.size(); i++)
+					join->m_nodes[i].m_join = join;
+				
+				for (size_t i = 0; i < tasks.size(); i++)
+					tasks[i]->AddContinuation(&join->m_nodes[i]);
+			}
+			
+			/** @brief Sets the Task scheduled once the join completes, must be
+			 * called before Attach()
+			 */
+			void SetResult(const TaskRef& result)
+			{
+				m_result = result;
+			}
+			
+			void Wait(void)
+			{
+				m_latch.Wait();
+			}
+			
+			/** @brief Returns the index of the first Task that completed, 0 if
+			 * there was none
+			 */
+			size_t GetWinner(void) const
+			{
+				return m_winner;
+			}
+			
+		private:
+			class Node : public Continuation {
+			public:
+				Node(size_t index) :
+				m_join(),
+				m_index(index)
+				{
+				}
+				
+				void Run(ThreadPool& pool)
+				{
+					// Releasing the last reference destroys this node too
+					boost::shared_ptr<TaskJoin> join;
+					join.swap(m_join);
+					join->Signal(m_index, pool);
+				}
+				
+				void Discard(void)
+				{
+					// A Task destroyed without running still counts as over,
+					// or the waiters would never be released
+					WorkerThread *worker = WorkerThread::Current();
+					Run(worker ? worker->GetPool() : ThreadPool::Default());
+				}
+				
+				boost::shared_ptr<TaskJoin> m_join;
+				size_t m_index;
+			};
+			
+			void Signal(size_t index, ThreadPool& pool)
+			{
+				if (m_mode == JoinAll)
+				{
+					if (m_remaining.fetch_sub(1) == 1)
+						Complete(pool);
+				}
+				else if (!m_fired.exchange(true))
+				{
+					m_winner = index;
+					Complete(pool);
+				}
+			}
+			
+			void Complete(ThreadPool& pool)
+			{
+				if (m_result)
+				{
+					TaskRef result;
+					result.swap(m_result);
+					pool.ScheduleTaskForExecution(result);
+				}
+				
+				m_latch.CountDown();
+			}
+			
+			Mode m_mode;
+			std::atomic<size_t> m_remaining;
+			std::atomic<bool> m_fired;
+			size_t m_winner;
+			TaskRef m_result;
+			Latch m_latch;
+			std::vector<Node> m_nodes;
+		};
+		
+		struct NoResult {
+			void operator()(void) const
+			{
+			}
+		};
+		
+		// Scheduled by the join itself, which it keeps alive until then
+		struct WinnerResult {
+			size_t operator()(void) const
+			{
+				return join->GetWinner();
+			}
+			
+			boost::shared_ptr<TaskJoin> join;
+		};
+		
+	} // namespace priv
+	
+	Future<void> WhenAll(const std::vector<TaskRef>& tasks)
+	{
+		boost::intrusive_ptr<priv::ValueTask<void> > result(new priv::FunctionTask<void, priv::NoResult>(priv::NoResult()));
+		boost::shared_ptr<priv::TaskJoin> join(new priv::TaskJoin(priv::TaskJoin::JoinAll, tasks.size()));
+		
+		join->SetResult(result);
+		priv::TaskJoin::Attach(join, tasks);
+		return Future<void>(result);
+	}
+	
+	Future<size_t> WhenAny(const std::vector<TaskRef>& tasks)
+	{
+		boost::shared_ptr<priv::TaskJoin> join(new priv::TaskJoin(priv::TaskJoin::JoinAny, tasks.size()));
+		priv::WinnerResult winner = { join };
+		boost::intrusive_ptr<priv::ValueTask<size_t> > result(new priv::FunctionTask<size_t, priv::WinnerResult>(winner));
+		
+		join->SetResult(result);
+		priv::TaskJoin::Attach(join, tasks);
+		return Future<size_t>(result);
+	}
+	
+	void WaitForAll(const std::vector<TaskRef>& tasks)
+	{
+		boost::shared_ptr<priv::TaskJoin> join(new priv::TaskJoin(priv::TaskJoin::JoinAll, tasks.size()));
+		
+		priv::TaskJoin::Attach(join, tasks);
+		join->Wait();
+	}
+	
+	size_t WaitForAny(const std::vector<TaskRef>& tasks)
+	{
+		boost::shared_ptr<priv::TaskJoin> join(new priv::TaskJoin(priv::TaskJoin::JoinAny, tasks.size()));
+		
+		priv::TaskJoin::Attach(join, tasks);
+		join->Wait();
+		return join->GetWinner();
+	}
+	
+} // namespace awl
@@ -67,6 +67,43 @@ namespace awl {
 			}
 		}
 
+		bool ConditionImpl::timedWaitAndRetain(int value, unsigned int timeout)
+		{
+			DWORD start = GetTickCount();
+			m_mutex.Lock();
+			
+			while (m_conditionnedVar != value && m_isValid)
+			{
+				DWORD elapsed = GetTickCount() - start;
+				
+				if (elapsed >= timeout)
+					break;
+				
+				m_mutex.Unlock();
+				WaitForSingleObject(m_cond, timeout - elapsed);
+				m_mutex.Lock();
+			}
+			
+			if (m_conditionnedVar == value && m_isValid)
+				return true;
+			else
+			{
+				m_mutex.Unlock();
+				return false;
+			}
+		}
+
+		bool ConditionImpl::tryRetain(int value)
+		{
+			m_mutex.Lock();
+			
+			if (m_conditionnedVar == value && m_isValid)
+				return true;
+			
+			m_mutex.Unlock();
+			return false;
+		}
+		
 		void ConditionImpl::lock(void)
 		{
 			m_mutex.Lock();
@@ -121,6 +158,11 @@ namespace awl {
 			}
 		}
 		
+		bool ConditionImpl::isValid(void) const
+		{
+			return m_isValid != 0;
+		}
+		
 	} // namespace priv
 } // namespace awl
 
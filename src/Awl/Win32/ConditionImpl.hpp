@@ -41,6 +41,8 @@ namespace awl {
 		ConditionImpl(int var);
 		~ConditionImpl(void);
 		bool waitAndRetain(int value);
+		bool timedWaitAndRetain(int value, unsigned int timeout);
+		bool tryRetain(int value);
 		void lock(void);
 		void release(int value);
 		void setValue(int value);
@@ -49,6 +51,7 @@ namespace awl {
 		void broadcast(void);
 		void invalidate(void);
 		void restore(void);
+		bool isValid(void) const;
 		
 	private:
 		int m_isValid;
@@ -0,0 +1,79 @@
+
+/*
+ *  Win32/FiberImpl.cpp
+ *  Awl - Asynchronous Work Library
+ *
+ *  Copyright (c) 2011 Lucas Soltic
+ *  ceylow@gmail.com
+ *
+ *  This software is provided 'as-is', without any express or implied warranty.
+ *  In no event will the authors be held liable for any damages arising from
+ *  the use of this software.
+ *
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute it freely,
+ *  subject to the following restrictions:
+ *
+ *  1. The origin of this software must not be misrepresented;
+ *     you must not claim that you wrote the original software.
+ *     If you use this software in a product, an acknowledgment
+ *     in the product documentation would be appreciated but is not required.
+ *
+ *  2. Altered source versions must be plainly marked as such,
+ *     and must not be misrepresented as being the original software.
+ *
+ *  3. This notice may not be removed or altered from any source distribution.
+ *
+ */
+
+#include <Awl/Win32/FiberImpl.hpp>
+#include <iostream>
+
+namespace awl {
+	namespace priv {
+		
+		FiberImpl::FiberImpl(void) :
+		m_fiber(NULL),
+		m_isThread(true),
+		m_entry(NULL),
+		m_argument(NULL)
+		{
+			m_fiber = ConvertThreadToFiber(NULL);
+			
+			if (m_fiber == NULL)
+				std::cerr << "FiberImpl() - ConvertThreadToFiber() error\n";
+		}
+		
+		FiberImpl::FiberImpl(size_t stackSize, void (*entry)(void *), void *argument) :
+		m_fiber(NULL),
+		m_isThread(false),
+		m_entry(entry),
+		m_argument(argument)
+		{
+			m_fiber = CreateFiberEx(stackSize, stackSize, FIBER_FLAG_FLOAT_SWITCH, &FiberImpl::start, this);
+			
+			if (m_fiber == NULL)
+				std::cerr << "FiberImpl() - CreateFiberEx() error\n";
+		}
+		
+		FiberImpl::~FiberImpl(void)
+		{
+			if (m_isThread)
+				ConvertFiberToThread();
+			else if (m_fiber)
+				DeleteFiber(m_fiber);
+		}
+		
+		void FiberImpl::switchTo(FiberImpl& target)
+		{
+			SwitchToFiber(target.m_fiber);
+		}
+		
+		void WINAPI FiberImpl::start(LPVOID self)
+		{
+			FiberImpl *fiber = static_cast<FiberImpl *>(self);
+			fiber->m_entry(fiber->m_argument);
+		}
+		
+	} // namespace priv
+} // namespace awl
@@ -0,0 +1,55 @@
+
+/*
+ *  Win32/FutexImpl.cpp
+ *  Awl - Asynchronous Work Library
+ *
+ *  Copyright (c) 2011 Lucas Soltic
+ *  ceylow@gmail.com
+ *
+ *  This software is provided 'as-is', without any express or implied warranty.
+ *  In no event will the authors be held liable for any damages arising from
+ *  the use of this software.
+ *
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute it freely,
+ *  subject to the following restrictions:
+ *
+ *  1. The origin of this software must not be misrepresented;
+ *     you must not claim that you wrote the original software.
+ *     If you use this software in a product, an acknowledgment
+ *     in the product documentation would be appreciated but is not required.
+ *
+ *  2. Altered source versions must be plainly marked as such,
+ *     and must not be misrepresented as being the original software.
+ *
+ *  3. This notice may not be removed or altered from any source distribution.
+ *
+ */
+
+#include <Awl/Win32/FutexImpl.hpp>
+#include <windows.h>
+
+#pragma comment(lib, "Synchronization.lib")
+
+namespace awl {
+	namespace priv {
+		
+		bool FutexImpl::wait(std::atomic<Uint32>& word, Uint32 expected, Uint32 timeout)
+		{
+			BOOL res = WaitOnAddress(&word, &expected, sizeof(Uint32), timeout ? timeout : INFINITE);
+			
+			return res || GetLastError() != ERROR_TIMEOUT;
+		}
+		
+		void FutexImpl::wakeOne(std::atomic<Uint32>& word)
+		{
+			WakeByAddressSingle(&word);
+		}
+		
+		void FutexImpl::wakeAll(std::atomic<Uint32>& word)
+		{
+			WakeByAddressAll(&word);
+		}
+		
+	} // namespace priv
+} // namespace awl
@@ -0,0 +1,57 @@
+
+/*
+ *  Win32/FutexImpl.hpp
+ *  Awl - Asynchronous Work Library
+ *
+ *  Copyright (c) 2011 Lucas Soltic
+ *  ceylow@gmail.com
+ *
+ *  This software is provided 'as-is', without any express or implied warranty.
+ *  In no event will the authors be held liable for any damages arising from
+ *  the use of this software.
+ *
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute it freely,
+ *  subject to the following restrictions:
+ *
+ *  1. The origin of this software must not be misrepresented;
+ *     you must not claim that you wrote the original software.
+ *     If you use this software in a product, an acknowledgment
+ *     in the product documentation would be appreciated but is not required.
+ *
+ *  2. Altered source versions must be plainly marked as such,
+ *     and must not be misrepresented as being the original software.
+ *
+ *  3. This notice may not be removed or altered from any source distribution.
+ *
+ */
+
+#ifndef Awl_FutexImpl_hpp
+#define Awl_FutexImpl_hpp
+
+#include <Awl/Config.hpp>
+#include <atomic>
+
+namespace awl {
+	namespace priv {
+		
+		/** @brief Blocks threads on the value of a 32 bits word
+		 *
+		 * @details Uses WaitOnAddress(), available since Windows 8.
+		 */
+		class FutexImpl {
+		public:
+			/** @brief Blocks while @a word equals @a expected, until woken up
+			 * or until @a timeout milliseconds have elapsed (0 = no timeout)
+			 *
+			 * @return false on timeout. Spurious wake ups may happen
+			 */
+			static bool wait(std::atomic<Uint32>& word, Uint32 expected, Uint32 timeout);
+			static void wakeOne(std::atomic<Uint32>& word);
+			static void wakeAll(std::atomic<Uint32>& word);
+		};
+		
+	} // namespace priv
+} // namespace awl
+
+#endif // Awl_FutexImpl_hpp
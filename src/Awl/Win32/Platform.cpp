@@ -30,6 +30,7 @@
  */
 
 #include <Awl/Win32/Platform.hpp>
+#include <algorithm>
 
 namespace awl {
 	namespace priv {
@@ -56,12 +57,136 @@ namespace awl {
 		}
 		
 		
+		////////////////////////////////////////////////////////////
+		Uint64 Platform::GetMonotonicTime()
+		{
+			// The performance counter does not follow the system time
+			static LARGE_INTEGER frequency;
+			static BOOL          useHighPerformanceTimer = QueryPerformanceFrequency(&frequency);
+			
+			if (useHighPerformanceTimer)
+			{
+				LARGE_INTEGER currentTime;
+				QueryPerformanceCounter(&currentTime);
+				
+				return currentTime.QuadPart / frequency.QuadPart * 1000 +
+					currentTime.QuadPart % frequency.QuadPart * 1000 / frequency.QuadPart;
+			}
+			else
+			{
+				return GetTickCount64();
+			}
+		}
+		
+		
 		////////////////////////////////////////////////////////////
 		void Platform::Sleep(Uint32 time)
 		{
 			::Sleep(time);
 		}
 		
+		
+		////////////////////////////////////////////////////////////
+		void Platform::YieldThread()
+		{
+			SwitchToThread();
+		}
+		
+		
+		////////////////////////////////////////////////////////////
+		void Platform::CpuRelax()
+		{
+			YieldProcessor();
+		}
+		
+		
+		////////////////////////////////////////////////////////////
+		unsigned int Platform::GetCpuCount()
+		{
+			return (unsigned int)GetAllowedCpus().size();
+		}
+		
+		
+		////////////////////////////////////////////////////////////
+		std::vector<unsigned> Platform::GetAllowedCpus()
+		{
+			std::vector<unsigned> cpus;
+			DWORD_PTR processMask = 0;
+			DWORD_PTR systemMask = 0;
+			
+			// Only covers the processor group of the process
+			if (GetProcessAffinityMask(GetCurrentProcess(), &processMask, &systemMask))
+			{
+				for (unsigned cpu = 0; cpu < sizeof(DWORD_PTR) * 8; cpu++)
+				{
+					if (processMask & ((DWORD_PTR)1 << cpu))
+						cpus.push_back(cpu);
+				}
+			}
+			
+			if (cpus.empty())
+			{
+				SYSTEM_INFO info;
+				GetSystemInfo(&info);
+				
+				for (unsigned cpu = 0; cpu < std::max<DWORD>(info.dwNumberOfProcessors, 1); cpu++)
+					cpus.push_back(cpu);
+			}
+			
+			return cpus;
+		}
+		
+		
+		////////////////////////////////////////////////////////////
+		std::vector<std::vector<unsigned> > Platform::GetNumaNodes()
+		{
+			std::vector<std::vector<unsigned> > nodes;
+			std::vector<unsigned> allowed = GetAllowedCpus();
+			ULONG highest = 0;
+			
+			if (GetNumaHighestNodeNumber(&highest))
+			{
+				nodes.resize(highest + 1);
+				
+				for (ULONG node = 0; node <= highest; node++)
+				{
+					ULONGLONG mask = 0;
+					
+					if (!GetNumaNodeProcessorMask((UCHAR)node, &mask))
+						continue;
+					
+					for (unsigned cpu = 0; cpu < 64; cpu++)
+					{
+						if ((mask & (1ULL << cpu)) && std::binary_search(allowed.begin(), allowed.end(), cpu))
+							nodes[node].push_back(cpu);
+					}
+				}
+			}
+			
+			bool hasCpu = false;
+			
+			for (size_t i = 0; i < nodes.size(); i++)
+				hasCpu = hasCpu || !nodes[i].empty();
+			
+			if (!hasCpu)
+				nodes.assign(1, allowed);
+			
+			return nodes;
+		}
+		
+		
+		////////////////////////////////////////////////////////////
+		void *Platform::AllocateOnNode(size_t size, unsigned node)
+		{
+			void *block = VirtualAllocExNuma(GetCurrentProcess(), NULL, size,
+											 MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE, node);
+			
+			if (!block)
+				block = VirtualAlloc(NULL, size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+			
+			return block;
+		}
+		
 	} // namespace priv
 	
 } // namespace awl
@@ -59,6 +59,15 @@ public :
     ////////////////////////////////////////////////////////////
     static Uint64 GetSystemTime();
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the time elapsed since an arbitrary point,
+    /// which is never affected by changes of the system time
+    ///
+    /// \return Monotonic time, in milliseconds
+    ///
+    ////////////////////////////////////////////////////////////
+    static Uint64 GetMonotonicTime();
+
     ////////////////////////////////////////////////////////////
     /// \brief Suspend the execution of the current thread for a specified duration
     ///
@@ -66,6 +75,64 @@ public :
     ///
     ////////////////////////////////////////////////////////////
     static void Sleep(Uint32 time);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Give the rest of the time slice of the current thread
+    ///        to another ready thread, if any
+    ///
+    ////////////////////////////////////////////////////////////
+    static void YieldThread();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Hint the processor that the current thread is spinning
+    ///
+    ////////////////////////////////////////////////////////////
+    static void CpuRelax();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the number of processors the process may run on
+    ///
+    /// \return Number of processors of the affinity mask of the
+    ///         process, at least 1
+    ///
+    ////////////////////////////////////////////////////////////
+    static unsigned int GetCpuCount();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the processors the process may run on
+    ///
+    /// Processor numbers may have holes, when the process is
+    /// restricted to a subset of the machine.
+    ///
+    /// \return The processors of the affinity mask of the process,
+    ///         in increasing order, never empty
+    ///
+    ////////////////////////////////////////////////////////////
+    static std::vector<unsigned> GetAllowedCpus();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the NUMA topology of the machine
+    ///
+    /// \return The processors of each NUMA node the process may run
+    ///         on, indexed by node number (empty for nodes without such
+    ///         processors). Machines without NUMA support are reported
+    ///         as a single node
+    ///
+    ////////////////////////////////////////////////////////////
+    static std::vector<std::vector<unsigned> > GetNumaNodes();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Allocate memory backed by the given NUMA node
+    ///
+    /// The memory is page-aligned and can't be released.
+    ///
+    /// \param size Size of the block, in bytes
+    /// \param node Node that should provide the memory
+    ///
+    /// \return The allocated block, or NULL on failure
+    ///
+    ////////////////////////////////////////////////////////////
+    static void *AllocateOnNode(size_t size, unsigned node);
 };
 	
 } // namespace priv
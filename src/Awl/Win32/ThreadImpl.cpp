@@ -41,6 +41,26 @@ namespace awl {
 			return (unsigned int)GetCurrentThreadId();
 		}
 		
+		////////////////////////////////////////////////////////////
+		bool ThreadImpl::SetCurrentAffinity(const std::vector<unsigned>& cpus)
+		{
+			DWORD_PTR mask = 0;
+			
+			for (size_t i = 0; i < cpus.size(); i++)
+			{
+				if (cpus[i] < sizeof(DWORD_PTR) * 8)
+					mask |= (DWORD_PTR)1 << cpus[i];
+			}
+			
+			if (mask == 0 || SetThreadAffinityMask(GetCurrentThread(), mask) == 0)
+			{
+				Err() << "Failed to set thread affinity" << std::endl;
+				return false;
+			}
+			
+			return true;
+		}
+		
 		////////////////////////////////////////////////////////////
 		ThreadImpl::ThreadImpl(Thread* owner)
 		{
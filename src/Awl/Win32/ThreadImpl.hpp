@@ -56,6 +56,16 @@ class ThreadImpl : boost::noncopyable
 public :
 
 	static unsigned int CurrentThreadId(void);
+	
+    ////////////////////////////////////////////////////////////
+    /// \brief Restrict the calling thread to the given processors
+    ///
+    /// \param cpus Indices of the allowed processors
+    ///
+    /// \return True on success, false on error
+    ///
+    ////////////////////////////////////////////////////////////
+	static bool SetCurrentAffinity(const std::vector<unsigned>& cpus);
 
     ////////////////////////////////////////////////////////////
     /// \brief Default constructor, launch the thread
@@ -43,9 +43,9 @@ namespace awl {
 		
 		while (!m_pendingTasks.empty() && m_run)
 		{
-			TaskRef current = m_pendingTasks.front();
-			current->Execute();
+			TaskRef current(std::move(m_pendingTasks.front()));
 			m_pendingTasks.pop();
+			current->Execute();
 		}
 		
 		return m_run;
@@ -59,7 +59,7 @@ namespace awl {
 	void WorkLoop::ScheduleTaskForExecution(TaskRef t)
 	{
 		Lock l(m_tasksMutex);
-		m_pendingTasks.push(t);
+		m_pendingTasks.push(std::move(t));
 	}
 	
 	
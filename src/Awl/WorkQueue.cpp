@@ -0,0 +1,101 @@
+
+/*
+ *  WorkQueue.cpp
+ *  Awl - Asynchronous Work Library
+ *
+ *  Copyright (c) 2011 Lucas Soltic
+ *  ceylow@gmail.com
+ *
+ *  This software is provided 'as-is', without any express or implied warranty.
+ *  In no event will the authors be held liable for any damages arising from
+ *  the use of this software.
+ *
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute it freely,
+ *  subject to the following restrictions:
+ *
+ *  1. The origin of this software must not be misrepresented;
+ *     you must not claim that you wrote the original software.
+ *     If you use this software in a product, an acknowledgment
+ *     in the product documentation would be appreciated but is not required.
+ *
+ *  2. Altered source versions must be plainly marked as such,
+ *     and must not be misrepresented as being the original software.
+ *
+ *  3. This notice may not be removed or altered from any source distribution.
+ *
+ */
+
+#include <Awl/WorkQueue.hpp>
+#include <Awl/Lock.hpp>
+
+namespace awl {
+	namespace priv {
+		
+		WorkQueue::WorkQueue(void) :
+		m_mutex(),
+		m_tasks(),
+		m_size(0)
+		{
+			
+		}
+		
+		WorkQueue::~WorkQueue(void)
+		{
+			
+		}
+		
+		void WorkQueue::Push(TaskRef t)
+		{
+			Lock l(m_mutex);
+			m_tasks.PushBack(std::move(t));
+			m_size.store(m_tasks.GetSize(), std::memory_order_release);
+		}
+		
+		void WorkQueue::PushBatch(const std::vector<TaskRef>& tasks)
+		{
+			Lock l(m_mutex);
+			
+			for (size_t i = 0; i < tasks.size(); i++)
+				m_tasks.PushBack(tasks[i]);
+			
+			m_size.store(m_tasks.GetSize(), std::memory_order_release);
+		}
+		
+		bool WorkQueue::Pop(TaskRef& t)
+		{
+			if (IsEmpty())
+				return false;
+			
+			Lock l(m_mutex);
+			
+			if (m_tasks.IsEmpty())
+				return false;
+			
+			m_tasks.TakeBack(t);
+			m_size.store(m_tasks.GetSize(), std::memory_order_release);
+			return true;
+		}
+		
+		bool WorkQueue::Steal(TaskRef& t)
+		{
+			if (IsEmpty())
+				return false;
+			
+			Lock l(m_mutex);
+			
+			if (m_tasks.IsEmpty())
+				return false;
+			
+			m_tasks.TakeFront(t);
+			m_size.store(m_tasks.GetSize(), std::memory_order_release);
+			return true;
+		}
+		
+		bool WorkQueue::IsEmpty(void) const
+		{
+			return m_size.load(std::memory_order_acquire) == 0;
+		}
+		
+	} // namespace priv
+} // namespace awl
@@ -0,0 +1,91 @@
+
+/*
+ *  WorkQueue.hpp
+ *  Awl - Asynchronous Work Library
+ *
+ *  Copyright (c) 2011 Lucas Soltic
+ *  ceylow@gmail.com
+ *
+ *  This software is provided 'as-is', without any express or implied warranty.
+ *  In no event will the authors be held liable for any damages arising from
+ *  the use of this software.
+ *
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute it freely,
+ *  subject to the following restrictions:
+ *
+ *  1. The origin of this software must not be misrepresented;
+ *     you must not claim that you wrote the original software.
+ *     If you use this software in a product, an acknowledgment
+ *     in the product documentation would be appreciated but is not required.
+ *
+ *  2. Altered source versions must be plainly marked as such,
+ *     and must not be misrepresented as being the original software.
+ *
+ *  3. This notice may not be removed or altered from any source distribution.
+ *
+ */
+
+#ifndef Awl_WorkQueue_hpp
+#define Awl_WorkQueue_hpp
+
+#include <Awl/boost/noncopyable.hpp>
+#include <Awl/Mutex.hpp>
+#include <Awl/Task.hpp>
+#include <Awl/TaskRing.hpp>
+#include <atomic>
+#include <vector>
+
+namespace awl {
+	namespace priv {
+		
+		/** @brief Task deque owned by a single WorkerThread
+		 *
+		 * @details The owner pushes and pops at the back (newest first) while
+		 * the other workers of the pool steal from the front (oldest first).
+		 * Each queue has its own lock so that workers only contend when
+		 * stealing from each other.
+		 */
+		class WorkQueue : boost::noncopyable {
+		public:
+			WorkQueue(void);
+			~WorkQueue(void);
+			
+			/** @brief Push @a t at the back of the queue (owner side)
+			 */
+			void Push(TaskRef t);
+			
+			/** @brief Push all the @a tasks at the back of the queue at once
+			 * (owner side), the last one will be popped first
+			 */
+			void PushBatch(const std::vector<TaskRef>& tasks);
+			
+			/** @brief Pop the most recently pushed task (owner side)
+			 *
+			 * @return true if a task has been stored in @a t, false if the
+			 * queue was empty
+			 */
+			bool Pop(TaskRef& t);
+			
+			/** @brief Pop the oldest task (thief side)
+			 *
+			 * @return true if a task has been stored in @a t, false if the
+			 * queue was empty
+			 */
+			bool Steal(TaskRef& t);
+			
+			/** @brief Non-blocking check, only meant as a hint as the queue
+			 * may be modified concurrently
+			 */
+			bool IsEmpty(void) const;
+			
+		private:
+			Mutex m_mutex;
+			TaskRing m_tasks;
+			std::atomic<size_t> m_size;
+		};
+		
+	} // namespace priv
+} // namespace awl
+
+#endif // Awl_WorkQueue_hpp
@@ -31,8 +31,11 @@
 #include <Awl/Task.hpp>
 #include <Awl/Mutex.hpp>
 #include <Awl/Lock.hpp>
-#include <Awl/Sleep.hpp>
 #include <Awl/Debug.hpp>
+#include <Awl/WorkQueue.hpp>
+#include <Awl/SpawnArena.hpp>
+#include <Awl/NodeAllocator.hpp>
+#include <Awl/FiberScheduler.hpp>
 #include <map>
 
 namespace awl {
@@ -40,10 +43,28 @@ namespace awl {
 	static std::map<Uint64, Uint64> g_thread_table;
 	static unsigned int g_thread_counter = 0;
 	static awl::Mutex g_thread_table_mutex;
+	static thread_local WorkerThread *t_current_worker = NULL;
 	
-	WorkerThread::WorkerThread() :
-	m_thread(&WorkerThread::ThreadCallback, this)
+	static void UnregisterThread(Uint64 threadId)
 	{
+		Lock l(g_thread_table_mutex);
+		g_thread_table.erase(threadId);
+	}
+	
+	WorkerThread::WorkerThread(ThreadPool& pool, priv::WorkQueue& queue, priv::SpawnDeque& frames, unsigned index) :
+	m_thread(&WorkerThread::ThreadCallback, this),
+	m_pool(pool),
+	m_queue(queue),
+	m_frames(frames),
+	m_arena(NULL),
+	m_index(index),
+	m_node(pool.GetWorkerNode(index)),
+	m_spinLimit(pool.GetSettings().idleSpinCount),
+	m_popCount(0),
+	m_refillBatch(),
+	m_threadId(0)
+	{
+		m_refillBatch.reserve(pool.GetSettings().dequeueBatchSize);
 		m_thread.Launch();
 	}
 	
@@ -54,23 +75,62 @@ namespace awl {
 	
 	void WorkerThread::ThreadCallback(void)
 	{
+		m_threadId = Thread::GetCurrentThreadId();
+		
 		{
 			Lock l(g_thread_table_mutex);
-			g_thread_table[Thread::GetCurrentThreadId()] = g_thread_counter++;
+			g_thread_table[m_threadId] = g_thread_counter++;
 		}
 		
-		TaskRef t;
-		while (ThreadPool::Default().WaitForTask(t))
+		t_current_worker = this;
+		m_arena = &priv::SpawnArena::Current();
+		priv::NodeAllocator::SetLocalNode(m_node);
+		m_pool.ApplyAffinity(m_index);
+		
+		if (m_pool.GetSettings().useFibers)
 		{
-			t->Execute(*this);
-			
-			// Ease thread switching for some OS
-			Sleep(0);
+			priv::FiberScheduler scheduler(*this);
+			scheduler.Run();
 		}
+		else
+		{
+			TaskRef t;
+			while (m_pool.WaitForTask(*this, t))
+				Execute(t);
+		}
+		
+		// Retired or dying: the id may be given to another thread
+		UnregisterThread(m_threadId);
+	}
+	
+	void WorkerThread::Execute(TaskRef& t)
+	{
+		// An aborted Task has been accounted for by KillWorkerThread()
+		bool completed = t->Execute(*this);
+		t.reset();
+		
+		if (completed)
+			m_pool.TaskDone();
+	}
+	
+	WorkerThread *WorkerThread::Current(void)
+	{
+		return t_current_worker;
+	}
+	
+	ThreadPool& WorkerThread::GetPool(void) const
+	{
+		return m_pool;
+	}
+	
+	int WorkerThread::GetNode(void) const
+	{
+		return m_node;
 	}
 	
 	void WorkerThread::Die(void)
 	{
+		UnregisterThread(m_threadId);
 		m_thread.Terminate();
 	}
 	
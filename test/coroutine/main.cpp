@@ -0,0 +1,129 @@
+
+/*
+ *  coroutine/main.cpp
+ *  Awl - Asynchronous Work Library
+ *
+ *  Copyright (c) 2011 Lucas Soltic
+ *  ceylow@gmail.com
+ *
+ *  This software is provided 'as-is', without any express or implied warranty.
+ *  In no event will the authors be held liable for any damages arising from
+ *  the use of this software.
+ *
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute it freely,
+ *  subject to the following restrictions:
+ *
+ *  1. The origin of this software must not be misrepresented;
+ *     you must not claim that you wrote the original software.
+ *     If you use this software in a product, an acknowledgment
+ *     in the product documentation would be appreciated but is not required.
+ *
+ *  2. Altered source versions must be plainly marked as such,
+ *     and must not be misrepresented as being the original software.
+ *
+ *  3. This notice may not be removed or altered from any source distribution.
+ *
+ */
+
+#include <Awl/Awl.hpp>
+#include <Awl/Coroutine.hpp>
+#include <Awl/Debug.hpp>
+#include <Awl/Sleep.hpp>
+#include <atomic>
+#include <stdexcept>
+
+// Checks that coroutines resume where they ask to and deliver their
+// results and exceptions: the number of failures is returned
+
+int failures = 0;
+
+void check(bool condition, int line)
+{
+	MT_COUT(std::cout << "check point " << line << (condition ? " ok" : " FAILED") << std::endl);
+	
+	if (!condition)
+		failures++;
+}
+
+int twice(int x)
+{
+	return x * 2;
+}
+
+awl::CoTask<int> compute(int x)
+{
+	co_await awl::Async();
+	int y = co_await awl::AsyncCall([x] { return twice(x); });
+	co_return y + 1;
+}
+
+awl::CoTask<int> sum(int n)
+{
+	int total = 0;
+	
+	for (int i = 0; i < n;i++)
+		total += co_await compute(i);
+	
+	co_return total;
+}
+
+awl::CoTask<void> fail(void)
+{
+	co_await awl::Async();
+	throw std::runtime_error("expected");
+}
+
+void nothing(awl::Task *)
+{
+}
+
+awl::CoTask<int> awaitTask(void)
+{
+	awl::TaskRef task = awl::AsyncCall(nothing);
+	co_await task;
+	co_return task->IsOver() ? 7 : 0;
+}
+
+bool wasOnWorker = false;
+bool isOnMainThread = false;
+
+awl::CoTask<void> hop(awl::Uint64 mainThreadId)
+{
+	co_await awl::Async();
+	wasOnWorker = (awl::WorkerThread::Current() != NULL);
+	
+	co_await awl::MainThread();
+	isOnMainThread = (awl::Thread::GetCurrentThreadId() == mainThreadId);
+	awl::WorkLoop::Default().Stop();
+}
+
+int main (void)
+{
+	check(sum(100).Get() == 100 * 99 + 100, __LINE__);
+	check(awaitTask().Get() == 7, __LINE__);
+	
+	bool hasThrown = false;
+	
+	try
+	{
+		fail().Get();
+	}
+	catch (std::runtime_error&)
+	{
+		hasThrown = true;
+	}
+	
+	check(hasThrown, __LINE__);
+	
+	awl::CoTask<void> hopping = hop(awl::Thread::GetCurrentThreadId());
+	
+	while (awl::WorkLoop::Default().Run())
+		awl::Sleep(1);
+	
+	hopping.Wait();
+	check(wasOnWorker && isOnMainThread, __LINE__);
+	
+	awl::ThreadPool::WaitAndDie();
+	return failures;
+}
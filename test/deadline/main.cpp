@@ -0,0 +1,114 @@
+
+/*
+ *  deadline/main.cpp
+ *  Awl - Asynchronous Work Library
+ *
+ *  Copyright (c) 2011 Lucas Soltic
+ *  ceylow@gmail.com
+ *
+ *  This software is provided 'as-is', without any express or implied warranty.
+ *  In no event will the authors be held liable for any damages arising from
+ *  the use of this software.
+ *
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute it freely,
+ *  subject to the following restrictions:
+ *
+ *  1. The origin of this software must not be misrepresented;
+ *     you must not claim that you wrote the original software.
+ *     If you use this software in a product, an acknowledgment
+ *     in the product documentation would be appreciated but is not required.
+ *
+ *  2. Altered source versions must be plainly marked as such,
+ *     and must not be misrepresented as being the original software.
+ *
+ *  3. This notice may not be removed or altered from any source distribution.
+ *
+ */
+#include <Awl/Awl.hpp>
+#include <Awl/Debug.hpp>
+#include <Awl/Sleep.hpp>
+#include <atomic>
+#include <string>
+
+// Checks that a pool using DeadlineScheduling starts the earliest deadline
+// first and counts the missed deadlines: each check prints its check point
+// and the number of failures is returned
+
+int failures = 0;
+std::atomic<bool> started(false);
+std::atomic<bool> released(false);
+std::string order;
+
+void check(bool condition, int line)
+{
+	MT_COUT(std::cout << "check point " << line << (condition ? " ok" : " FAILED") << std::endl);
+	
+	if (!condition)
+		failures++;
+}
+
+// Keeps the worker busy until the tasks have all been scheduled
+void blocker(awl::Task *)
+{
+	started = true;
+	
+	while (!released)
+		awl::Sleep(1);
+}
+
+// Only ever called by the single worker
+void record(awl::Task *, char name)
+{
+	order += name;
+}
+
+awl::TaskRef createTask(char name, awl::Uint64 deadline)
+{
+	awl::TaskRef t = awl::Task::Create(boost::bind(record, _1, name));
+	t->SetDeadline(deadline);
+	return t;
+}
+
+int main (void)
+{
+	awl::PoolSettings settings(1);
+	settings.scheduling = awl::DeadlineScheduling;
+	settings.priorityAging = 1000;
+	
+	awl::ThreadPool pool(settings);
+	
+	// Aging can't tell the oldest tasks in the deadline heaps
+	check(pool.GetSettings().priorityAging == 0, __LINE__);
+	
+	awl::TaskRef blocked = awl::AsyncCall(pool, blocker);
+	
+	while (!started)
+		awl::Sleep(1);
+	
+	awl::Uint64 now = awl::GetMonotonicTime();
+	
+	std::vector<awl::TaskRef> tasks;
+	tasks.push_back(createTask('-', awl::Task::NoDeadline));
+	tasks.push_back(createTask('3', now + 30000));
+	tasks.push_back(createTask('2', now + 20000));
+	tasks.push_back(createTask('1', now + 10000));
+	tasks.push_back(createTask('0', now));
+	
+	for (size_t i = 0; i < tasks.size(); i++)
+		pool.ScheduleTaskForExecution(tasks[i]);
+	
+	awl::Sleep(10);
+	released = true;
+	awl::WaitForAll(tasks);
+	blocked->Wait();
+	
+	// Tasks without deadline come last
+	check(order == "0123-", __LINE__);
+	
+	// Only the task due when it was scheduled has been late
+	check(pool.GetDeadlineTaskCount() == 4 && pool.GetDeadlineMissCount() == 1, __LINE__);
+	
+	awl::ThreadPool::WaitAndDie();
+	return failures;
+}
@@ -0,0 +1,125 @@
+
+/*
+ *  elastic/main.cpp
+ *  Awl - Asynchronous Work Library
+ *
+ *  Copyright (c) 2011 Lucas Soltic
+ *  ceylow@gmail.com
+ *
+ *  This software is provided 'as-is', without any express or implied warranty.
+ *  In no event will the authors be held liable for any damages arising from
+ *  the use of this software.
+ *
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute it freely,
+ *  subject to the following restrictions:
+ *
+ *  1. The origin of this software must not be misrepresented;
+ *     you must not claim that you wrote the original software.
+ *     If you use this software in a product, an acknowledgment
+ *     in the product documentation would be appreciated but is not required.
+ *
+ *  2. Altered source versions must be plainly marked as such,
+ *     and must not be misrepresented as being the original software.
+ *
+ *  3. This notice may not be removed or altered from any source distribution.
+ *
+ */
+#include <Awl/Awl.hpp>
+#include <Awl/Debug.hpp>
+#include <Awl/Sleep.hpp>
+#include <atomic>
+
+// Checks the workers of an elastic pool, and that aborting a Task that is
+// over leaves its worker alone: each check prints its check point and the
+// number of failures is returned
+
+int failures = 0;
+std::atomic<int> calls(0);
+
+void check(bool condition, int line)
+{
+	MT_COUT(std::cout << "check point " << line << (condition ? " ok" : " FAILED") << std::endl);
+	
+	if (!condition)
+		failures++;
+}
+
+void count(awl::Task *)
+{
+	calls++;
+}
+
+void blocker(awl::Task *)
+{
+	awl::Sleep(300);
+	calls++;
+}
+
+void elasticity(void)
+{
+	awl::PoolSettings settings(1);
+	settings.maxWorkers = 4;
+	settings.keepAlive = 50;
+	settings.spawnWaitTime = 20;
+	
+	awl::ThreadPool pool(settings);
+	calls = 0;
+	
+	// The only worker is blocked: the second task has been waiting for
+	// long enough when the third one is scheduled
+	awl::TaskRef blocked = awl::AsyncCall(pool, blocker);
+	awl::Sleep(10);
+	awl::TaskRef second = awl::AsyncCall(pool, count);
+	awl::Sleep(50);
+	awl::TaskRef third = awl::AsyncCall(pool, count);
+	
+	check(pool.GetWorkerCount() > 1, __LINE__);
+	
+	third->Wait();
+	second->Wait();
+	check(!blocked->IsOver() && calls == 2, __LINE__);
+	
+	blocked->Wait();
+	
+	// The extra workers retire once idle
+	for (int i = 0; i < 100 && pool.GetWorkerCount() > 1;i++)
+		awl::Sleep(10);
+	
+	check(pool.GetWorkerCount() == 1, __LINE__);
+	
+	// And are spawned again when needed
+	blocked = awl::AsyncCall(pool, blocker);
+	awl::Sleep(10);
+	second = awl::AsyncCall(pool, count);
+	awl::Sleep(50);
+	third = awl::AsyncCall(pool, count);
+	third->Wait();
+	
+	check(pool.GetWorkerCount() > 1, __LINE__);
+	blocked->Wait();
+}
+
+void abortAfterCompletion(void)
+{
+	calls = 0;
+	
+	awl::TaskRef task = awl::AsyncCall(count);
+	task->Wait();
+	task->Abort();
+	
+	// No effect: the Task stays over and its worker keeps working
+	check(task->IsOver() && calls == 1, __LINE__);
+	
+	awl::TaskRef next = awl::AsyncCall(count);
+	check(next->Wait() && calls == 2, __LINE__);
+}
+
+int main (void)
+{
+	elasticity();
+	abortAfterCompletion();
+	
+	awl::ThreadPool::WaitAndDie();
+	return failures;
+}
@@ -0,0 +1,120 @@
+
+/*
+ *  fibers/main.cpp
+ *  Awl - Asynchronous Work Library
+ *
+ *  Copyright (c) 2011 Lucas Soltic
+ *  ceylow@gmail.com
+ *
+ *  This software is provided 'as-is', without any express or implied warranty.
+ *  In no event will the authors be held liable for any damages arising from
+ *  the use of this software.
+ *
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute it freely,
+ *  subject to the following restrictions:
+ *
+ *  1. The origin of this software must not be misrepresented;
+ *     you must not claim that you wrote the original software.
+ *     If you use this software in a product, an acknowledgment
+ *     in the product documentation would be appreciated but is not required.
+ *
+ *  2. Altered source versions must be plainly marked as such,
+ *     and must not be misrepresented as being the original software.
+ *
+ *  3. This notice may not be removed or altered from any source distribution.
+ *
+ */
+#include <Awl/Awl.hpp>
+#include <Awl/Debug.hpp>
+#include <Awl/Sleep.hpp>
+#include <atomic>
+
+// Checks a pool running its tasks on fibers, alone and together with
+// ForkJoin scopes that get suspended: each check prints its check point
+// and the number of failures is returned
+
+int failures = 0;
+std::atomic<int> calls(0);
+
+void check(bool condition, int line)
+{
+	MT_COUT(std::cout << "check point " << line << (condition ? " ok" : " FAILED") << std::endl);
+	
+	if (!condition)
+		failures++;
+}
+
+void sleeper(awl::Task *)
+{
+	awl::Sleep(20);
+	calls++;
+}
+
+// Sleeps at the leaves, so that the fibers of a worker suspend in the
+// middle of their scopes and interleave them
+void sum(int begin, int end, long *result)
+{
+	if (end - begin == 1)
+	{
+		awl::Sleep(1);
+		*result = begin;
+		return;
+	}
+	
+	long left, right;
+	int middle = begin + (end - begin) / 2;
+	
+	awl::ForkJoin scope;
+	scope.Spawn(boost::bind(sum, begin, middle, &left));
+	sum(middle, end, &right);
+	scope.Sync();
+	*result = left + right;
+}
+
+void sleeps(awl::ThreadPool& pool)
+{
+	awl::Uint64 start = awl::GetMonotonicTime();
+	std::vector<awl::TaskRef> tasks;
+	
+	for (int i = 0; i < 100;i++)
+		tasks.push_back(awl::AsyncCall(pool, sleeper));
+	
+	awl::WaitForAll(tasks);
+	
+	// Two seconds if the sleeps blocked the two workers
+	check(calls == 100, __LINE__);
+	check(awl::GetMonotonicTime() - start < 1000, __LINE__);
+}
+
+void scopes(awl::ThreadPool& pool)
+{
+	std::vector<long> results(16, -1);
+	std::vector<awl::TaskRef> tasks;
+	
+	for (size_t i = 0; i < results.size();i++)
+		tasks.push_back(awl::AsyncCall(pool, boost::bind(sum, 0, 64, &results[i])));
+	
+	awl::WaitForAll(tasks);
+	
+	bool correct = true;
+	
+	for (size_t i = 0; i < results.size();i++)
+		correct = correct && results[i] == 64 * 63 / 2;
+	
+	check(correct, __LINE__);
+}
+
+int main (void)
+{
+	awl::PoolSettings settings(2);
+	settings.useFibers = true;
+	
+	awl::ThreadPool pool(settings);
+	
+	sleeps(pool);
+	scopes(pool);
+	
+	awl::ThreadPool::WaitAndDie();
+	return failures;
+}
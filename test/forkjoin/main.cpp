@@ -0,0 +1,101 @@
+
+/*
+ *  forkjoin/main.cpp
+ *  Awl - Asynchronous Work Library
+ *
+ *  Copyright (c) 2011 Lucas Soltic
+ *  ceylow@gmail.com
+ *
+ *  This software is provided 'as-is', without any express or implied warranty.
+ *  In no event will the authors be held liable for any damages arising from
+ *  the use of this software.
+ *
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute it freely,
+ *  subject to the following restrictions:
+ *
+ *  1. The origin of this software must not be misrepresented;
+ *     you must not claim that you wrote the original software.
+ *     If you use this software in a product, an acknowledgment
+ *     in the product documentation would be appreciated but is not required.
+ *
+ *  2. Altered source versions must be plainly marked as such,
+ *     and must not be misrepresented as being the original software.
+ *
+ *  3. This notice may not be removed or altered from any source distribution.
+ *
+ */
+#include <Awl/Awl.hpp>
+#include <Awl/Debug.hpp>
+#include <atomic>
+
+// Checks ForkJoin scopes from a worker and from another thread: each check
+// prints its check point and the number of failures is returned
+
+int failures = 0;
+std::atomic<int> calls(0);
+
+void check(bool condition, int line)
+{
+	MT_COUT(std::cout << "check point " << line << (condition ? " ok" : " FAILED") << std::endl);
+	
+	if (!condition)
+		failures++;
+}
+
+void fib(int n, long *result)
+{
+	if (n < 2)
+	{
+		*result = n;
+		return;
+	}
+	
+	long a, b;
+	awl::ForkJoin scope;
+	scope.Spawn(boost::bind(fib, n - 1, &a));
+	fib(n - 2, &b);
+	scope.Sync();
+	*result = a + b;
+}
+
+void scopes(void)
+{
+	long result = 0;
+	fib(25, &result);
+	check(result == 75025, __LINE__);
+	
+	calls = 0;
+	
+	{
+		// Synced several times, then by the destructor
+		awl::ForkJoin scope;
+		
+		for (int i = 0; i < 1000;i++)
+			scope.Spawn([] { calls++; });
+		
+		scope.Sync();
+		check(calls == 1000, __LINE__);
+		
+		int value = 5;
+		scope.Spawn([value] { calls += value; });
+		scope.Sync();
+		check(calls == 1005, __LINE__);
+		
+		scope.Spawn([] { calls++; });
+	}
+	
+	check(calls == 1006, __LINE__);
+}
+
+int main (void)
+{
+	// Spawned functions are scheduled as regular tasks
+	scopes();
+	
+	// Spawned functions go to the spawn deque of the worker
+	awl::AsyncCall(scopes).Wait();
+	
+	awl::ThreadPool::WaitAndDie();
+	return failures;
+}
@@ -0,0 +1,129 @@
+
+/*
+ *  future/main.cpp
+ *  Awl - Asynchronous Work Library
+ *
+ *  Copyright (c) 2011 Lucas Soltic
+ *  ceylow@gmail.com
+ *
+ *  This software is provided 'as-is', without any express or implied warranty.
+ *  In no event will the authors be held liable for any damages arising from
+ *  the use of this software.
+ *
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute it freely,
+ *  subject to the following restrictions:
+ *
+ *  1. The origin of this software must not be misrepresented;
+ *     you must not claim that you wrote the original software.
+ *     If you use this software in a product, an acknowledgment
+ *     in the product documentation would be appreciated but is not required.
+ *
+ *  2. Altered source versions must be plainly marked as such,
+ *     and must not be misrepresented as being the original software.
+ *
+ *  3. This notice may not be removed or altered from any source distribution.
+ *
+ */
+#include <Awl/Awl.hpp>
+#include <Awl/Debug.hpp>
+#include <atomic>
+#include <stdexcept>
+
+// Checks Future results and the continuations chained with Then(): each
+// check prints its check point and the number of failures is returned
+
+int failures = 0;
+std::atomic<int> calls(0);
+
+void check(bool condition, int line)
+{
+	MT_COUT(std::cout << "check point " << line << (condition ? " ok" : " FAILED") << std::endl);
+	
+	if (!condition)
+		failures++;
+}
+
+void count(awl::Task *)
+{
+	calls++;
+}
+
+int answer(void)
+{
+	return 42;
+}
+
+int fail(void)
+{
+	throw std::runtime_error("failed");
+}
+
+void values(void)
+{
+	awl::Future<int> value = awl::AsyncCall(answer);
+	awl::Future<int> doubled = value.Then([](int v) { return v * 2; });
+	awl::Future<void> done = doubled.Then([](int v) { calls += v; });
+	
+	done.Get();
+	check(value.Get() == 42 && doubled.Get() == 84, __LINE__);
+	check(calls == 84 && !done.HasError(), __LINE__);
+	
+	// Chained after completion: scheduled right away
+	check(value.Then([](int v) { return v + 1; }).Get() == 43, __LINE__);
+}
+
+void errors(void)
+{
+	calls = 0;
+	
+	awl::Future<int> failed = awl::AsyncCall(fail);
+	awl::Future<void> skipped = failed.Then([](int) { calls++; });
+	
+	// The error is forwarded without calling the continuation
+	check(skipped.HasError() && calls == 0, __LINE__);
+	
+	try
+	{
+		skipped.Get();
+		check(false, __LINE__);
+	}
+	catch (std::runtime_error&)
+	{
+		check(true, __LINE__);
+	}
+}
+
+void successors(void)
+{
+	calls = 0;
+	
+	awl::TaskRef first = awl::Task::Create(count);
+	awl::TaskRef second = awl::Task::Create(count);
+	awl::TaskRef third = awl::Task::Create(count);
+	first->Then(second);
+	second->Then(third);
+	
+	awl::ThreadPool::Default().ScheduleTaskForExecution(first);
+	third->Wait();
+	check(calls == 3 && third->IsOver(), __LINE__);
+	
+	// Never executed antecedent: the successor is completed as cancelled
+	awl::TaskRef dropped = awl::Task::Create(count);
+	awl::TaskRef orphan = awl::Task::Create(count);
+	dropped->Then(orphan);
+	dropped.reset();
+	
+	check(orphan->Wait() && orphan->IsCancelled() && !orphan->IsOver(), __LINE__);
+	check(calls == 3, __LINE__);
+}
+
+int main (void)
+{
+	values();
+	errors();
+	successors();
+	
+	awl::ThreadPool::WaitAndDie();
+	return failures;
+}
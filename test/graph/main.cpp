@@ -0,0 +1,132 @@
+
+/*
+ *  graph/main.cpp
+ *  Awl - Asynchronous Work Library
+ *
+ *  Copyright (c) 2011 Lucas Soltic
+ *  ceylow@gmail.com
+ *
+ *  This software is provided 'as-is', without any express or implied warranty.
+ *  In no event will the authors be held liable for any damages arising from
+ *  the use of this software.
+ *
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute it freely,
+ *  subject to the following restrictions:
+ *
+ *  1. The origin of this software must not be misrepresented;
+ *     you must not claim that you wrote the original software.
+ *     If you use this software in a product, an acknowledgment
+ *     in the product documentation would be appreciated but is not required.
+ *
+ *  2. Altered source versions must be plainly marked as such,
+ *     and must not be misrepresented as being the original software.
+ *
+ *  3. This notice may not be removed or altered from any source distribution.
+ *
+ */
+#include <Awl/Awl.hpp>
+#include <Awl/Debug.hpp>
+#include <atomic>
+
+// Checks the order in which TaskGraph nodes run, graphs run again and
+// aborted nodes: each check prints its check point and the number of
+// failures is returned
+
+int failures = 0;
+std::atomic<int> calls(0);
+
+void check(bool condition, int line)
+{
+	MT_COUT(std::cout << "check point " << line << (condition ? " ok" : " FAILED") << std::endl);
+	
+	if (!condition)
+		failures++;
+}
+
+void count(awl::Task *)
+{
+	calls++;
+}
+
+void record(awl::Task *, int *order)
+{
+	*order = ++calls;
+}
+
+void aborting(awl::Task *self)
+{
+	calls++;
+	self->Abort();
+	
+	// Should never be executed
+	calls += 100;
+}
+
+void dependencies(void)
+{
+	// A diamond: both middle nodes run after the first one, and the last
+	// one after both of them
+	int first, left, right, last;
+	awl::TaskGraph graph;
+	awl::TaskGraph::Node a = graph.AddNode(boost::bind(record, _1, &first));
+	awl::TaskGraph::Node b = graph.AddNode(boost::bind(record, _1, &left));
+	awl::TaskGraph::Node c = graph.AddNode(boost::bind(record, _1, &right));
+	awl::TaskGraph::Node d = graph.AddNode(boost::bind(record, _1, &last));
+	graph.AddEdge(a, b);
+	graph.AddEdge(a, c);
+	graph.AddEdge(b, d);
+	graph.AddEdge(c, d);
+	
+	for (int i = 0; i < 100;i++)
+	{
+		calls = 0;
+		graph.Run();
+		graph.Wait();
+		
+		if (!(first == 1 && left > first && right > first && last == 4))
+			break;
+	}
+	
+	check(first == 1 && left > first && right > first && last == 4, __LINE__);
+	check(!graph.IsRunning(), __LINE__);
+	
+	// A cycle is refused
+	awl::TaskGraph cyclic;
+	awl::TaskGraph::Node x = cyclic.AddNode(count);
+	awl::TaskGraph::Node y = cyclic.AddNode(count);
+	cyclic.AddEdge(x, y);
+	cyclic.AddEdge(y, x);
+	check(!cyclic.Run(), __LINE__);
+}
+
+void cancellation(void)
+{
+	// The aborted node still completes: its successor runs and the
+	// graph can run again
+	awl::TaskGraph graph;
+	awl::TaskGraph::Node first = graph.AddNode(count);
+	awl::TaskGraph::Node aborted = graph.AddNode(aborting);
+	awl::TaskGraph::Node last = graph.AddNode(count);
+	graph.AddEdge(first, aborted);
+	graph.AddEdge(aborted, last);
+	
+	calls = 0;
+	
+	for (int i = 0; i < 2;i++)
+	{
+		graph.Run();
+		graph.Wait();
+	}
+	
+	check(calls == 6, __LINE__);
+}
+
+int main (void)
+{
+	dependencies();
+	cancellation();
+	
+	awl::ThreadPool::WaitAndDie();
+	return failures;
+}
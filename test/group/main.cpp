@@ -0,0 +1,129 @@
+
+/*
+ *  group/main.cpp
+ *  Awl - Asynchronous Work Library
+ *
+ *  Copyright (c) 2011 Lucas Soltic
+ *  ceylow@gmail.com
+ *
+ *  This software is provided 'as-is', without any express or implied warranty.
+ *  In no event will the authors be held liable for any damages arising from
+ *  the use of this software.
+ *
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute it freely,
+ *  subject to the following restrictions:
+ *
+ *  1. The origin of this software must not be misrepresented;
+ *     you must not claim that you wrote the original software.
+ *     If you use this software in a product, an acknowledgment
+ *     in the product documentation would be appreciated but is not required.
+ *
+ *  2. Altered source versions must be plainly marked as such,
+ *     and must not be misrepresented as being the original software.
+ *
+ *  3. This notice may not be removed or altered from any source distribution.
+ *
+ */
+#include <Awl/Awl.hpp>
+#include <Awl/Debug.hpp>
+#include <atomic>
+
+// Checks TaskGroup waits, nested spawns and cancellation: each check
+// prints its check point and the number of failures is returned
+
+int failures = 0;
+std::atomic<int> calls(0);
+
+void check(bool condition, int line)
+{
+	MT_COUT(std::cout << "check point " << line << (condition ? " ok" : " FAILED") << std::endl);
+	
+	if (!condition)
+		failures++;
+}
+
+void count(awl::Task *)
+{
+	calls++;
+}
+
+// Spawns a binary tree of tasks in the same group, counting the leaves
+void tree(awl::Task *, awl::TaskGroup *group, int depth)
+{
+	if (depth == 0)
+	{
+		calls++;
+		return;
+	}
+	
+	group->Spawn(boost::bind(tree, _1, group, depth - 1));
+	group->Spawn(boost::bind(tree, _1, group, depth - 1));
+}
+
+// Nests a group per level, deeper than the number of workers
+void nested(awl::Task *, int depth)
+{
+	calls++;
+	
+	if (depth == 0)
+		return;
+	
+	awl::TaskGroup group;
+	group.Spawn(boost::bind(nested, _1, depth - 1));
+	group.Wait();
+}
+
+void waits(void)
+{
+	calls = 0;
+	
+	{
+		awl::TaskGroup group;
+		
+		for (int i = 0; i < 100;i++)
+			group.Spawn(count);
+		
+		group.Wait();
+		check(calls == 100, __LINE__);
+		
+		// Also waited for by the destructor
+		group.Spawn(count);
+	}
+	
+	check(calls == 101, __LINE__);
+	
+	calls = 0;
+	awl::TaskGroup group;
+	group.Spawn(boost::bind(tree, _1, &group, 10));
+	group.Wait();
+	check(calls == 1024, __LINE__);
+	
+	calls = 0;
+	awl::AsyncCall(boost::bind(nested, _1, 64))->Wait();
+	check(calls == 65, __LINE__);
+}
+
+void cancellation(void)
+{
+	calls = 0;
+	
+	awl::TaskGroup group;
+	group.Cancel();
+	
+	for (int i = 0; i < 10;i++)
+		group.Spawn(count);
+	
+	// The functions of the group are skipped
+	group.Wait();
+	check(group.IsCancelled() && calls == 0, __LINE__);
+}
+
+int main (void)
+{
+	waits();
+	cancellation();
+	
+	awl::ThreadPool::WaitAndDie();
+	return failures;
+}
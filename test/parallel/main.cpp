@@ -0,0 +1,166 @@
+
+/*
+ *  parallel/main.cpp
+ *  Awl - Asynchronous Work Library
+ *
+ *  Copyright (c) 2011 Lucas Soltic
+ *  ceylow@gmail.com
+ *
+ *  This software is provided 'as-is', without any express or implied warranty.
+ *  In no event will the authors be held liable for any damages arising from
+ *  the use of this software.
+ *
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute it freely,
+ *  subject to the following restrictions:
+ *
+ *  1. The origin of this software must not be misrepresented;
+ *     you must not claim that you wrote the original software.
+ *     If you use this software in a product, an acknowledgment
+ *     in the product documentation would be appreciated but is not required.
+ *
+ *  2. Altered source versions must be plainly marked as such,
+ *     and must not be misrepresented as being the original software.
+ *
+ *  3. This notice may not be removed or altered from any source distribution.
+ *
+ */
+#include <Awl/Awl.hpp>
+#include <Awl/Debug.hpp>
+#include <atomic>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// Checks ParallelFor() and ParallelReduce() results, from outside and from
+// within the pool: each check prints its check point and the number of
+// failures is returned
+
+int failures = 0;
+
+void check(bool condition, int line)
+{
+	MT_COUT(std::cout << "check point " << line << (condition ? " ok" : " FAILED") << std::endl);
+	
+	if (!condition)
+		failures++;
+}
+
+const int Size = 100000;
+std::vector<std::atomic<int> > visits(Size);
+
+void visit(const awl::Range<int>& piece)
+{
+	for (int i = piece.begin; i < piece.end;i++)
+		visits[i]++;
+}
+
+void throwAt(const awl::Range<int>& piece)
+{
+	if (piece.begin <= Size / 2 && Size / 2 < piece.end)
+		throw std::runtime_error("failed");
+}
+
+long long sum(const awl::Range<int>& piece, long long value)
+{
+	for (int i = piece.begin; i < piece.end;i++)
+		value += i;
+	
+	return value;
+}
+
+long long add(long long left, long long right)
+{
+	return left + right;
+}
+
+// Not commutative: the digits must be concatenated in order
+std::string digits(const awl::Range<int>& piece, std::string value)
+{
+	for (int i = piece.begin; i < piece.end;i++)
+		value += char('0' + i % 10);
+	
+	return value;
+}
+
+std::string concat(std::string left, std::string right)
+{
+	return left + right;
+}
+
+bool visitedOnce(void)
+{
+	bool once = true;
+	
+	for (int i = 0; i < Size;i++)
+	{
+		once = once && visits[i] == 1;
+		visits[i] = 0;
+	}
+	
+	return once;
+}
+
+void loops(void)
+{
+	awl::ParallelFor(awl::Range<int>(0, Size), visit);
+	check(visitedOnce(), __LINE__);
+	
+	awl::ParallelFor(awl::Range<int>(0, Size, 1000), visit);
+	check(visitedOnce(), __LINE__);
+	
+	long long total = awl::ParallelReduce(awl::Range<int>(0, Size), 0LL, sum, add);
+	check(total == (long long)Size * (Size - 1) / 2, __LINE__);
+	
+	std::string text = awl::ParallelReduce(awl::Range<int>(0, 1000, 7), std::string(), digits, concat);
+	bool ordered = text.size() == 1000;
+	
+	for (size_t i = 0; ordered && i < text.size();i++)
+		ordered = text[i] == char('0' + i % 10);
+	
+	check(ordered, __LINE__);
+}
+
+void errors(void)
+{
+	try
+	{
+		awl::ParallelFor(awl::Range<int>(0, Size), throwAt);
+		check(false, __LINE__);
+	}
+	catch (std::runtime_error&)
+	{
+		check(true, __LINE__);
+	}
+	
+	try
+	{
+		awl::ParallelReduce(awl::Range<int>(0, Size), 0LL,
+							[](const awl::Range<int>& piece, long long value)
+							{
+								throwAt(piece);
+								return sum(piece, value);
+							}, add);
+		check(false, __LINE__);
+	}
+	catch (std::runtime_error&)
+	{
+		check(true, __LINE__);
+	}
+}
+
+int main (void)
+{
+	loops();
+	errors();
+	
+	// Same from a worker, which takes part in the loops
+	awl::AsyncCall([]
+				   {
+					   loops();
+					   errors();
+				   }).Wait();
+	
+	awl::ThreadPool::WaitAndDie();
+	return failures;
+}
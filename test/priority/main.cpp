@@ -0,0 +1,88 @@
+
+/*
+ *  priority/main.cpp
+ *  Awl - Asynchronous Work Library
+ *
+ *  Copyright (c) 2011 Lucas Soltic
+ *  ceylow@gmail.com
+ *
+ *  This software is provided 'as-is', without any express or implied warranty.
+ *  In no event will the authors be held liable for any damages arising from
+ *  the use of this software.
+ *
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute it freely,
+ *  subject to the following restrictions:
+ *
+ *  1. The origin of this software must not be misrepresented;
+ *     you must not claim that you wrote the original software.
+ *     If you use this software in a product, an acknowledgment
+ *     in the product documentation would be appreciated but is not required.
+ *
+ *  2. Altered source versions must be plainly marked as such,
+ *     and must not be misrepresented as being the original software.
+ *
+ *  3. This notice may not be removed or altered from any source distribution.
+ *
+ */
+#include <Awl/Awl.hpp>
+#include <Awl/Debug.hpp>
+#include <Awl/Sleep.hpp>
+#include <atomic>
+#include <string>
+
+// Checks the order in which a single worker starts tasks of different
+// priorities: each check prints its check point and the number of
+// failures is returned
+
+int failures = 0;
+std::atomic<bool> released(false);
+std::string order;
+
+void check(bool condition, int line)
+{
+	MT_COUT(std::cout << "check point " << line << (condition ? " ok" : " FAILED") << std::endl);
+	
+	if (!condition)
+		failures++;
+}
+
+// Keeps the worker busy until the tasks have all been scheduled
+void blocker(awl::Task *)
+{
+	while (!released)
+		awl::Sleep(1);
+}
+
+// Only ever called by the single worker
+void record(awl::Task *, char name)
+{
+	order += name;
+}
+
+int main (void)
+{
+	awl::ThreadPool pool(1);
+	awl::TaskRef blocked = awl::AsyncCall(pool, blocker);
+	
+	awl::TaskRef low = awl::Task::Create(boost::bind(record, _1, 'L'));
+	awl::TaskRef normal = awl::Task::Create(boost::bind(record, _1, 'N'));
+	awl::TaskRef high = awl::Task::Create(boost::bind(record, _1, 'H'));
+	
+	pool.ScheduleTaskForExecution(low, awl::LowPriority);
+	pool.ScheduleTaskForExecution(normal, awl::NormalPriority);
+	pool.ScheduleTaskForExecution(high, awl::HighPriority);
+	
+	check(low->GetPriority() == awl::LowPriority && high->GetPriority() == awl::HighPriority, __LINE__);
+	
+	released = true;
+	low->Wait();
+	normal->Wait();
+	high->Wait();
+	
+	// Started by band, whatever the order of scheduling
+	check(order == "HNL", __LINE__);
+	
+	awl::ThreadPool::WaitAndDie();
+	return failures;
+}
@@ -35,6 +35,20 @@ sf::Texture tex2;
 sf::Texture tex3;
 bool loaded[3] = {false};
 
+#ifdef Awl_Coroutines
+// Loads the texture on a worker thread, then goes back to the main thread
+// to mark it as loaded. No thread is blocked in between
+awl::CoTask<void> LoadTexture(sf::Texture& tex, const char *file, int index)
+{
+	co_await awl::Async();
+	tex.LoadFromFile(file);
+	glFlush(); // Make sure the texture is updated in the main thread's GL context
+	
+	co_await awl::MainThread();
+	loaded[index] = true;
+}
+#endif
+
 int main()
 {
 	sf::RenderWindow win(sf::VideoMode(640, 480), "Image Loader");
@@ -53,6 +67,14 @@ int main()
 	sp2.SetPosition(50, 50);
 	sp3.SetPosition(100, 100);
 	
+#ifdef Awl_Coroutines
+	// With C++20 coroutines, the asynchronous loading reads sequentially
+	awl::CoTask<void> loads[3] = {
+		LoadTexture(tex1, "big_image1.png", 0),
+		LoadTexture(tex2, "big_image2.png", 1),
+		LoadTexture(tex3, "big_image3.png", 2)
+	};
+#else
 	// Execute this block in an asynchronous way
 	AwlAsyncBlock
 	({
@@ -91,6 +113,7 @@ int main()
 			loaded[2] = true;
 		})
 	})
+#endif
 	
 	// Here we run the WorkLoop to process the tasks we wanted to perform
 	// on the main thread
@@ -0,0 +1,102 @@
+
+/*
+ *  timer/main.cpp
+ *  Awl - Asynchronous Work Library
+ *
+ *  Copyright (c) 2011 Lucas Soltic
+ *  ceylow@gmail.com
+ *
+ *  This software is provided 'as-is', without any express or implied warranty.
+ *  In no event will the authors be held liable for any damages arising from
+ *  the use of this software.
+ *
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute it freely,
+ *  subject to the following restrictions:
+ *
+ *  1. The origin of this software must not be misrepresented;
+ *     you must not claim that you wrote the original software.
+ *     If you use this software in a product, an acknowledgment
+ *     in the product documentation would be appreciated but is not required.
+ *
+ *  2. Altered source versions must be plainly marked as such,
+ *     and must not be misrepresented as being the original software.
+ *
+ *  3. This notice may not be removed or altered from any source distribution.
+ *
+ */
+#include <Awl/Awl.hpp>
+#include <Awl/Debug.hpp>
+#include <Awl/Sleep.hpp>
+#include <atomic>
+
+// Checks delayed and periodic tasks, and their cancellation: each check
+// prints its check point and the number of failures is returned
+
+int failures = 0;
+std::atomic<int> calls(0);
+
+void check(bool condition, int line)
+{
+	MT_COUT(std::cout << "check point " << line << (condition ? " ok" : " FAILED") << std::endl);
+	
+	if (!condition)
+		failures++;
+}
+
+void count(awl::Task *)
+{
+	calls++;
+}
+
+void delays(void)
+{
+	calls = 0;
+	
+	awl::Uint64 start = awl::GetMonotonicTime();
+	awl::TaskRef late = awl::AsyncCallAfter(60, count);
+	awl::TaskRef early = awl::AsyncCallAt(start + 20, count);
+	
+	early->Wait();
+	check(awl::GetMonotonicTime() >= start + 20 && !late->IsOver(), __LINE__);
+	
+	late->Wait();
+	check(awl::GetMonotonicTime() >= start + 60 && calls == 2, __LINE__);
+}
+
+void cancellation(void)
+{
+	calls = 0;
+	
+	awl::Uint64 start = awl::GetMonotonicTime();
+	awl::TaskRef timer = awl::AsyncCallAfter(60000, count);
+	timer->Cancel();
+	timer->Wait();
+	
+	// Completed right away, without calling the callback
+	check(awl::GetMonotonicTime() - start < 30000, __LINE__);
+	check(timer->IsCancelled() && !timer->IsOver() && calls == 0, __LINE__);
+	
+	awl::TaskRef periodic = awl::AsyncCallEvery(10, count);
+	
+	while (calls < 3)
+		awl::Sleep(1);
+	
+	periodic->Cancel();
+	periodic->Wait();
+	
+	// A call that was already running may still end
+	awl::Sleep(20);
+	int callCount = calls;
+	awl::Sleep(50);
+	check(calls == callCount, __LINE__);
+}
+
+int main (void)
+{
+	delays();
+	cancellation();
+	
+	awl::ThreadPool::WaitAndDie();
+	return failures;
+}
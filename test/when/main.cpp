@@ -0,0 +1,128 @@
+
+/*
+ *  when/main.cpp
+ *  Awl - Asynchronous Work Library
+ *
+ *  Copyright (c) 2011 Lucas Soltic
+ *  ceylow@gmail.com
+ *
+ *  This software is provided 'as-is', without any express or implied warranty.
+ *  In no event will the authors be held liable for any damages arising from
+ *  the use of this software.
+ *
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute it freely,
+ *  subject to the following restrictions:
+ *
+ *  1. The origin of this software must not be misrepresented;
+ *     you must not claim that you wrote the original software.
+ *     If you use this software in a product, an acknowledgment
+ *     in the product documentation would be appreciated but is not required.
+ *
+ *  2. Altered source versions must be plainly marked as such,
+ *     and must not be misrepresented as being the original software.
+ *
+ *  3. This notice may not be removed or altered from any source distribution.
+ *
+ */
+#include <Awl/Awl.hpp>
+#include <Awl/Debug.hpp>
+#include <Awl/Sleep.hpp>
+#include <atomic>
+
+// Checks WhenAll(), WhenAny() and their blocking counterparts: each check
+// prints its check point and the number of failures is returned
+
+int failures = 0;
+std::atomic<int> calls(0);
+
+void check(bool condition, int line)
+{
+	MT_COUT(std::cout << "check point " << line << (condition ? " ok" : " FAILED") << std::endl);
+	
+	if (!condition)
+		failures++;
+}
+
+void count(awl::Task *)
+{
+	calls++;
+}
+
+void slowCount(awl::Task *)
+{
+	awl::Sleep(50);
+	calls++;
+}
+
+void whenAll(void)
+{
+	calls = 0;
+	
+	std::vector<awl::TaskRef> tasks;
+	for (int i = 0; i < 8;i++)
+		tasks.push_back(awl::AsyncCall(count));
+	
+	awl::WhenAll(tasks).Get();
+	check(calls == 8, __LINE__);
+	
+	tasks.push_back(awl::AsyncCall(count));
+	awl::WaitForAll(tasks);
+	check(calls == 9, __LINE__);
+}
+
+void whenAny(void)
+{
+	calls = 0;
+	
+	std::vector<awl::TaskRef> tasks;
+	tasks.push_back(awl::AsyncCall(slowCount));
+	tasks.push_back(awl::AsyncCall(count));
+	
+	size_t winner = awl::WhenAny(tasks).Get();
+	check(winner < tasks.size() && tasks[winner]->IsOver(), __LINE__);
+	
+	winner = awl::WaitForAny(tasks);
+	check(winner < tasks.size() && tasks[winner]->IsOver(), __LINE__);
+	
+	awl::WaitForAll(tasks);
+	check(calls == 2, __LINE__);
+}
+
+void emptySets(void)
+{
+	awl::Future<size_t> any = awl::WhenAny(std::vector<awl::TaskRef>());
+	
+	check(any.Get() == 0, __LINE__);
+	check(awl::WaitForAny(std::vector<awl::TaskRef>()) == 0, __LINE__);
+	
+	awl::WhenAll(std::vector<awl::TaskRef>()).Get();
+	awl::WaitForAll(std::vector<awl::TaskRef>());
+	check(true, __LINE__);
+}
+
+void discardedTask(void)
+{
+	// A Task that is destroyed without running must not keep the
+	// joins waiting
+	std::vector<awl::TaskRef> tasks;
+	tasks.push_back(awl::Task::Create(count));
+	
+	awl::Future<void> all = awl::WhenAll(tasks);
+	awl::Future<size_t> any = awl::WhenAny(tasks);
+	tasks.clear();
+	
+	all.Get();
+	check(any.Get() == 0, __LINE__);
+}
+
+int main (void)
+{
+	whenAll();
+	whenAny();
+	emptySets();
+	discardedTask();
+	
+	awl::ThreadPool::WaitAndDie();
+	return failures;
+}